@@ -1,4 +1,5 @@
 from . import _C
+from . import forward_ad
 
 import torch.nn as nn
 import torch
@@ -6,14 +7,40 @@ import torch
 def test_floatgrad():
     return _C.test_floatgrad()
 
-# def matmul_cuda(a, b):
-#     return _C.matmul_cuda(a, b)
-# 
-# def matmul_cuda_jvp(a, b):
-#     return _C.matmul_cuda_jvp(a, b)
-# 
-# def float2_dot(a, b):
-#     return _C.float2_dot_cuda(a, b)
-# 
-# def float2_dot_jvp(a, b):
-#     return _C.float2_dot_cuda_jvp(a, b)
+# Whether the extension was built with its CUDA kernels. Without them the
+# functions below accept CPU tensors only, and the *_cuda ones are missing.
+with_cuda = _C.with_cuda
+
+def matmul_cuda(a, b):
+    return _C.matmul_cuda(a, b)
+
+# a and b are [M, K] and [K, N] matrices, optionally with a last dimension
+# of size 1 + K holding the primal and K tangents, so that one call gives K
+# directional derivatives. Inputs without tangents or with all-zero
+# tangents take a primal-only path; with need_tangent=False the result then
+# has no tangent dimension.
+def matmul_cuda_jvp(a, b, need_tangent=True, check_zero_tangents=True):
+    return _C.matmul_cuda_jvp(a, b, need_tangent, check_zero_tangents)
+
+# CPU or CUDA tensors, running on the device of a
+def matmul(a, b):
+    return _C.matmul(a, b)
+
+# CPU or CUDA tensors, same layout and options as matmul_cuda_jvp
+def matmul_jvp(a, b, need_tangent=True, check_zero_tangents=True):
+    return _C.matmul_jvp(a, b, need_tangent, check_zero_tangents)
+
+# CPU batches of small matrices, [batch, M, K] and [batch, K, N] with an
+# optional (primal, tangent) dimension of size 2 and the same options;
+# fastest for sizes up to 4
+def bmm_jvp(a, b, need_tangent=True, check_zero_tangents=True):
+    return _C.bmm_jvp(a, b, need_tangent, check_zero_tangents)
+
+# Row-wise dot products of [..., 2] tensors of the same shape, giving [...]
+def float2_dot(a, b):
+    return _C.float2_dot(a, b)
+
+# Same on [..., 2, 1 + K] tensors, whose last dimension is the primal and K
+# tangents, giving [..., 1 + K]; options are those of matmul_cuda_jvp
+def float2_dot_jvp(a, b, need_tangent=True, check_zero_tangents=True):
+    return _C.float2_dot_jvp(a, b, need_tangent, check_zero_tangents)
@@ -0,0 +1,36 @@
+# torch.autograd.forward_ad support for the FloatGrad kernels. Inside
+# fwAD.dual_level(), dual inputs give a dual result whose primal and
+# tangent come from one fused kernel, reading the primals and tangents
+# where forward-mode AD keeps them, with no [..., 2] packing:
+#
+#     with fwAD.dual_level():
+#         c = forward_ad.matmul(fwAD.make_dual(a, da), b)
+#         dc = fwAD.unpack_dual(c).tangent    # da @ b
+#
+# Inputs without a tangent run the plain kernels. Reverse-mode autograd
+# does not flow through these functions.
+
+import torch.autograd.forward_ad as fwAD
+
+from . import _C
+
+
+# a @ b for [M, K] and [K, N] float32 matrices on CPU or CUDA
+def matmul(a, b):
+    a, a_t = fwAD.unpack_dual(a)
+    b, b_t = fwAD.unpack_dual(b)
+    if a_t is None and b_t is None:
+        return _C.matmul(a, b)
+    # The fused kernel writes the primal into c and returns the tangent
+    c = a.new_empty((a.shape[0], b.shape[1]))
+    return fwAD.make_dual(c, _C.matmul_jvp_planar(c, a, a_t, b, b_t))
+
+
+# Row-wise dot products of [..., 2] float32 tensors of the same shape
+def float2_dot(a, b):
+    a, a_t = fwAD.unpack_dual(a)
+    b, b_t = fwAD.unpack_dual(b)
+    if a_t is None and b_t is None:
+        return _C.float2_dot(a, b)
+    c = a.new_empty(a.shape[:-1])
+    return fwAD.make_dual(c, _C.float2_dot_jvp_planar(c, a, a_t, b, b_t))
@@ -0,0 +1,78 @@
+// Dual dot-product accumulation: plain floats vs FloatGrad operator+= vs
+// fma_assign, into a value and through a FloatGradRef
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "float_grad.h"
+#include "bench_utils.h"
+
+constexpr int kLength = 1 << 22;
+
+__noinline__
+float dot_plain(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum = fmaf(a[i], b[i], sum);
+    }
+    return sum;
+}
+
+__noinline__
+FloatGrad<float> dot_compound(FloatGradArray<const float> a, FloatGradArray<const float> b, int n) {
+    FloatGrad<float> sum(0.0f, 0.0f);
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__noinline__
+FloatGrad<float> dot_fma(FloatGradArray<const float> a, FloatGradArray<const float> b, int n) {
+    FloatGrad<float> sum(0.0f, 0.0f);
+    for (int i = 0; i < n; ++i) {
+        fma_assign(sum, a[i], b[i]);
+    }
+    return sum;
+}
+
+// Accumulating through a reference, as a kernel writing into its output
+__noinline__
+void dot_fma_ref(FloatGradArray<const float> a, FloatGradArray<const float> b,
+                 FloatGradRef<float> out, int n) {
+    for (int i = 0; i < n; ++i) {
+        fma_assign(out, a[i], b[i]);
+    }
+}
+
+int main() {
+    std::vector<float> a(kLength), da(kLength), b(kLength), db(kLength);
+    for (int i = 0; i < kLength; ++i) {
+        a[i] = std::sin(0.001f * i);
+        da[i] = std::cos(0.003f * i);
+        b[i] = std::cos(0.002f * i);
+        db[i] = std::sin(0.004f * i);
+    }
+    FloatGradArray<const float> ag(a.data(), da.data());
+    FloatGradArray<const float> bg(b.data(), db.data());
+
+    float plain = 0.0f;
+    FloatGrad<float> compound, fused;
+    float ref_data = 0.0f, ref_grad = 0.0f;
+
+    std::printf("dual dot product, %d elements\n", kLength);
+    report("plain float fmaf", time_ms([&] { plain = dot_plain(a.data(), b.data(), kLength); }), kLength);
+    report("FloatGrad +=", time_ms([&] { compound = dot_compound(ag, bg, kLength); }), kLength);
+    report("fma_assign", time_ms([&] { fused = dot_fma(ag, bg, kLength); }), kLength);
+    report("fma_assign via FloatGradRef", time_ms([&] {
+        ref_data = ref_grad = 0.0f;
+        dot_fma_ref(ag, bg, FloatGradRef<float>(&ref_data, &ref_grad), kLength);
+    }), kLength);
+
+    const double err = std::fmax(std::fabs(fused.data() - plain),
+                                 std::fmax(std::fabs(fused.grad() - compound.grad()),
+                                           std::fabs(ref_grad - fused.grad())));
+    std::printf("max |difference| = %g\n", err);
+    return err < 1e-2 * std::fabs(fused.grad()) + 1e-2 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// Batch elementwise kernels over FloatGradArray against the per-element
+// FloatGrad operators and against memcpy of the same output bytes, in cache
+// and streaming from memory. Planes are cache-line aligned.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "float_grad.h"
+#include "float_grad_batch.h"
+#include "bench_utils.h"
+
+__noinline__
+void mul_scalar(FloatGradArray<float> out, FloatGradArray<const float> a,
+                FloatGradArray<const float> b, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+__noinline__
+void exp_scalar(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = expf(a[i]);
+    }
+}
+
+__noinline__
+void tanh_scalar(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = tanhf(a[i]);
+    }
+}
+
+__noinline__
+void sin_scalar(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = sinf(a[i]);
+    }
+}
+
+__noinline__
+void mul_batch(FloatGradArray<float> out, FloatGradArray<const float> a,
+               FloatGradArray<const float> b, int n) {
+    batch_mul(out, a, b, n);
+}
+
+__noinline__
+void exp_batch(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    batch_exp(out, a, n);
+}
+
+__noinline__
+void tanh_batch(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    batch_tanh(out, a, n);
+}
+
+__noinline__
+void sin_batch(FloatGradArray<float> out, FloatGradArray<const float> a, int n) {
+    batch_sin(out, a, n);
+}
+
+void run(int n, int reps) {
+    AlignedFloats a(n), da(n), b(n), db(n), c(n), dc(n);
+    for (int i = 0; i < n; ++i) {
+        a[i] = std::sin(0.001f * i);
+        da[i] = std::cos(0.003f * i);
+        b[i] = std::cos(0.002f * i);
+        db[i] = std::sin(0.004f * i);
+    }
+    FloatGradArray<const float> ag(a.data(), da.data());
+    FloatGradArray<const float> bg(b.data(), db.data());
+    FloatGradArray<float> cg(c.data(), dc.data());
+    const double items = double(n) * reps;
+
+    std::printf("%d duals x %d reps\n", n, reps);
+    report("memcpy data + grad", time_ms([&] {
+        for (int r = 0; r < reps; ++r) {
+            std::memcpy(c.data(), a.data(), n * sizeof(float));
+            std::memcpy(dc.data(), da.data(), n * sizeof(float));
+        }
+    }), items);
+    report("mul, FloatGrad operators", time_ms([&] {
+        for (int r = 0; r < reps; ++r) mul_scalar(cg, ag, bg, n);
+    }), items);
+    report("mul, batch_mul", time_ms([&] {
+        for (int r = 0; r < reps; ++r) mul_batch(cg, ag, bg, n);
+    }), items);
+    report("exp, FloatGrad expf", time_ms([&] {
+        for (int r = 0; r < reps; ++r) exp_scalar(cg, ag, n);
+    }), items);
+    report("exp, batch_exp", time_ms([&] {
+        for (int r = 0; r < reps; ++r) exp_batch(cg, ag, n);
+    }), items);
+    report("tanh, FloatGrad tanhf", time_ms([&] {
+        for (int r = 0; r < reps; ++r) tanh_scalar(cg, ag, n);
+    }), items);
+    report("tanh, batch_tanh", time_ms([&] {
+        for (int r = 0; r < reps; ++r) tanh_batch(cg, ag, n);
+    }), items);
+    report("sin, FloatGrad sinf", time_ms([&] {
+        for (int r = 0; r < reps; ++r) sin_scalar(cg, ag, n);
+    }), items);
+    report("sin, batch_sin", time_ms([&] {
+        for (int r = 0; r < reps; ++r) sin_batch(cg, ag, n);
+    }), items);
+}
+
+int main() {
+    // 6 planes of 16 KiB stay in L1/L2; 6 planes of 16 MiB stream from DRAM
+    run(1 << 12, 1024);
+    run(1 << 22, 1);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Batched products of small dual matrices: bmm_jvp with the batch across
+// SIMD lanes, in the plain [M, K, batch] and the blocked layout, against a
+// per-matrix FloatGrad loop over the usual batch-major storage, as in
+// transformPoint4x4 of tests/ctests. Times are per matrix product, for a
+// batch in L1 and one of 1M products in memory.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+#include "float_grad.h"
+#include "float_grad_bmm.h"
+#include "bench_utils.h"
+
+// Batch-major [batch, M, K] planes, each matrix product unrolled at compile
+// time
+template <int M, int K, int N>
+__noinline__
+void bmm_per_matrix(FloatGradArray<float> c, FloatGradArray<const float> a,
+                    FloatGradArray<const float> b, int64_t batch) {
+    for (int64_t l = 0; l < batch; ++l) {
+        const FloatGradArray<const float> al = a + l * M * K;
+        const FloatGradArray<const float> bl = b + l * K * N;
+        FloatGradArray<float> cl = c + l * M * N;
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                FloatGrad<float> sum = al[i * K] * bl[j];
+                for (int k = 1; k < K; ++k) {
+                    fma_assign(sum, al[i * K + k], bl[k * N + j]);
+                }
+                cl[i * N + j] = sum;
+            }
+        }
+    }
+}
+
+template <int M, int K, int N, int Rank>
+__noinline__
+void bmm_lanes(FloatGradTensor<float, Rank> C, FloatGradTensor<const float, Rank> A,
+               FloatGradTensor<const float, Rank> B) {
+    bmm_jvp<M, K, N>(C, A, B);
+}
+
+template <int M, int K, int N>
+void run(const char* name, int64_t batch) {
+    AlignedFloats a(M * K * batch), da(M * K * batch), b(K * N * batch), db(K * N * batch);
+    AlignedFloats c(M * N * batch), dc(M * N * batch);
+    for (int64_t i = 0; i < M * K * batch; ++i) {
+        a[i] = std::sin(0.001f * (i % 4096));
+        da[i] = std::cos(0.003f * (i % 4096));
+    }
+    for (int64_t i = 0; i < K * N * batch; ++i) {
+        b[i] = std::sin(0.002f * (i % 4096));
+        db[i] = std::cos(0.004f * (i % 4096));
+    }
+
+    // The same buffers serve all layouts; only the timings are compared
+    FloatGradTensor<const float, 3> A(a.data(), da.data(), {M, K, batch});
+    FloatGradTensor<const float, 3> B(b.data(), db.data(), {K, N, batch});
+    FloatGradTensor<float, 3> C(c.data(), dc.data(), {M, N, batch});
+    const int64_t blocks = batch / bmm_block_lanes;
+    FloatGradTensor<const float, 4> Ab(a.data(), da.data(), {blocks, M, K, bmm_block_lanes});
+    FloatGradTensor<const float, 4> Bb(b.data(), db.data(), {blocks, K, N, bmm_block_lanes});
+    FloatGradTensor<float, 4> Cb(c.data(), dc.data(), {blocks, M, N, bmm_block_lanes});
+
+    // Repeats small batches to time about 1M products
+    const int repeat = (1 << 20) / batch;
+    auto row = [&](const char* layout, auto&& f) {
+        report(layout, time_ms([&] {
+            for (int r = 0; r < repeat; ++r) {
+                f();
+            }
+        }), double(batch) * repeat);
+    };
+
+    std::printf("%s, batch %lld\n", name, (long long)batch);
+    row("  per matrix, batch-major", [&] {
+        bmm_per_matrix<M, K, N>(FloatGradArray<float>(c.data(), dc.data()),
+                                FloatGradArray<const float>(a.data(), da.data()),
+                                FloatGradArray<const float>(b.data(), db.data()), batch);
+    });
+    row("  bmm_jvp, [M, K, batch]", [&] { bmm_lanes<M, K, N, 3>(C, A, B); });
+    row("  bmm_jvp, blocked", [&] { bmm_lanes<M, K, N, 4>(Cb, Ab, Bb); });
+}
+
+int main() {
+    for (int64_t batch : {int64_t(64), int64_t(1) << 20}) {
+        run<4, 4, 1>("4x4 by 4x1, point transforms", batch);
+        run<3, 3, 3>("3x3 by 3x3", batch);
+        run<4, 4, 4>("4x4 by 4x4", batch);
+        run<2, 2, 2>("2x2 by 2x2", batch);
+    }
+    return 0;
+}
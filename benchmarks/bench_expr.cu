@@ -0,0 +1,143 @@
+// Eager FloatGrad operators vs a hand-written JVP for the 4x4 point transform
+// of tests/ctests/advanced_tests.cu and an elementwise a * x + b * y + c. The
+// transform runs once streaming from memory and once on a cache-resident
+// block of points. bench_matrix.cu runs it as a FloatGrad<float4x4>.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "bench_utils.h"
+
+constexpr int kPoints = 1 << 20;
+// Cache-resident transform: kCachedPoints points, kCachedReps times
+constexpr int kCachedPoints = 1 << 11;
+constexpr int kCachedReps = 512;
+
+__noinline__
+void transform_eager(const FloatGradArray<const float> m, const FloatGradArray<const float> p,
+                     FloatGradArray<float> out, int n) {
+    for (int i = 0; i < n; ++i) {
+        for (int row = 0; row < 4; ++row) {
+            out[4 * i + row] = m[row] * p[3 * i] + m[row + 4] * p[3 * i + 1]
+                               + m[row + 8] * p[3 * i + 2] + m[row + 12];
+        }
+    }
+}
+
+__noinline__
+void transform_manual(const float* m, const float* dm, const float* p, const float* dp,
+                      float* out, float* dout, int n) {
+    for (int i = 0; i < n; ++i) {
+        const float* pi = p + 3 * i;
+        const float* dpi = dp + 3 * i;
+        for (int row = 0; row < 4; ++row) {
+            float v = fmaf(m[row], pi[0], m[row + 12]);
+            v = fmaf(m[row + 4], pi[1], v);
+            v = fmaf(m[row + 8], pi[2], v);
+            float dv = dm[row + 12];
+            dv = fmaf(dm[row], pi[0], fmaf(m[row], dpi[0], dv));
+            dv = fmaf(dm[row + 4], pi[1], fmaf(m[row + 4], dpi[1], dv));
+            dv = fmaf(dm[row + 8], pi[2], fmaf(m[row + 8], dpi[2], dv));
+            out[4 * i + row] = v;
+            dout[4 * i + row] = dv;
+        }
+    }
+}
+
+__noinline__
+void axpby_eager(FloatGradArray<const float> a, FloatGradArray<const float> x,
+                 FloatGradArray<const float> b, FloatGradArray<const float> y,
+                 FloatGradArray<const float> c, FloatGradArray<float> out, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a[i] * x[i] + b[i] * y[i] + c[i];
+    }
+}
+
+__noinline__
+void axpby_manual(const float* a, const float* da, const float* x, const float* dx,
+                  const float* b, const float* db, const float* y, const float* dy,
+                  const float* c, const float* dc, float* out, float* dout, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = fmaf(b[i], y[i], fmaf(a[i], x[i], c[i]));
+        dout[i] = fmaf(db[i], y[i], fmaf(b[i], dy[i], fmaf(da[i], x[i], fmaf(a[i], dx[i], dc[i]))));
+    }
+}
+
+double max_abs_diff(const std::vector<float>& u, const std::vector<float>& v) {
+    double err = 0.0;
+    for (size_t i = 0; i < u.size(); ++i) {
+        err = std::fmax(err, std::fabs(u[i] - v[i]));
+    }
+    return err;
+}
+
+int main() {
+    std::vector<float> m(16), dm(16);
+    for (int i = 0; i < 16; ++i) {
+        m[i] = 0.1f * (i + 1);
+        dm[i] = 0.01f * (16 - i);
+    }
+    std::vector<float> p(3 * kPoints), dp(3 * kPoints);
+    for (int i = 0; i < 3 * kPoints; ++i) {
+        p[i] = std::sin(0.001f * i);
+        dp[i] = std::cos(0.002f * i);
+    }
+    std::vector<float> out(4 * kPoints), dout(4 * kPoints);
+    std::vector<float> ref(4 * kPoints), dref(4 * kPoints);
+
+    FloatGradArray<const float> mg(m.data(), dm.data());
+    FloatGradArray<const float> pg(p.data(), dp.data());
+    FloatGradArray<float> og(out.data(), dout.data());
+
+    std::printf("transformPoint4x4 JVP, %d points\n", kPoints);
+    report("hand-written fmaf", time_ms([&] {
+        transform_manual(m.data(), dm.data(), p.data(), dp.data(), ref.data(), dref.data(), kPoints);
+    }), kPoints);
+    report("eager FloatGrad", time_ms([&] { transform_eager(mg, pg, og, kPoints); }), kPoints);
+    const double max_err = std::fmax(max_abs_diff(out, ref), max_abs_diff(dout, dref));
+    std::printf("max |FloatGrad - hand-written| = %g\n\n", max_err);
+
+    std::printf("transformPoint4x4 JVP, %d points x %d\n", kCachedPoints, kCachedReps);
+    report("hand-written fmaf", time_ms([&] {
+        for (int r = 0; r < kCachedReps; ++r) {
+            transform_manual(m.data(), dm.data(), p.data(), dp.data(), ref.data(), dref.data(),
+                             kCachedPoints);
+        }
+    }), double(kCachedPoints) * kCachedReps);
+    report("eager FloatGrad", time_ms([&] {
+        for (int r = 0; r < kCachedReps; ++r) {
+            transform_eager(mg, pg, og, kCachedPoints);
+        }
+    }), double(kCachedPoints) * kCachedReps);
+    std::printf("\n");
+
+    std::vector<float> v[10];
+    for (int k = 0; k < 10; ++k) {
+        v[k].resize(kPoints);
+        for (int i = 0; i < kPoints; ++i) {
+            v[k][i] = std::sin(0.001f * i + k);
+        }
+    }
+    auto arg = [&](int k) { return FloatGradArray<const float>(v[2 * k].data(), v[2 * k + 1].data()); };
+    out.resize(kPoints);
+    dout.resize(kPoints);
+    ref.resize(kPoints);
+    dref.resize(kPoints);
+    og = FloatGradArray<float>(out.data(), dout.data());
+
+    std::printf("a * x + b * y + c JVP, %d elements\n", kPoints);
+    report("hand-written fmaf", time_ms([&] {
+        axpby_manual(v[0].data(), v[1].data(), v[2].data(), v[3].data(), v[4].data(), v[5].data(),
+                     v[6].data(), v[7].data(), v[8].data(), v[9].data(), ref.data(), dref.data(), kPoints);
+    }), kPoints);
+    report("eager FloatGrad", time_ms([&] {
+        axpby_eager(arg(0), arg(1), arg(2), arg(3), arg(4), og, kPoints);
+    }), kPoints);
+
+    const double axpby_err = std::fmax(max_abs_diff(out, ref), max_abs_diff(dout, dref));
+    std::printf("max |FloatGrad - hand-written| = %g\n", axpby_err);
+    return max_err < 1e-4 && axpby_err < 1e-4 ? 0 : 1;
+}
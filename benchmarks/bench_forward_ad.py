@@ -0,0 +1,56 @@
+# Forward-mode AD on CPU: torch.autograd.forward_ad running native ops,
+# which compute the primal and each product-rule term with separate
+# kernels, against auto_jvp_example.forward_ad, where a dual input
+# triggers one fused FloatGrad kernel. Times are per call.
+#
+#     python benchmarks/bench_forward_ad.py [threads]
+
+import sys
+import time
+
+import torch
+import torch.autograd.forward_ad as fwAD
+
+from auto_jvp_example import forward_ad
+
+
+def time_ms(f, reps=20):
+    f()
+    start = time.perf_counter()
+    for _ in range(reps):
+        f()
+    return (time.perf_counter() - start) * 1e3 / reps
+
+
+def compare(name, native, fused, *shapes):
+    primals = [torch.randn(s) for s in shapes]
+    tangents = [torch.randn(s) for s in shapes]
+
+    def run(f):
+        with fwAD.dual_level():
+            duals = [fwAD.make_dual(p, t) for p, t in zip(primals, tangents)]
+            return fwAD.unpack_dual(f(*duals)).tangent
+
+    error = (run(native) - run(fused)).abs().max().item()
+    native_ms = time_ms(lambda: run(native))
+    fused_ms = time_ms(lambda: run(fused))
+    print(f"  {name:<24} native {native_ms:9.3f} ms  fused {fused_ms:9.3f} ms"
+          f"  speedup {native_ms / fused_ms:5.2f}  max error {error:.2e}")
+
+
+def main():
+    if len(sys.argv) > 1:
+        torch.set_num_threads(int(sys.argv[1]))
+    print(f"{torch.get_num_threads()} threads")
+
+    print("matmul")
+    for n in (64, 256, 1024):
+        compare(f"{n} x {n}", torch.matmul, forward_ad.matmul, (n, n), (n, n))
+
+    print("float2_dot")
+    for n in (1 << 10, 1 << 16, 1 << 22):
+        compare(f"{n} rows", lambda a, b: (a * b).sum(-1), forward_ad.float2_dot, (n, 2), (n, 2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+// Blocked dual GEMM against the same engine run as two plain sgemm calls,
+// C = A B and dC = [dA A] [B; dB], and against a FloatGrad triple loop.
+// GFLOP/s count the three products of the JVP, 6 M N K flops, for every row.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+#include "float_grad.h"
+#include "float_grad_gemm.h"
+#include "bench_utils.h"
+
+__noinline__
+void gemm_naive(FloatGradTensor<float, 2> C, FloatGradTensor<const float, 2> A,
+                FloatGradTensor<const float, 2> B) {
+    for (int64_t i = 0; i < C.size(0); ++i) {
+        for (int64_t j = 0; j < C.size(1); ++j) {
+            FloatGrad<float> sum(0.0f, 0.0f);
+            for (int64_t k = 0; k < A.size(1); ++k) {
+                fma_assign(sum, A(i, k), B(k, j));
+            }
+            C(i, j) = sum;
+        }
+    }
+}
+
+void fill(AlignedFloats& x, size_t n, float scale) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = std::sin(scale * i);
+    }
+}
+
+void run(int64_t n, int reps) {
+    const size_t nn = n * n;
+    AlignedFloats a(nn), da(nn), b(nn), db(nn), c(nn), dc(nn);
+    fill(a, nn, 0.001f);
+    fill(da, nn, 0.003f);
+    fill(b, nn, 0.002f);
+    fill(db, nn, 0.004f);
+
+    FloatGradTensor<const float, 2> A(a.data(), da.data(), {n, n});
+    FloatGradTensor<const float, 2> B(b.data(), db.data(), {n, n});
+    FloatGradTensor<float, 2> C(c.data(), dc.data(), {n, n});
+
+    // [dA A] is n x 2n and [B; dB] is 2n x n
+    AlignedFloats a_cat(2 * nn), b_cat(2 * nn);
+    for (int64_t i = 0; i < n; ++i) {
+        for (int64_t k = 0; k < n; ++k) {
+            a_cat[i * 2 * n + k] = da[i * n + k];
+            a_cat[i * 2 * n + n + k] = a[i * n + k];
+        }
+    }
+    for (size_t i = 0; i < nn; ++i) {
+        b_cat[i] = b[i];
+        b_cat[nn + i] = db[i];
+    }
+    FloatGradTensor<const float, 2> A_cat(a_cat.data(), nullptr, {n, 2 * n});
+    FloatGradTensor<const float, 2> B_cat(b_cat.data(), nullptr, {2 * n, n});
+
+    const double gflop = 6.0 * n * n * n * 1e-9;
+    auto row = [&](const char* name, double ms) {
+        std::printf("%-32s %9.3f ms  %7.1f GFLOP/s\n", name, ms, gflop / (ms * 1e-3));
+    };
+
+    std::printf("%lld x %lld\n", (long long)n, (long long)n);
+    row("gemm_jvp, one sweep", time_ms([&] { gemm_jvp(C, A, B); }, reps));
+    row("2 x sgemm, AB and [dA A][B; dB]", time_ms([&] {
+        gemm_jvp(C.primals(), A.primals(), B.primals());
+        gemm_jvp(FloatGradTensor<float, 2>(dc.data(), nullptr, {n, n}), A_cat, B_cat);
+    }, reps));
+    if (n <= 512) {
+        row("FloatGrad triple loop", time_ms([&] { gemm_naive(C, A, B); }, 1));
+    }
+}
+
+int main() {
+    run(256, 20);
+    run(512, 10);
+    run(1024, 5);
+    run(2048, 2);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// __global__ kernels run through the host grid emulator of host_launch.h
+// against the same kernel body written as a plain loop, for an elementwise
+// dual a * x + y and for the matmul launchers' kernel. Arguments:
+// [threads], default all hardware threads.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "float_grad.h"
+#include "host_launch.h"
+#include "matmul_kernel.h"
+#include "bench_utils.h"
+
+__global__ void axpy_kernel(int n, FloatGrad<float> a, FloatGradArray<const float> x,
+                            FloatGradArray<const float> y, FloatGradArray<float> out) {
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= n) return;
+    out[i] = a * x[i] + y[i];
+}
+
+__noinline__
+void axpy_loop(int n, FloatGrad<float> a, FloatGradArray<const float> x,
+               FloatGradArray<const float> y, FloatGradArray<float> out) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a * x[i] + y[i];
+    }
+}
+
+__noinline__
+void matmul_loop(FloatGradTensor<const float, 2> A, FloatGradTensor<const float, 2> B,
+                 FloatGradTensor<float, 2> C) {
+    for (int64_t i = 0; i < C.size(0); ++i) {
+        for (int64_t j = 0; j < C.size(1); ++j) {
+            FloatGrad<float> sum(0.0f);
+            for (int64_t k = 0; k < A.size(1); ++k) {
+                fma_assign(sum, A(i, k), B(k, j));
+            }
+            C(i, j) = sum;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const int threads = argc > 1 ? std::atoi(argv[1]) : ThreadPool::hardware_threads();
+    ThreadPool pool(threads);
+    ThreadPool serial(1);
+    std::printf("%d threads\n\n", pool.size());
+
+    const int n = 1 << 24;
+    AlignedFloats x(n), dx(n), y(n), dy(n), out(n), dout(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = 0.001f * (i % 1000);
+        dx[i] = 1.0f;
+        y[i] = -0.002f * (i % 500);
+        dy[i] = 0.5f;
+    }
+    const FloatGrad<float> a(2.0f, 0.5f);
+    FloatGradArray<const float> xv(x.data(), dx.data()), yv(y.data(), dy.data());
+    FloatGradArray<float> ov(out.data(), dout.data());
+
+    std::printf("a * x + y JVP, %d elements\n", n);
+    report("plain loop", time_ms([&] { axpy_loop(n, a, xv, yv, ov); }), n);
+    report("host_launch, 1 thread", time_ms([&] {
+        host_launch<axpy_kernel>(serial, dim3((n + 255) / 256), dim3(256), n, a, xv, yv, ov);
+    }), n);
+    report("host_launch, pool", time_ms([&] {
+        host_launch<axpy_kernel>(pool, dim3((n + 255) / 256), dim3(256), n, a, xv, yv, ov);
+    }), n);
+
+    const int64_t m = 512;
+    AlignedFloats ma(m * m), mda(m * m), mb(m * m), mdb(m * m), mc(m * m), mdc(m * m);
+    for (int64_t i = 0; i < m * m; ++i) {
+        ma[i] = 0.001f * (i % 997);
+        mda[i] = 0.002f * (i % 991);
+        mb[i] = 0.003f * (i % 983);
+        mdb[i] = 0.004f * (i % 977);
+    }
+    FloatGradTensor<const float, 2> A(ma.data(), mda.data(), {m, m});
+    FloatGradTensor<const float, 2> B(mb.data(), mdb.data(), {m, m});
+    FloatGradTensor<float, 2> C(mc.data(), mdc.data(), {m, m});
+    using Dual = FloatGrad<float>;
+    const dim3 block(16, 16);
+    const dim3 grid((m + 15) / 16, (m + 15) / 16);
+
+    std::printf("\nmatmul_kernel JVP, %lld x %lld\n", (long long)m, (long long)m);
+    report("plain loop", time_ms([&] { matmul_loop(A, B, C); }, 2), m * m);
+    report("host_launch, 1 thread", time_ms([&] {
+        host_launch<matmul_kernel<Dual, Dual, Dual>>(serial, grid, block, A, B, C);
+    }, 2), m * m);
+    report("host_launch, pool", time_ms([&] {
+        host_launch<matmul_kernel<Dual, Dual, Dual>>(pool, grid, block, A, B, C);
+    }, 2), m * m);
+    return 0;
+}
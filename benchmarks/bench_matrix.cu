@@ -0,0 +1,101 @@
+// FloatGrad<float4x4> transform_point vs a hand-written JVP of the 4x4 point
+// transform of tests/ctests/advanced_tests.cu, streaming from memory and on a
+// cache-resident block of points
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "float_grad_matrix.h"
+#include "bench_utils.h"
+
+constexpr int kPoints = 1 << 20;
+// Cache-resident transform: kCachedPoints points, kCachedReps times
+constexpr int kCachedPoints = 1 << 11;
+constexpr int kCachedReps = 512;
+
+__noinline__
+void transform_matrix(const FloatGrad<float4x4> m, const FloatGradArray<const float3> p,
+                      FloatGradArray<float4> out, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = transform_point(m, p[i]);
+    }
+}
+
+// m is column-major, out[i] = m (p[i], 1)
+__noinline__
+void transform_manual(const float* m, const float* dm, const float* p, const float* dp,
+                      float* out, float* dout, int n) {
+    for (int i = 0; i < n; ++i) {
+        const float* pi = p + 3 * i;
+        const float* dpi = dp + 3 * i;
+        for (int row = 0; row < 4; ++row) {
+            float v = fmaf(m[row], pi[0], m[row + 12]);
+            v = fmaf(m[row + 4], pi[1], v);
+            v = fmaf(m[row + 8], pi[2], v);
+            float dv = dm[row + 12];
+            dv = fmaf(dm[row], pi[0], fmaf(m[row], dpi[0], dv));
+            dv = fmaf(dm[row + 4], pi[1], fmaf(m[row + 4], dpi[1], dv));
+            dv = fmaf(dm[row + 8], pi[2], fmaf(m[row + 8], dpi[2], dv));
+            out[4 * i + row] = v;
+            dout[4 * i + row] = dv;
+        }
+    }
+}
+
+double max_abs_diff(const std::vector<float>& u, const std::vector<float>& v) {
+    double err = 0.0;
+    for (size_t i = 0; i < u.size(); ++i) {
+        err = std::fmax(err, std::fabs(u[i] - v[i]));
+    }
+    return err;
+}
+
+int main() {
+    std::vector<float> m(16), dm(16);
+    for (int i = 0; i < 16; ++i) {
+        m[i] = 0.1f * (i + 1);
+        dm[i] = 0.01f * (16 - i);
+    }
+    std::vector<float> p(3 * kPoints), dp(3 * kPoints);
+    for (int i = 0; i < 3 * kPoints; ++i) {
+        p[i] = std::sin(0.001f * i);
+        dp[i] = std::cos(0.002f * i);
+    }
+    std::vector<float> out(4 * kPoints), dout(4 * kPoints);
+    std::vector<float> ref(4 * kPoints), dref(4 * kPoints);
+
+    float4x4 mm, dmm;
+    std::memcpy(&mm, m.data(), sizeof(mm));
+    std::memcpy(&dmm, dm.data(), sizeof(dmm));
+    FloatGradArray<const float3> pv(reinterpret_cast<const float3*>(p.data()),
+                                    reinterpret_cast<const float3*>(dp.data()));
+    FloatGradArray<float4> ov(reinterpret_cast<float4*>(out.data()), reinterpret_cast<float4*>(dout.data()));
+
+    std::printf("transformPoint4x4 JVP, %d points\n", kPoints);
+    report("hand-written fmaf", time_ms([&] {
+        transform_manual(m.data(), dm.data(), p.data(), dp.data(), ref.data(), dref.data(), kPoints);
+    }), kPoints);
+    report("FloatGrad<float4x4>", time_ms([&] {
+        transform_matrix(FloatGrad<float4x4>(mm, dmm), pv, ov, kPoints);
+    }), kPoints);
+    const double max_err = std::fmax(max_abs_diff(out, ref), max_abs_diff(dout, dref));
+    std::printf("max |FloatGrad - hand-written| = %g\n\n", max_err);
+
+    std::printf("transformPoint4x4 JVP, %d points x %d\n", kCachedPoints, kCachedReps);
+    report("hand-written fmaf", time_ms([&] {
+        for (int r = 0; r < kCachedReps; ++r) {
+            transform_manual(m.data(), dm.data(), p.data(), dp.data(), ref.data(), dref.data(),
+                             kCachedPoints);
+        }
+    }), double(kCachedPoints) * kCachedReps);
+    report("FloatGrad<float4x4>", time_ms([&] {
+        for (int r = 0; r < kCachedReps; ++r) {
+            transform_matrix(FloatGrad<float4x4>(mm, dmm), pv, ov, kCachedPoints);
+        }
+    }), double(kCachedPoints) * kCachedReps);
+    return max_err < 1e-4 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// Thread scaling of the host dual kernels on ThreadPool: gemm_jvp on square
+// matrices, split into blocks of C, the memory-bound batch_mul and
+// batch_dot over leaves of large arrays, and a triangular workload whose
+// row costs grow linearly, with work stealing and with one static chunk per
+// thread. Speedup and efficiency are against one thread of the same kernel.
+//
+//     bench_parallel [max_threads] [max_n] [pin]
+//
+// max_threads defaults to the hardware threads and max_n to 8192; pin = 1
+// pins the workers to one CPU each.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "float_grad.h"
+#include "float_grad_batch.h"
+#include "float_grad_gemm.h"
+#include "float_grad_parallel.h"
+#include "bench_utils.h"
+
+void fill(AlignedFloats& x, size_t n, float scale) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = std::sin(scale * (i % 4096));
+    }
+}
+
+// 1, 2, 4, ... up to max_threads, and max_threads itself
+std::vector<int> thread_counts(int max_threads) {
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// One row per thread count of a kernel doing `work` units of `unit`
+template <typename Function>
+void scale(const char* name, const std::vector<int>& counts, bool pin, int reps,
+           double work, const char* unit, Function&& f) {
+    std::printf("%s\n", name);
+    double base = 0.0;
+    for (int threads : counts) {
+        ThreadPool pool(threads, pin);
+        f(pool);
+        const double ms = time_ms([&] { f(pool); }, reps);
+        base = threads == 1 ? ms : base;
+        std::printf("  %3d threads %10.3f ms %9.1f %s  speedup %6.2f  efficiency %5.1f%%\n",
+                    threads, ms, work / (ms * 1e-3), unit, base / ms, 100.0 * base / ms / threads);
+    }
+}
+
+void bench_gemm(int64_t n, const std::vector<int>& counts, bool pin) {
+    const size_t nn = n * n;
+    AlignedFloats a(nn), da(nn), b(nn), db(nn), c(nn), dc(nn);
+    fill(a, nn, 0.001f);
+    fill(da, nn, 0.003f);
+    fill(b, nn, 0.002f);
+    fill(db, nn, 0.004f);
+    FloatGradTensor<const float, 2> A(a.data(), da.data(), {n, n});
+    FloatGradTensor<const float, 2> B(b.data(), db.data(), {n, n});
+    FloatGradTensor<float, 2> C(c.data(), dc.data(), {n, n});
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "gemm_jvp %lld x %lld", (long long)n, (long long)n);
+    scale(name, counts, pin, n <= 2048 ? 3 : 1, 6.0 * n * n * n * 1e-9, "GFLOP/s",
+          [&](ThreadPool& pool) { gemm_jvp(C, A, B, pool); });
+}
+
+void bench_batch(int64_t n, const std::vector<int>& counts, bool pin) {
+    AlignedFloats ad(n), ag(n), bd(n), bg(n), od(n), og(n);
+    fill(ad, n, 0.001f);
+    fill(ag, n, 0.003f);
+    fill(bd, n, 0.002f);
+    fill(bg, n, 0.004f);
+    FloatGradArray<float> a(ad.data(), ag.data()), b(bd.data(), bg.data()), out(od.data(), og.data());
+    const int64_t grain = 16384;
+
+    // Bytes moved: four input planes, and two output planes for batch_mul
+    scale("batch_mul, 64M duals", counts, pin, 5, 24.0 * n * 1e-9, "GB/s", [&](ThreadPool& pool) {
+        parallel_for(pool, n, grain, [&](int64_t begin, int64_t end) {
+            batch_mul(out + begin, a + begin, b + begin, end - begin);
+        });
+    });
+    volatile float sink;
+    scale("batch_dot, 64M duals", counts, pin, 5, 16.0 * n * 1e-9, "GB/s", [&](ThreadPool& pool) {
+        sink = parallel_reduce(
+            pool, n, grain, FloatGrad<float>(0.0f, 0.0f),
+            [&](int64_t begin, int64_t end) { return batch_dot(a + begin, b + begin, end - begin); },
+            [](const FloatGrad<float>& x, const FloatGrad<float>& y) { return x + y; }).data();
+    });
+    (void)sink;
+}
+
+// out[i] = dot(a[0, i), b[0, i)): the last rows cost the most, so equal
+// chunks of rows are far from equal work
+void bench_skewed(int64_t n, const std::vector<int>& counts, bool pin) {
+    AlignedFloats ad(n), ag(n), bd(n), bg(n), od(n), og(n);
+    fill(ad, n, 0.001f);
+    fill(ag, n, 0.003f);
+    fill(bd, n, 0.002f);
+    fill(bg, n, 0.004f);
+    FloatGradArray<float> a(ad.data(), ag.data()), b(bd.data(), bg.data()), out(od.data(), og.data());
+    auto rows = [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            out[i] = batch_dot(a, b, i);
+        }
+    };
+    const double work = 4.0 * n * n * 1e-9;
+
+    scale("triangular batch_dot rows, work stealing", counts, pin, 3, work, "GFLOP/s",
+          [&](ThreadPool& pool) { parallel_for(pool, n, 16, rows); });
+    scale("triangular batch_dot rows, static chunks", counts, pin, 3, work, "GFLOP/s",
+          [&](ThreadPool& pool) {
+              pool.run([&](int tid) {
+                  rows(n * tid / pool.size(), n * (tid + 1) / pool.size());
+              });
+          });
+}
+
+int main(int argc, char** argv) {
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : ThreadPool::hardware_threads();
+    const int64_t max_n = argc > 2 ? std::atoll(argv[2]) : 8192;
+    const bool pin = argc > 3 && std::atoi(argv[3]) == 1;
+    const std::vector<int> counts = thread_counts(max_threads);
+
+    std::printf("%d hardware threads%s\n", ThreadPool::hardware_threads(), pin ? ", pinned" : "");
+    for (int64_t n = 1024; n <= max_n; n *= 2) {
+        bench_gemm(n, counts, pin);
+    }
+    bench_batch(int64_t(1) << 26, counts, pin);
+    bench_skewed(int64_t(1) << 15, counts, pin);
+    return 0;
+}
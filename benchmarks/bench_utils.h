@@ -0,0 +1,40 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Best-of-`reps` wall time of `f()` in milliseconds
+template <typename Function>
+double time_ms(Function&& f, int reps = 10) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+inline void report(const char* name, double ms, double items) {
+    std::printf("%-28s %9.3f ms  %8.3f ns/item\n", name, ms, ms * 1e6 / items);
+}
+
+// Float buffer aligned to a cache line, so that SIMD loads never split lines
+struct AlignedFloats {
+    float* ptr;
+
+    explicit AlignedFloats(size_t n)
+        : ptr(static_cast<float*>(std::aligned_alloc(64, (n * sizeof(float) + 63) / 64 * 64))) {}
+    AlignedFloats(const AlignedFloats&) = delete;
+    AlignedFloats& operator=(const AlignedFloats&) = delete;
+    ~AlignedFloats() { std::free(ptr); }
+
+    float* data() const { return ptr; }
+    float& operator[](size_t i) const { return ptr[i]; }
+};
+
+#endif // BENCH_UTILS_H
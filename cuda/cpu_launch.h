@@ -0,0 +1,23 @@
+#ifndef CPU_LAUNCH_H
+#define CPU_LAUNCH_H
+
+#include <torch/extension.h>
+
+#include "host_launch.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// launch_kernel for the CPU launchers of the torch extension. Kernels run
+/// on the emulated grid of host_launch.h with the blocks split over torch's
+/// intra-op threads instead of a ThreadPool, so they follow
+/// torch.set_num_threads and do not oversubscribe torch's own work.
+//////////////////////////////////////////////////////////////////////////////
+
+template <auto Kernel, typename... Args>
+void launch_kernel_cpu(dim3 grid, dim3 block, Args... args) {
+    const int64_t blocks = int64_t(grid.x) * grid.y * grid.z;
+    at::parallel_for(0, blocks, host_launch_grain(block), [&](int64_t begin, int64_t end) {
+        host_launch_blocks<Kernel>(grid, block, begin, end, args...);
+    });
+}
+
+#endif // CPU_LAUNCH_H
@@ -0,0 +1,146 @@
+#ifndef CUDA_COMPAT_H
+#define CUDA_COMPAT_H
+
+//////////////////////////////////////////////////////////////////////////////
+/// Host-only build support.
+/// Under nvcc (or whenever the CUDA toolkit headers are available) this just
+/// pulls in cuda_runtime.h. Define FLOAT_GRAD_HOST_ONLY, or build without the
+/// toolkit, to get portable vector types and execution space qualifier shims
+/// so that the FloatGrad headers compile with a plain host C++ compiler.
+/// Host sources linked with nvcc-compiled ones must not define it, so that
+/// both sides see the same vector types.
+//////////////////////////////////////////////////////////////////////////////
+
+#if !defined(FLOAT_GRAD_HOST_ONLY) && !defined(__CUDACC__) \
+    && !(defined(__has_include) && __has_include(<cuda_runtime.h>))
+#define FLOAT_GRAD_HOST_ONLY
+#endif
+
+#if defined(FLOAT_GRAD_HOST_ONLY) && defined(__CUDACC__)
+#error "FLOAT_GRAD_HOST_ONLY cannot be used when compiling with nvcc"
+#endif
+
+#ifndef FLOAT_GRAD_HOST_ONLY
+
+#include <cuda_runtime.h>
+
+#else // FLOAT_GRAD_HOST_ONLY
+
+#include <cmath>
+
+/////////////////////////////////////////////////////////////////////////////
+/// Execution space qualifiers
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __host__
+#define __host__
+#endif
+
+#ifndef __device__
+#define __device__
+#endif
+
+#ifndef __global__
+#define __global__
+#endif
+
+#ifndef __forceinline__
+#if defined(__GNUC__) || defined(__clang__)
+#define __forceinline__ inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define __forceinline__ __forceinline
+#else
+#define __forceinline__ inline
+#endif
+#endif
+
+#ifndef __noinline__
+#if defined(__GNUC__) || defined(__clang__)
+#define __noinline__ __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define __noinline__ __declspec(noinline)
+#else
+#define __noinline__
+#endif
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+/// Vector types. Layout and alignment match vector_types.h so that buffers
+/// can be shared with device code.
+/////////////////////////////////////////////////////////////////////////////
+
+struct alignas(8) float2 { float x, y; };
+struct float3 { float x, y, z; };
+struct alignas(16) float4 { float x, y, z, w; };
+
+struct alignas(8) int2 { int x, y; };
+struct int3 { int x, y, z; };
+struct alignas(16) int4 { int x, y, z, w; };
+
+struct alignas(8) uint2 { unsigned int x, y; };
+struct uint3 { unsigned int x, y, z; };
+struct alignas(16) uint4 { unsigned int x, y, z, w; };
+
+struct dim3 {
+    unsigned int x, y, z;
+
+    constexpr dim3(unsigned int vx = 1, unsigned int vy = 1, unsigned int vz = 1)
+        : x(vx), y(vy), z(vz) {}
+    constexpr dim3(uint3 v) : x(v.x), y(v.y), z(v.z) {}
+    constexpr operator uint3() const { return uint3{x, y, z}; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/// Vector constructors (vector_functions.h)
+/////////////////////////////////////////////////////////////////////////////
+
+inline float2 make_float2(float x, float y) { return float2{x, y}; }
+inline float3 make_float3(float x, float y, float z) { return float3{x, y, z}; }
+inline float4 make_float4(float x, float y, float z, float w) { return float4{x, y, z, w}; }
+
+inline int2 make_int2(int x, int y) { return int2{x, y}; }
+inline int3 make_int3(int x, int y, int z) { return int3{x, y, z}; }
+inline int4 make_int4(int x, int y, int z, int w) { return int4{x, y, z, w}; }
+
+inline uint2 make_uint2(unsigned int x, unsigned int y) { return uint2{x, y}; }
+inline uint3 make_uint3(unsigned int x, unsigned int y, unsigned int z) {
+    return uint3{x, y, z};
+}
+inline uint4 make_uint4(unsigned int x, unsigned int y, unsigned int z, unsigned int w) {
+    return uint4{x, y, z, w};
+}
+
+#endif // FLOAT_GRAD_HOST_ONLY
+
+/////////////////////////////////////////////////////////////////////////////
+/// Built-in index variables for host compilers, with either set of vector
+/// types. host_launch in host_launch.h sets them for every emulated thread,
+/// so __global__ kernels compile and run unchanged. They are thread-local:
+/// each worker runs its own blocks. FLOAT_GRAD_HOST_LAUNCH marks the
+/// translation units that have them.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __CUDACC__
+
+#define FLOAT_GRAD_HOST_LAUNCH
+
+inline thread_local uint3 threadIdx = {0, 0, 0};
+inline thread_local uint3 blockIdx = {0, 0, 0};
+inline thread_local dim3 blockDim;
+inline thread_local dim3 gridDim;
+
+#endif // __CUDACC__
+
+// Wrap __global__ templates in these. nvcc emits a host launch stub under
+// the name of every kernel it instantiates, and a host compiler emits the
+// kernel body itself, so host instantiations go to an inline namespace: an
+// extension linking both gets two symbols instead of an ODR violation.
+#ifdef FLOAT_GRAD_HOST_LAUNCH
+#define FLOAT_GRAD_KERNELS_BEGIN inline namespace host_kernels {
+#define FLOAT_GRAD_KERNELS_END }
+#else
+#define FLOAT_GRAD_KERNELS_BEGIN
+#define FLOAT_GRAD_KERNELS_END
+#endif
+
+#endif // CUDA_COMPAT_H
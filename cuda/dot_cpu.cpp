@@ -0,0 +1,106 @@
+#include <torch/extension.h>
+#include <float_grad.h>
+
+#include "cpu_launch.h"
+#include "dot_kernel.h"
+#include "jvp_dispatch.h"
+
+// CPU counterpart of float2_dot_cuda, running the same kernel
+torch::Tensor float2_dot_cpu(torch::Tensor A, torch::Tensor B) {
+    TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
+    TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+    TORCH_CHECK(A.sizes() == B.sizes(), "A and B must have the same shape");
+    TORCH_CHECK(A.dim() >= 1 && A.size(-1) == 2, "A and B must have a last dimension of size 2");
+
+    const int64_t n = A.numel() / 2;
+    const torch::Tensor a = A.reshape({n, 2});
+    const torch::Tensor b = B.reshape({n, 2});
+    auto C = torch::empty({n}, A.options());
+
+    launch_kernel_cpu<float2_dot_kernel<float, float, float>>(
+        dim3((n + 255) / 256), dim3(256),
+        jvp_tensor<const float, 2>(a),
+        jvp_tensor<const float, 2>(b),
+        jvp_tensor<float, 1>(C)
+    );
+
+    return C.view(std::vector<int64_t>(A.sizes().begin(), A.sizes().end() - 1));
+}
+
+// C = rows of A dot rows of B with the kernel operand types of the active
+// inputs, for N tangent lanes
+template <int N>
+static void float2_dot_cpu_launch(const JvpInput<2, N>& a, const JvpInput<2, N>& b,
+                                  const FloatGradTensor<float, 1, N>& c) {
+    const int64_t n = c.size(0);
+    dispatch_jvp([&](auto a_tag, auto b_tag) {
+        using TA = typename decltype(a_tag)::type;
+        using TB = typename decltype(b_tag)::type;
+        using TC = std::conditional_t<is_float_grad<TA>::value || is_float_grad<TB>::value,
+                                      FloatGrad<float, N>, float>;
+        launch_kernel_cpu<float2_dot_kernel<TA, TB, TC, N>>(dim3((n + 255) / 256), dim3(256),
+                                                            a.view, b.view, c);
+    }, a, b);
+}
+
+// CPU counterpart of float2_dot_cuda_jvp, same layout and options
+torch::Tensor float2_dot_cpu_jvp(torch::Tensor A, torch::Tensor B,
+                                 bool need_tangent, bool check_zero_tangents) {
+    TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
+    TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+    TORCH_CHECK(A.sizes() == B.sizes(), "A and B must have the same shape");
+    TORCH_CHECK(A.dim() >= 2 && A.size(-2) == 2 && A.size(-1) >= 2,
+                "A and B must end in a row dimension of size 2 and a dimension of size 1 + K, "
+                "the primal and K tangents");
+
+    const int64_t tangents = A.size(-1) - 1;
+    const int64_t n = A.numel() / (2 * (1 + tangents));
+    const torch::Tensor a_rows = jvp_unit_lanes<2>(A.reshape({n, 2, 1 + tangents}));
+    const torch::Tensor b_rows = jvp_unit_lanes<2>(B.reshape({n, 2, 1 + tangents}));
+    const JvpInput<2> a = jvp_input<2>(a_rows, check_zero_tangents);
+    const JvpInput<2> b = jvp_input<2>(b_rows, check_zero_tangents);
+
+    const bool active = a.active || b.active;
+    JvpOutput<1> c = jvp_output<1>({n}, A.options(), active, need_tangent, tangents);
+
+    dispatch_tangents(active ? tangents : 0, [&](auto lanes, int64_t first) {
+        constexpr int L = decltype(lanes)::value;
+        float2_dot_cpu_launch(jvp_lanes<L>(a_rows, a, first), jvp_lanes<L>(b_rows, b, first),
+                              jvp_tensor<float, 1, L>(c.tensor, first));
+    });
+
+    std::vector<int64_t> sizes(A.sizes().begin(), A.sizes().end() - 2);
+    if (c.tensor.dim() == 2) {
+        sizes.push_back(c.tensor.size(1));
+    }
+    return c.tensor.view(sizes);
+}
+
+// CPU counterpart of float2_dot_cuda_jvp_planar
+torch::Tensor float2_dot_cpu_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                        torch::Tensor B, c10::optional<torch::Tensor> dB) {
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+    TORCH_CHECK(C.device().is_cpu(), "C must be a CPU tensor");
+    TORCH_CHECK(A.sizes() == B.sizes(), "A and B must have the same shape");
+    TORCH_CHECK(A.dim() >= 1 && A.size(-1) == 2, "A and B must have a last dimension of size 2");
+    TORCH_CHECK(C.sizes() == A.sizes().slice(0, A.dim() - 1), "C must have the shape of A without its last dimension");
+    TORCH_CHECK(!dA.has_value() || dA->sizes() == A.sizes(), "dA must have the shape of A");
+    TORCH_CHECK(!dB.has_value() || dB->sizes() == B.sizes(), "dB must have the shape of B");
+
+    const int64_t n = A.numel() / 2;
+    const torch::Tensor a_rows = A.reshape({n, 2});
+    const torch::Tensor b_rows = B.reshape({n, 2});
+    const JvpInput<2> a = jvp_input<2>(a_rows, jvp_reshape(dA, {n, 2}));
+    const JvpInput<2> b = jvp_input<2>(b_rows, jvp_reshape(dB, {n, 2}));
+
+    JvpPlanes<1> c = jvp_planes<1>(C.view({n}), a.active || b.active);
+
+    float2_dot_cpu_launch(a, b, c.view);
+
+    return c.tangent.defined() ? c.tangent.view(C.sizes()) : c.tangent;
+}
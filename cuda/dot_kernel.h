@@ -0,0 +1,44 @@
+#ifndef DOT_KERNEL_H
+#define DOT_KERNEL_H
+
+#include <cstdint>
+
+#include "float_grad.h"
+#include "matmul_kernel.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Kernels of the float2_dot launchers, without torch so that tests and
+/// host builds can run them through launch_kernel (host_launch.h).
+//////////////////////////////////////////////////////////////////////////////
+
+FLOAT_GRAD_KERNELS_BEGIN
+
+// C[i] = A[i, 0] B[i, 0] + A[i, 1] B[i, 1], one thread per row. TA, TB and
+// TC are float or FloatGrad<float, Tangents> as for matmul_kernel, and the
+// views may have any strides.
+template <typename TA, typename TB, typename TC, int Tangents = 1>
+__global__ void float2_dot_kernel(
+        FloatGradTensor<const float, 2, Tangents> A,
+        FloatGradTensor<const float, 2, Tangents> B,
+        FloatGradTensor<float, 1, Tangents> C) {
+
+    const int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i >= C.size(0)) return;
+
+    const TA a0 = jvp_operand<TA>(A, i, 0);
+    const TA a1 = jvp_operand<TA>(A, i, 1);
+    const TB b0 = jvp_operand<TB>(B, i, 0);
+    const TB b1 = jvp_operand<TB>(B, i, 1);
+    if constexpr (is_float_grad<TC>::value) {
+        TC sum(0.0f);
+        fma_assign(sum, a0, b0);
+        fma_assign(sum, a1, b1);
+        C(i) = sum;
+    } else {
+        C.data(i) = fmaf(a1, b1, a0 * b0);
+    }
+}
+
+FLOAT_GRAD_KERNELS_END
+
+#endif // DOT_KERNEL_H
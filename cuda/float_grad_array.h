@@ -1,8 +1,16 @@
 #ifndef FLOAT_GRAD_ARRAY_H
 #define FLOAT_GRAD_ARRAY_H
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
 #include "float_grad_base.h"
 
+#if !defined(__CUDA_ARCH__) && defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 // std::false_type is_float_grad_array_impl(const void*);
 // template <typename T>
 // std::true_type is_float_grad_array_impl(const FloatGradArray<T>*);
@@ -12,13 +20,78 @@
 template <typename T>
 inline __host__ __device__
 decltype(auto) get_data_ptr(const T& t) {
-    if constexpr (is_float_grad_array<T>::value) {
+    if constexpr (is_float_grad_array<T>::value || is_float_grad_interleaved_array<T>::value) {
         return t.data_ptr();
     } else {
         return t;
     }
 }
 
+namespace float_grad_detail {
+
+// Vector of Width floats moved by one load<Width> of a plane
+template <int Width>
+struct float_vec;
+
+template <>
+struct float_vec<1> {
+    using type = float;
+};
+
+template <>
+struct float_vec<2> {
+    using type = float2;
+};
+
+template <>
+struct float_vec<4> {
+    using type = float4;
+};
+
+template <int Width>
+using float_vec_t = typename float_vec<Width>::type;
+
+// Checked in debug builds, assumed by the compiler in release builds
+template <std::size_t Alignment, typename T>
+inline __host__ __device__
+T* assume_aligned(T* p) {
+    assert(reinterpret_cast<std::uintptr_t>(p) % Alignment == 0 && "misaligned dual vector access");
+#if defined(__GNUC__) || defined(__clang__) || defined(__CUDACC__)
+    return static_cast<T*>(__builtin_assume_aligned(p, Alignment));
+#else
+    return p;
+#endif
+}
+
+// Store that bypasses the caches where the target has one
+template <typename Vec>
+inline __host__ __device__
+void store_stream(Vec* p, const Vec& v) {
+#if defined(__CUDA_ARCH__)
+    __stcs(p, v);
+#elif defined(__SSE2__)
+    if constexpr (std::is_same_v<Vec, float4>) {
+        _mm_stream_ps(reinterpret_cast<float*>(p), _mm_load_ps(&v.x));
+#if defined(__x86_64__)
+    } else if constexpr (std::is_same_v<Vec, float2>) {
+        long long bits;
+        __builtin_memcpy(&bits, &v, sizeof(bits));
+        _mm_stream_si64(reinterpret_cast<long long*>(p), bits);
+#endif
+    } else if constexpr (std::is_same_v<Vec, float>) {
+        int bits;
+        __builtin_memcpy(&bits, &v, sizeof(bits));
+        _mm_stream_si32(reinterpret_cast<int*>(p), bits);
+    } else {
+        *p = v;
+    }
+#else
+    *p = v;
+#endif
+}
+
+} // namespace float_grad_detail
+
 template <typename FloatType>
 struct FloatGradArray {
     FloatType* data_arr_;
@@ -94,6 +167,52 @@ struct FloatGradArray {
         return FloatGradArray(data_arr_ + offset, grad_arr_ + offset);
     }
 
+    // Duals [index, index + Width) as one FloatGrad<float, float2 or float4>,
+    // with a single vector access per plane. Both planes must be aligned to
+    // the vector size at index, which is checked in debug builds and
+    // assumed otherwise.
+    template <int Width>
+    __host__ __device__
+    FloatGrad<float_grad_detail::float_vec_t<Width>> load(int index) const {
+        static_assert(std::is_same_v<std::remove_const_t<FloatType>, float>,
+                      "Vector loads operate on FloatGradArray<float>");
+        using Vec = float_grad_detail::float_vec_t<Width>;
+        const Vec* data = float_grad_detail::assume_aligned<sizeof(Vec)>(
+            reinterpret_cast<const Vec*>(data_arr_ + index));
+        const Vec* grad = float_grad_detail::assume_aligned<sizeof(Vec)>(
+            reinterpret_cast<const Vec*>(grad_arr_ + index));
+        return FloatGrad<Vec>(*data, *grad);
+    }
+
+    template <int Width>
+    __host__ __device__
+    void store(int index, const FloatGrad<float_grad_detail::float_vec_t<Width>>& value) {
+        static_assert(std::is_same_v<FloatType, float>,
+                      "Vector stores operate on FloatGradArray<float>");
+        using Vec = float_grad_detail::float_vec_t<Width>;
+        *float_grad_detail::assume_aligned<sizeof(Vec)>(reinterpret_cast<Vec*>(data_arr_ + index)) =
+            value.data();
+        *float_grad_detail::assume_aligned<sizeof(Vec)>(reinterpret_cast<Vec*>(grad_arr_ + index)) =
+            value.grad();
+    }
+
+    // Non-temporal variant of store for outputs that are not read back
+    // soon. On x86 hosts the stores are weakly ordered, so issue an
+    // _mm_sfence before other threads read them.
+    template <int Width>
+    __host__ __device__
+    void store_stream(int index, const FloatGrad<float_grad_detail::float_vec_t<Width>>& value) {
+        static_assert(std::is_same_v<FloatType, float>,
+                      "Vector stores operate on FloatGradArray<float>");
+        using Vec = float_grad_detail::float_vec_t<Width>;
+        float_grad_detail::store_stream(
+            float_grad_detail::assume_aligned<sizeof(Vec)>(reinterpret_cast<Vec*>(data_arr_ + index)),
+            value.data());
+        float_grad_detail::store_stream(
+            float_grad_detail::assume_aligned<sizeof(Vec)>(reinterpret_cast<Vec*>(grad_arr_ + index)),
+            value.grad());
+    }
+
 
     __host__ __device__
     FloatType* data_ptr() {
@@ -113,6 +232,115 @@ struct FloatGradArray {
     }
 };
 
+// Array of duals stored as interleaved (primal, tangent) pairs in a single
+// buffer, the layout of FloatGrad<FloatType>[] and of torch JVP tensors with
+// a trailing dimension of size 2. Element i has its primal at pairs[2 i] and
+// its tangent at pairs[2 i + 1], so data_ptr() and grad_ptr() are strided
+// views with a stride of 2. cast<float2>() reads pairs of float2, i.e. the
+// FloatGrad<float2> layout (x_p, y_p, x_t, y_t). That is not the layout of
+// torch [..., 2, 2] JVP tensors of float2 values, (x_p, x_t, y_p, y_t), so
+// the extension views those through strided FloatGradTensors instead.
+template <typename FloatType>
+struct FloatGradInterleavedArray {
+    static constexpr int stride = 2;
+
+    FloatType* pairs_;
+
+    __host__ __device__
+    FloatGradInterleavedArray() : pairs_(nullptr) {}
+
+    __host__ __device__
+    explicit FloatGradInterleavedArray(FloatType* pairs) : pairs_(pairs) {}
+
+    // View of FloatGrad values, which have the same layout
+    template <typename OtherType,
+              typename = std::enable_if_t<std::is_same_v<std::remove_const_t<OtherType>,
+                                                         FloatGrad<std::remove_const_t<FloatType>>>
+                                          && (std::is_const_v<FloatType> || !std::is_const_v<OtherType>)>>
+    __host__ __device__
+    explicit FloatGradInterleavedArray(OtherType* duals)
+        : pairs_(reinterpret_cast<FloatType*>(duals)) {}
+
+    __host__ __device__
+    bool operator==(const FloatGradInterleavedArray& other) const {
+        return pairs_ == other.pairs_;
+    }
+
+    __host__ __device__
+    bool operator!=(const FloatGradInterleavedArray& other) const {
+        return pairs_ != other.pairs_;
+    }
+
+    __host__ __device__
+    FloatGradRef<FloatType> operator*() {
+        return FloatGradRef<FloatType>(pairs_, pairs_ + 1);
+    }
+
+    __host__ __device__
+    FloatGradRef<const FloatType> operator*() const {
+        return FloatGradRef<const FloatType>(pairs_, pairs_ + 1);
+    }
+
+    __host__ __device__
+    FloatGradRef<FloatType> operator[](int index) {
+        FloatType* pair = pairs_ + stride * static_cast<std::ptrdiff_t>(index);
+        return FloatGradRef<FloatType>(pair, pair + 1);
+    }
+
+    __host__ __device__
+    FloatGradRef<const FloatType> operator[](int index) const {
+        const FloatType* pair = pairs_ + stride * static_cast<std::ptrdiff_t>(index);
+        return FloatGradRef<const FloatType>(pair, pair + 1);
+    }
+
+    template <typename CastType>
+    __host__ __device__
+    FloatGradInterleavedArray<CastType> cast() const {
+        return FloatGradInterleavedArray<CastType>(reinterpret_cast<CastType*>(pairs_));
+    }
+
+    template <typename OffsetType>
+    __host__ __device__
+    FloatGradInterleavedArray operator+(OffsetType offset) const {
+        return FloatGradInterleavedArray(pairs_ + stride * static_cast<std::ptrdiff_t>(offset));
+    }
+
+    // Primal of element 0, with consecutive primals stride elements apart
+    __host__ __device__
+    FloatType* data_ptr() {
+        return pairs_;
+    }
+    __host__ __device__
+    const FloatType* data_ptr() const {
+        return pairs_;
+    }
+    // Tangent of element 0, with consecutive tangents stride elements apart
+    __host__ __device__
+    FloatType* grad_ptr() {
+        return pairs_ + 1;
+    }
+    __host__ __device__
+    const FloatType* grad_ptr() const {
+        return pairs_ + 1;
+    }
+};
+
+// offset + array, as for pointers; array + offset is the member operator+
+template <typename OffsetType, typename FloatType,
+          typename = std::enable_if_t<std::is_integral_v<OffsetType>>>
+__host__ __device__
+FloatGradArray<FloatType> operator+(OffsetType offset, const FloatGradArray<FloatType>& array) {
+    return array + offset;
+}
+
+template <typename OffsetType, typename FloatType,
+          typename = std::enable_if_t<std::is_integral_v<OffsetType>>>
+__host__ __device__
+FloatGradInterleavedArray<FloatType> operator+(OffsetType offset,
+                                               const FloatGradInterleavedArray<FloatType>& array) {
+    return array + offset;
+}
+
 template <typename T1, typename T2>
 __host__ __device__
 std::enable_if_t<is_float_grad_array<T1>::value 
@@ -134,7 +362,7 @@ operator!=(const T1& a, const T2& b) {
 template <typename CastType, typename T>
 __host__ __device__
 auto cast(T a) {
-    if constexpr (is_float_grad_array<T>::value) {
+    if constexpr (is_float_grad_array<T>::value || is_float_grad_interleaved_array<T>::value) {
         return a.template cast<CastType>();
     } else {
         return reinterpret_cast<CastType*>(a);
@@ -2,17 +2,24 @@
 #define FLOAT_GRAD_BASE_H
 
 #include <type_traits>
+#include <initializer_list>
 #include <iostream>
 
-template <typename FloatType>
+#include "cuda/cuda_compat.h"
+
+// N is the number of tangent lanes carried alongside the primal
+template <typename FloatType, int N = 1>
 struct FloatGradBase;
 
-template <typename FloatType>
+template <typename FloatType, int N = 1>
 struct FloatGradRefBase;
 
 template <typename FloatType>
 struct FloatGradArray;
 
+template <typename FloatType>
+struct FloatGradInterleavedArray;
+
 /////////////////////////////////////////////////////////////////////////////
 /// SFINAE utility
 /////////////////////////////////////////////////////////////////////////////
@@ -21,24 +28,24 @@ template <typename T>
 struct always_false : std::false_type {};
 
 std::false_type is_float_grad_impl(const void*);
-template <typename T>
-std::true_type is_float_grad_impl(const FloatGradBase<T>*);
-template <typename T>
-std::true_type is_float_grad_impl(const FloatGradRefBase<T>*);
+template <typename T, int N>
+std::true_type is_float_grad_impl(const FloatGradBase<T, N>*);
+template <typename T, int N>
+std::true_type is_float_grad_impl(const FloatGradRefBase<T, N>*);
 template <typename T>
 std::true_type is_float_grad_impl(const FloatGradArray<T>*);
 template <typename T>
 using is_float_grad = decltype(is_float_grad_impl(std::declval<T*>()));
 
 std::false_type is_float_grad_val_impl(const void*);
-template <typename T>
-std::true_type is_float_grad_val_impl(const FloatGradBase<T>*);
+template <typename T, int N>
+std::true_type is_float_grad_val_impl(const FloatGradBase<T, N>*);
 template <typename T>
 using is_float_grad_val = decltype(is_float_grad_val_impl(std::declval<T*>()));
 
 std::false_type is_float_grad_ref_impl(const void*);
-template <typename T>
-std::true_type is_float_grad_ref_impl(const FloatGradRefBase<T>*);
+template <typename T, int N>
+std::true_type is_float_grad_ref_impl(const FloatGradRefBase<T, N>*);
 template <typename T>
 using is_float_grad_ref = decltype(is_float_grad_ref_impl(std::declval<T*>()));
 
@@ -48,49 +55,187 @@ std::true_type is_float_grad_array_impl(const FloatGradArray<T>*);
 template <typename T>
 using is_float_grad_array = decltype(is_float_grad_array_impl(std::declval<T*>()));
 
+// (primal, tangent) pairs in one buffer, see float_grad_array.h
+std::false_type is_float_grad_interleaved_array_impl(const void*);
+template <typename T>
+std::true_type is_float_grad_interleaved_array_impl(const FloatGradInterleavedArray<T>*);
+template <typename T>
+using is_float_grad_interleaved_array =
+    decltype(is_float_grad_interleaved_array_impl(std::declval<T*>()));
+
+// Number of tangent lanes of a type, 0 for non-FloatGrad types and for passive
+// FloatGrad<T, 0>
+std::integral_constant<int, 0> num_tangents_impl(const void*);
+template <typename T, int N>
+std::integral_constant<int, N> num_tangents_impl(const FloatGradBase<T, N>*);
+template <typename T, int N>
+std::integral_constant<int, N> num_tangents_impl(const FloatGradRefBase<T, N>*);
+template <typename T>
+std::integral_constant<int, 1> num_tangents_impl(const FloatGradArray<T>*);
+template <typename T>
+using num_tangents = decltype(num_tangents_impl(std::declval<T*>()));
+
+constexpr int max_num_tangents(std::initializer_list<int> ns) {
+    int n = 0;
+    for (int m : ns) {
+        n = m > n ? m : n;
+    }
+    return n;
+}
+
+constexpr bool same_num_tangents(std::initializer_list<int> ns) {
+    int n = 0;
+    for (int m : ns) {
+        if (m != 0 && n != 0 && m != n) {
+            return false;
+        }
+        n = m != 0 ? m : n;
+    }
+    return true;
+}
+
+// Primal type of a dual, e.g. FloatGrad<float> for FloatGrad<FloatGrad<float>>
+template <typename T, int N>
+T float_grad_primal_impl(const FloatGradBase<T, N>*);
+template <typename T, int N>
+T float_grad_primal_impl(const FloatGradRefBase<T, N>*);
+
+namespace float_grad_detail {
+
+template <typename T, bool = is_float_grad_val<T>::value || is_float_grad_ref<T>::value>
+struct primal_type {
+    using type = T;
+};
+
+template <typename T>
+struct primal_type<T, true> {
+    using type = std::remove_const_t<decltype(float_grad_primal_impl(std::declval<T*>()))>;
+};
+
+} // namespace float_grad_detail
+
+template <typename T>
+using float_grad_primal_t = typename float_grad_detail::primal_type<std::decay_t<T>>::type;
+
+// Nesting depth of a dual: 0 for passive types, 1 for FloatGrad<float>, 2 for
+// FloatGrad<FloatGrad<float>> (forward-over-forward), ...
+template <typename T, bool = is_float_grad_val<std::decay_t<T>>::value
+                             || is_float_grad_ref<std::decay_t<T>>::value>
+struct float_grad_depth : std::integral_constant<int, 0> {};
+
+template <typename T>
+struct float_grad_depth<T, true>
+    : std::integral_constant<int, 1 + float_grad_depth<float_grad_primal_t<T>>::value> {};
+
+constexpr int max_float_grad_depth(std::initializer_list<int> ds) {
+    int d = 0;
+    for (int m : ds) {
+        d = m > d ? m : d;
+    }
+    return d;
+}
+
+// Depth of the result of an operation on Ts
+template <typename... Ts>
+constexpr int float_grad_depth_v = max_float_grad_depth({float_grad_depth<Ts>::value...});
+
+namespace float_grad_detail {
+
+template <typename T, int D = float_grad_depth<T>::value>
+struct scalar_type : scalar_type<float_grad_primal_t<T>> {};
+
+template <typename T>
+struct scalar_type<T, 0> {
+    using type = std::decay_t<T>;
+};
+
+} // namespace float_grad_detail
+
+// Innermost primal type, e.g. float for FloatGrad<FloatGrad<float>>
+template <typename T>
+using float_grad_scalar_t = typename float_grad_detail::scalar_type<T>::type;
+
+// Only operands at the outermost depth D of an operation carry its tangent.
+// Shallower operands, including shallower duals, are passive constants there.
+template <typename T, int D>
+constexpr int num_tangents_at = float_grad_depth<T>::value == D ? num_tangents<T>::value : 0;
+
+// Whether T carries a tangent in an operation at depth D
+template <typename T, int D>
+constexpr bool has_tangent_at = num_tangents_at<T, D> > 0;
+
+// Number of tangent lanes of the result of an operation on Ts. All FloatGrad
+// operands at the outermost depth must carry the same number of lanes, apart
+// from passive ones. The result is passive if all operands are.
+template <typename... Ts>
+constexpr int num_tangents_v
+    = max_num_tangents({num_tangents_at<Ts, float_grad_depth_v<Ts...>>...});
+
+template <typename... Ts>
+constexpr bool same_num_tangents_v
+    = same_num_tangents({num_tangents_at<Ts, float_grad_depth_v<Ts...>>...});
+
+#include "cuda/float_grad_tangent.h"
+
+// Whether constructor arguments are a (data, grad) pair
+template <typename FloatType, int N, typename... Args>
+struct is_data_grad_pair : std::false_type {};
+
+template <typename FloatType, int N, typename T1, typename T2>
+struct is_data_grad_pair<FloatType, N, T1, T2>
+    : std::bool_constant<std::is_same_v<std::decay_t<T1>, std::decay_t<FloatType>>
+                         && std::is_same_v<std::decay_t<T2>,
+                                           std::decay_t<tangent_t<FloatType, N>>>> {};
+
+// Whether constructor arguments are a single dual of the constructed type.
+// Those go to the defaulted copy constructor, so that copies from rvalues stay
+// trivial when duals are members of other types, e.g. nested duals.
+template <typename Dual, typename... Args>
+struct is_dual_copy : std::false_type {};
+
+template <typename Dual, typename T>
+struct is_dual_copy<Dual, T> : std::is_base_of<Dual, std::decay_t<T>> {};
+
 /////////////////////////////////////////////////////////////////////////////
 /// Class definitions
 /////////////////////////////////////////////////////////////////////////////
 
-template <typename FloatType>
+template <typename FloatType, int N>
 struct FloatGradRefBase {
-    FloatType* const data_ptr_;
-    FloatType* const grad_ptr_;
+    using GradType = tangent_t<FloatType, N>;
 
-    // Virtual destructor for pure abstract base class
-    virtual ~FloatGradRefBase() = 0;
+    FloatType* const data_ptr_;
+    GradType* const grad_ptr_;
 
     // Delete default constructor to prevent uninitialized usage
     FloatGradRefBase() = delete;
 
     // Base constructor
     __host__ __device__
-    FloatGradRefBase(FloatType* data_ptr, FloatType* grad_ptr)
+    FloatGradRefBase(FloatType* data_ptr, GradType* grad_ptr)
         : data_ptr_(data_ptr), grad_ptr_(grad_ptr) {}
 
-    // Copy constructor
-    __host__ __device__
-    FloatGradRefBase(const FloatGradRefBase& other)
-        : data_ptr_(other.data_ptr_), grad_ptr_(other.grad_ptr_) {}
+    // Copy constructor. Copies the pointers, so refs stay trivially copyable
+    FloatGradRefBase(const FloatGradRefBase& other) = default;
 
     // Constructing from reference type
     template <typename U = FloatType, 
               typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, 
                                                          std::remove_const_t<FloatType>>>>
     __host__ __device__
-    FloatGradRefBase(const FloatGradRefBase<U>& other)
+    FloatGradRefBase(const FloatGradRefBase<U, N>& other)
         : data_ptr_(other.data_ptr_), grad_ptr_(other.grad_ptr_) {}
 
     // Constructing reference type from value type disabled
     // Use the FloatGrad.ref() function
 
-    // Default assignment operator
-    __forceinline__ __host__ __device__
-    FloatGradRefBase& operator=(const FloatGradRefBase& other) {
-        this->data() = other.data();
-        this->grad() = other.grad();
-        return *this;
-    }
+    // Assignment writes through the pointers, including from another ref of
+    // the same type. It is only provided as a template: a user-provided copy
+    // assignment would make the type non-trivially-copyable. The deleted
+    // volatile overload suppresses the implicit copy assignment, which the
+    // const pointers would otherwise declare as deleted and prefer over the
+    // template.
+    FloatGradRefBase& operator=(const volatile FloatGradRefBase&) = delete;
 
     template <typename OtherType>
     __host__ __device__
@@ -105,53 +250,48 @@ struct FloatGradRefBase {
         return *data_ptr_;
     }
     __host__ __device__
-    FloatType& grad() {
+    GradType& grad() {
         return *grad_ptr_;
     }
     __host__ __device__
-    const FloatType& grad() const {
+    const GradType& grad() const {
         return *grad_ptr_;
     }
 };
 
-template <typename FloatType>
+template <typename FloatType, int N>
 struct FloatGradBase {
-    FloatType data_;
-    FloatType grad_;
+    using GradType = tangent_t<FloatType, N>;
 
-    // Virtual destructor for pure abstract base class
-    // virtual ~FloatGradBase() = 0;
-    ~FloatGradBase();
+    FloatType data_;
+    GradType grad_;
 
-    FloatGradBase() {}
+    FloatGradBase() = default;
 
     // Copy constructor
     template <typename U = FloatType, 
               typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, 
                                                          std::remove_const_t<FloatType>>>>
     __host__ __device__
-    FloatGradBase(const FloatGradBase<U>& other)
+    FloatGradBase(const FloatGradBase<U, N>& other)
         : data_(other.data_), grad_(other.grad_) {}
 
     template <typename T1, typename T2,
               typename = std::enable_if_t<std::is_same<std::decay_t<T1>, 
                                                        std::decay_t<FloatType>>::value
                                           && std::is_same<std::decay_t<T2>, 
-                                                          std::decay_t<FloatType>>::value>>
+                                                          std::decay_t<GradType>>::value>>
     __host__ __device__
     FloatGradBase(const T1& data, const T2& grad)
         : data_(data), grad_(grad) {}
 
-    __host__ __device__
-    FloatGradBase(const FloatGradBase<FloatType>& other)
-        : data_(other.data_), grad_(other.grad_) {}
+    FloatGradBase(const FloatGradBase<FloatType, N>& other) = default;
 
     // Constructors for the FloatType
     // Need to explicitly disable the two-argument constructor
     template <typename... Args,
-    std::enable_if_t<!(sizeof...(Args) == 2 &&
-                       std::conjunction_v<std::is_same<std::decay_t<Args>, 
-                                                       std::decay_t<FloatType>>...>), int> = 0>
+    std::enable_if_t<!is_data_grad_pair<FloatType, N, Args...>::value
+                     && !is_dual_copy<FloatGradBase, Args...>::value, int> = 0>
     __host__ __device__
     FloatGradBase(Args&&... args);
 
@@ -168,48 +308,100 @@ struct FloatGradBase {
         return data_;
     }
     __host__ __device__
-    FloatType& grad() {
+    GradType& grad() {
         return grad_;
     }
     __host__ __device__
-    const FloatType& grad() const {
+    const GradType& grad() const {
         return grad_;
     }
 };
 
 /// Default class specializations
 
-template <typename FloatType>
-struct FloatGradRef : public FloatGradRefBase<FloatType> {
-    using FloatGradRefBase<FloatType>::FloatGradRefBase;
+template <typename FloatType, int N = 1>
+struct FloatGradRef : public FloatGradRefBase<FloatType, N> {
+    using FloatGradRefBase<FloatType, N>::FloatGradRefBase;
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
     
     // All assignment operators
     template <typename OtherType>
     __host__ __device__
     FloatGradRef& operator=(const OtherType& other) {
-        FloatGradRefBase<FloatType>::operator=(other);
+        FloatGradRefBase<FloatType, N>::operator=(other);
         return *this;
     }
 };
 
-template <typename FloatType>
-struct FloatGrad : public FloatGradBase<FloatType> {
-    using FloatGradBase<FloatType>::FloatGradBase;
-
-    __host__ __device__
-    FloatGrad& operator=(const FloatGrad& other) {
-        FloatGradBase<FloatType>::operator=(other);
-        return *this;
-    }
+template <typename FloatType, int N = 1>
+struct FloatGrad : public FloatGradBase<FloatType, N> {
+    using FloatGradBase<FloatType, N>::FloatGradBase;
 
     template <typename OtherType>
     __host__ __device__
     FloatGrad& operator=(const OtherType& other) {
-        FloatGradBase<FloatType>::operator=(other);
+        FloatGradBase<FloatType, N>::operator=(other);
         return *this;
     }
 };
 
+// Dual types are plain pairs of values or pointers, so they can be memcpy'd
+// and kept in registers
+static_assert(std::is_trivially_copyable_v<FloatGrad<float>>
+              && std::is_standard_layout_v<FloatGrad<float>>,
+              "FloatGrad<float> must be trivially copyable and standard layout");
+static_assert(std::is_trivially_copyable_v<FloatGrad<const float>>
+              && std::is_standard_layout_v<FloatGrad<const float>>,
+              "FloatGrad<const float> must be trivially copyable and standard layout");
+static_assert(std::is_trivially_copyable_v<FloatGradRef<float>>
+              && std::is_standard_layout_v<FloatGradRef<float>>,
+              "FloatGradRef<float> must be trivially copyable and standard layout");
+static_assert(std::is_trivially_copyable_v<FloatGradRef<const float>>
+              && std::is_standard_layout_v<FloatGradRef<const float>>,
+              "FloatGradRef<const float> must be trivially copyable and standard layout");
+static_assert(sizeof(FloatGrad<float>) == 2 * sizeof(float),
+              "FloatGrad<float> must only hold its data and grad");
+static_assert(sizeof(FloatGradRef<float>) == 2 * sizeof(float*),
+              "FloatGradRef<float> must only hold its data and grad pointers");
+
+//////////////////////////////////////////////////////////////////////////////
+/// Result types
+//////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+// Strip the outermost level from the operands at depth D
+template <typename T, int D>
+using primal_at_t = std::conditional_t<float_grad_depth<T>::value == D,
+                                       float_grad_primal_t<T>,
+                                       std::decay_t<T>>;
+
+template <typename Scalar, int D, typename... Ts>
+struct result_type {
+    using type = FloatGrad<typename result_type<Scalar, D - 1, primal_at_t<Ts, D>...>::type,
+                           num_tangents_v<Ts...>>;
+};
+
+template <typename Scalar, typename... Ts>
+struct result_type<Scalar, 0, Ts...> {
+    using type = Scalar;
+};
+
+} // namespace float_grad_detail
+
+// Dual type of a Scalar computed from Ts, nested as deep as the deepest
+// operand, e.g. float_grad_result_t<float2, FloatGrad<FloatGrad<float>>> is
+// FloatGrad<FloatGrad<float2>>
+template <typename Scalar, typename... Ts>
+using float_grad_result_t =
+    typename float_grad_detail::result_type<Scalar, float_grad_depth_v<Ts...>, Ts...>::type;
+
+// Value type of a dual or dual reference
+template <typename T>
+using float_grad_value_t = float_grad_result_t<float_grad_scalar_t<T>, T>;
+
 //////////////////////////////////////////////////////////////////////////////
 /// Container
 //////////////////////////////////////////////////////////////////////////////
@@ -237,8 +429,9 @@ decltype(auto) get_grad(const T& t) {
     if constexpr (is_float_grad<T>::value) {
         return t.grad();
     }
-    else if constexpr (std::is_same_v<std::remove_cv_t<T>, float>) {
-        return 0.0f; // Default gradient for non-Floatgrad floats
+    else if constexpr (std::is_same_v<std::remove_cv_t<T>, float>
+                       || is_zero_tangent<T>::value) {
+        return ZeroTangent{}; // Non-FloatGrad floats are passive
     }
     else {
         static_assert(always_false<T>::value, "Unsupported type for get_grad");
@@ -246,40 +439,129 @@ decltype(auto) get_grad(const T& t) {
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// Template constructor implementations
+/// Access at a nesting depth. Operations on nested duals propagate the
+/// tangent of the outermost depth D; operands at a shallower depth are
+/// passive there and are their own primal.
 //////////////////////////////////////////////////////////////////////////////
 
-template <typename FloatType>
-FloatGradRefBase<FloatType>::~FloatGradRefBase() = default; // Default destructor
-template <typename FloatType>
-FloatGradBase<FloatType>::~FloatGradBase() = default; // Default destructor
+template <int D, typename T>
+inline __host__ __device__
+decltype(auto) get_data_at(const T& t) {
+    if constexpr (float_grad_depth<T>::value == D) {
+        return t.data();
+    } else {
+        return t;
+    }
+}
+
+template <int D, typename T>
+inline __host__ __device__
+decltype(auto) get_grad_at(const T& t) {
+    if constexpr (float_grad_depth<T>::value == D) {
+        return t.grad();
+    } else if constexpr (float_grad_depth<T>::value > 0) {
+        return ZeroTangent{};
+    } else {
+        return get_grad(t);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Vector component access. FloatGrad vector types expose their components
+/// through accessor functions, builtin vector types through members. Nested
+/// vector duals take the component of the primal and of every tangent.
+//////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+template <int I, typename T>
+inline __host__ __device__
+decltype(auto) component(const T& t) {
+    if constexpr (float_grad_depth<T>::value > 1) {
+        constexpr int N = num_tangents<T>::value;
+        using CompType = float_grad_value_t<decltype(component<I>(t.data()))>;
+        CompType data = component<I>(t.data());
+        tangent_t<CompType, N> grad;
+        if constexpr (N == 1) {
+            grad = component<I>(t.grad());
+        } else if constexpr (N > 1) {
+            for (int i = 0; i < N; ++i) {
+                grad[i] = component<I>(t.grad()[i]);
+            }
+        }
+        return FloatGrad<CompType, N>(data, grad);
+    } else if constexpr (is_float_grad<T>::value) {
+        if constexpr (I == 0) return t.x();
+        else if constexpr (I == 1) return t.y();
+        else if constexpr (I == 2) return t.z();
+        else return t.w();
+    } else {
+        if constexpr (I == 0) return (t.x);
+        else if constexpr (I == 1) return (t.y);
+        else if constexpr (I == 2) return (t.z);
+        else return (t.w);
+    }
+}
+
+} // namespace float_grad_detail
+
+template <typename T>
+inline __host__ __device__
+decltype(auto) get_x(const T& t) {
+    return float_grad_detail::component<0>(t);
+}
+
+template <typename T>
+inline __host__ __device__
+decltype(auto) get_y(const T& t) {
+    return float_grad_detail::component<1>(t);
+}
+
+template <typename T>
+inline __host__ __device__
+decltype(auto) get_z(const T& t) {
+    return float_grad_detail::component<2>(t);
+}
+
+template <typename T>
+inline __host__ __device__
+decltype(auto) get_w(const T& t) {
+    return float_grad_detail::component<3>(t);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Template constructor implementations
+//////////////////////////////////////////////////////////////////////////////
 
 // Note: This needs to be marked __noinline__ to prevent incorrect compiler optimizations
-template <typename FloatType>
+template <typename FloatType, int N>
 template <typename... Args,
-std::enable_if_t<!(sizeof...(Args) == 2 &&
-                   std::conjunction_v<std::is_same<std::decay_t<Args>, 
-                                                   std::decay_t<FloatType>>...>), int>>
+std::enable_if_t<!is_data_grad_pair<FloatType, N, Args...>::value
+                 && !is_dual_copy<FloatGradBase<FloatType, N>, Args...>::value, int>>
 // __noinline__ __host__ __device__
 __forceinline__ __host__ __device__
-FloatGradBase<FloatType>::FloatGradBase(Args&&... args)
-: data_{get_data(std::forward<Args>(args))...}, grad_{get_grad(std::forward<Args>(args))...} {}
+FloatGradBase<FloatType, N>::FloatGradBase(Args&&... args)
+: data_{get_data_at<float_grad_depth<FloatGradBase>::value>(std::forward<Args>(args))...},
+  grad_(gather_tangents<std::remove_const_t<FloatType>, N>(
+      get_grad_at<float_grad_depth<FloatGradBase>::value>(std::forward<Args>(args))...)) {}
 
-template <typename FloatType>
+template <typename FloatType, int N>
 template <typename OtherType>
 __forceinline__ __host__ __device__
-FloatGradRefBase<FloatType>& FloatGradRefBase<FloatType>::operator=(const OtherType& other) {
-    this->data() = get_data(other);
-    this->grad() = get_grad(other);
+FloatGradRefBase<FloatType, N>& FloatGradRefBase<FloatType, N>::operator=(const OtherType& other) {
+    constexpr int D = float_grad_depth<FloatGradRefBase>::value;
+    this->data() = get_data_at<D>(other);
+    this->grad() = gather_tangents<std::remove_const_t<FloatType>, N>(get_grad_at<D>(other));
     return *this;
 }
 
-template <typename FloatType>
+template <typename FloatType, int N>
 template <typename OtherType>
 __forceinline__ __host__ __device__
-FloatGradBase<FloatType>& FloatGradBase<FloatType>::operator=(const OtherType& other) {
-    this->data() = get_data(other);
-    this->grad() = get_grad(other);
+FloatGradBase<FloatType, N>& FloatGradBase<FloatType, N>::operator=(const OtherType& other) {
+    constexpr int D = float_grad_depth<FloatGradBase>::value;
+    this->data() = get_data_at<D>(other);
+    this->grad() = gather_tangents<std::remove_const_t<FloatType>, N>(get_grad_at<D>(other));
     return *this;
 }
 
@@ -343,102 +625,207 @@ operator>=(const T1& a, const T2& b) {
 
 /// Arithmetic operators
 
+// Operators evaluate eagerly into FloatGrad temporaries. With inlining the
+// compiler keeps those in registers and contracts the mul-add chains, so a
+// lazy expression-template layer measured no faster than them on the 4x4
+// point transform of benchmarks/bench_expr.cu.
+
+// Tangent lanes of nested duals hold duals, so lane-wise arithmetic mixes
+// FloatTangents with FloatGrad scalars. Leave those to float_grad_tangent.h.
+// Array offsets are the array types' own operator+ (float_grad_array.h).
+template <typename T1, typename T2>
+using is_float_grad_operands =
+    std::bool_constant<(is_float_grad<T1>::value || is_float_grad<T2>::value)
+                       && !is_float_tangents<T1>::value && !is_float_tangents<T2>::value
+                       && !is_zero_tangent<T1>::value && !is_zero_tangent<T2>::value
+                       && !is_float_grad_array<T1>::value && !is_float_grad_array<T2>::value
+                       && !is_float_grad_interleaved_array<T1>::value
+                       && !is_float_grad_interleaved_array<T2>::value>;
+
 template <typename T1, typename T2,
-          typename = std::enable_if_t<is_float_grad<T1>::value
-                                      || is_float_grad<T2>::value>>
+          typename = std::enable_if_t<is_float_grad_operands<T1, T2>::value>>
 __host__ __device__
-auto operator+(T1 a, T2 b) {
-    // TODO: This is ugly. Fix later
-    if constexpr (is_float_grad_array<T1>::value 
-                  || is_float_grad_array<T2>::value) {
-        if constexpr (is_float_grad_array<T1>::value) {
-            static_assert(!is_float_grad<T2>::value, 
-                          "Cannot add FloatGradArray to FloatGrad");
-            return T1(a.data_ptr() + b, a.grad_ptr() + b);
-        } else {
-            static_assert(!is_float_grad<T1>::value, 
-                          "Cannot add FloatGrad to FloatGradArray");
-            return T2(b.data_ptr() + a, b.grad_ptr() + a);
-        }
-    } 
-    else { 
-        auto data = get_data<T1>(a) + get_data<T2>(b);
-        decltype(data) grad;
-        if constexpr (is_float_grad<T1>::value 
-            && is_float_grad<T2>::value) {
-            grad = a.grad() + b.grad();
-        } else if constexpr (is_float_grad<T1>::value) {
-            grad = a.grad();
-        } else {
-            grad = b.grad();
-        }
-        return FloatGrad<decltype(data)>(data, grad);
+auto operator+(const T1& a, const T2& b) {
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    auto data = get_data_at<D>(a) + get_data_at<D>(b);
+    tangent_t<decltype(data), N> grad;
+    if constexpr (has_tangent_at<T1, D> && has_tangent_at<T2, D>) {
+        grad = a.grad() + b.grad();
+    } else if constexpr (has_tangent_at<T1, D>) {
+        grad = a.grad();
+    } else if constexpr (has_tangent_at<T2, D>) {
+        grad = b.grad();
     }
+    return FloatGrad<decltype(data), N>(data, grad);
 }
 
 template <typename T1, typename T2,
-          typename = std::enable_if_t<is_float_grad<T1>::value
-                                      || is_float_grad<T2>::value>>
+          typename = std::enable_if_t<is_float_grad_operands<T1, T2>::value>>
 __host__ __device__
 auto operator-(const T1& a, const T2& b) {
-    auto data = get_data<T1>(a) - get_data<T2>(b);
-    decltype(data) grad;
-    if constexpr (is_float_grad<T1>::value 
-        && is_float_grad<T2>::value) {
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    auto data = get_data_at<D>(a) - get_data_at<D>(b);
+    tangent_t<decltype(data), N> grad;
+    if constexpr (has_tangent_at<T1, D> && has_tangent_at<T2, D>) {
         grad = a.grad() - b.grad();
-    } else if constexpr (is_float_grad<T1>::value) {
+    } else if constexpr (has_tangent_at<T1, D>) {
         grad = a.grad();
-    } else {
+    } else if constexpr (has_tangent_at<T2, D>) {
         grad = -b.grad();
     }
-    return FloatGrad<decltype(data)>(data, grad);
+    return FloatGrad<decltype(data), N>(data, grad);
 }
 
 template <typename T1, typename T2,
-          typename = std::enable_if_t<is_float_grad<T1>::value
-                                      || is_float_grad<T2>::value>>
+          typename = std::enable_if_t<is_float_grad_operands<T1, T2>::value>>
 __host__ __device__
 auto operator*(const T1& a, const T2& b) {
-    auto data = get_data<T1>(a) * get_data<T2>(b);
-    decltype(data) grad;
-    if constexpr (is_float_grad<T1>::value 
-        && is_float_grad<T2>::value) {
-        grad = get_data(a) * get_grad(b) + get_grad(a) * get_data(b);
-    } else if constexpr (is_float_grad<T1>::value) {
-        grad = get_grad(a) * get_data(b);
-    } else {
-        grad = get_data(a) * get_grad(b);
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    auto data = get_data_at<D>(a) * get_data_at<D>(b);
+    tangent_t<decltype(data), N> grad;
+    if constexpr (has_tangent_at<T1, D> && has_tangent_at<T2, D>) {
+        grad = get_data_at<D>(a) * get_grad_at<D>(b) + get_grad_at<D>(a) * get_data_at<D>(b);
+    } else if constexpr (has_tangent_at<T1, D>) {
+        grad = get_grad_at<D>(a) * get_data_at<D>(b);
+    } else if constexpr (has_tangent_at<T2, D>) {
+        grad = get_data_at<D>(a) * get_grad_at<D>(b);
     }
-    return FloatGrad<decltype(data)>(data, grad);
+    return FloatGrad<decltype(data), N>(data, grad);
 }
 
 template <typename T1, typename T2,
-          typename = std::enable_if_t<is_float_grad<T1>::value
-                                      || is_float_grad<T2>::value>>
+          typename = std::enable_if_t<is_float_grad_operands<T1, T2>::value>>
 __host__ __device__
 auto operator/(const T1& a, const T2& b) {
-    auto data = get_data<T1>(a) / get_data<T2>(b);
-    decltype(data) grad;
-    if constexpr (is_float_grad<T1>::value 
-        && is_float_grad<T2>::value) {
-        grad = (get_grad(a) * get_data(b) - get_data(a) * get_grad(b)) 
-                / (get_data(b) * get_data(b));
-    } else if constexpr (is_float_grad<T1>::value) {
-        grad = get_grad(a) / get_data(b);
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    auto data = get_data_at<D>(a) / get_data_at<D>(b);
+    tangent_t<decltype(data), N> grad;
+    if constexpr (has_tangent_at<T1, D> && has_tangent_at<T2, D>) {
+        grad = (get_grad_at<D>(a) * get_data_at<D>(b) - get_data_at<D>(a) * get_grad_at<D>(b)) 
+                / (get_data_at<D>(b) * get_data_at<D>(b));
+    } else if constexpr (has_tangent_at<T1, D>) {
+        grad = get_grad_at<D>(a) / get_data_at<D>(b);
+    } else if constexpr (has_tangent_at<T2, D>) {
+        grad = -get_data_at<D>(a) * get_grad_at<D>(b) 
+                / (get_data_at<D>(b) * get_data_at<D>(b));
+    }
+    return FloatGrad<decltype(data), N>(data, grad);
+}
+
+/// Compound assignment operators. They update the primal and the tangent in
+/// place, so accumulating into a FloatGradRef is one load and one store per
+/// member, as for plain floats. Operands are read before t is written, so
+/// t may alias other, e.g. t *= t.
+
+template <typename T, typename T1, typename T2>
+__host__ __device__
+std::enable_if_t<is_float_grad_val<T>::value, T&>
+fma_assign(T& acc, const T1& a, const T2& b);
+
+namespace float_grad_detail {
+
+// Whether other contributes a tangent to the dual t
+template <typename Dual, typename OtherType>
+inline __host__ __device__
+constexpr bool check_compound_operand() {
+    constexpr int D = float_grad_depth<Dual>::value;
+    static_assert(float_grad_depth<OtherType>::value <= D,
+                  "Cannot accumulate a dual into a less nested one");
+    static_assert(same_num_tangents_v<Dual, OtherType>,
+                  "FloatGrad operands must have the same number of tangents");
+    static_assert(num_tangents<Dual>::value > 0 || !has_tangent_at<OtherType, D>,
+                  "Cannot accumulate an active tangent into a passive FloatGrad<T, 0>");
+    return has_tangent_at<OtherType, D>;
+}
+
+// acc += a * b on primals or tangents, with lanes broadcast as needed. Plain
+// floats contract to fmaf, nested duals recurse into fma_assign.
+template <typename Acc, typename A, typename B>
+inline __host__ __device__
+void multiply_accumulate(Acc& acc, const A& a, const B& b) {
+    if constexpr (is_float_tangents<Acc>::value) {
+        for (int i = 0; i < Acc::size; ++i) {
+            multiply_accumulate(acc[i], tangent_lane(a, i), tangent_lane(b, i));
+        }
+    } else if constexpr (std::is_same_v<Acc, float> && std::is_same_v<A, float>
+                         && std::is_same_v<B, float>) {
+        acc = fmaf(a, b, acc);
+    } else if constexpr (is_float_grad_val<Acc>::value) {
+        fma_assign(acc, a, b);
     } else {
-        grad = -get_data(a) * get_grad(b) / (get_data(b) * get_data(b));
+        acc += a * b;
+    }
+}
+
+template <typename Dual, typename OtherType>
+inline __host__ __device__
+void add_assign(Dual& t, const OtherType& other) {
+    constexpr int D = float_grad_depth<Dual>::value;
+    if constexpr (check_compound_operand<Dual, OtherType>()) {
+        t.grad() += get_grad_at<D>(other);
     }
-    return FloatGrad<decltype(data)>(data, grad);
+    t.data() += get_data_at<D>(other);
 }
 
-/// Compound assignment operators. Need to separate val and ref types due to 
-/// array indexing returning r-value references.
+template <typename Dual, typename OtherType>
+inline __host__ __device__
+void sub_assign(Dual& t, const OtherType& other) {
+    constexpr int D = float_grad_depth<Dual>::value;
+    if constexpr (check_compound_operand<Dual, OtherType>()) {
+        t.grad() -= get_grad_at<D>(other);
+    }
+    t.data() -= get_data_at<D>(other);
+}
+
+// (a b)' = a' b + a b'
+template <typename Dual, typename OtherType>
+inline __host__ __device__
+void mul_assign(Dual& t, const OtherType& other) {
+    constexpr int D = float_grad_depth<Dual>::value;
+    const auto b = get_data_at<D>(other);
+    if constexpr (check_compound_operand<Dual, OtherType>()) {
+        const auto b_grad = get_grad_at<D>(other);
+        t.grad() *= b;
+        multiply_accumulate(t.grad(), t.data(), b_grad);
+    } else {
+        t.grad() *= b;
+    }
+    t.data() *= b;
+}
+
+// (a / b)' = (a' - q b') / b with q = a / b
+template <typename Dual, typename OtherType>
+inline __host__ __device__
+void div_assign(Dual& t, const OtherType& other) {
+    constexpr int D = float_grad_depth<Dual>::value;
+    const auto b = get_data_at<D>(other);
+    t.data() /= b;
+    if constexpr (check_compound_operand<Dual, OtherType>()) {
+        const auto b_grad = get_grad_at<D>(other);
+        multiply_accumulate(t.grad(), -t.data(), b_grad);
+    }
+    t.grad() /= b;
+}
+
+} // namespace float_grad_detail
 
 template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_val<T>::value, T&>
 operator+=(T& t, const OtherType& other) {
-    t = t + other;
+    float_grad_detail::add_assign(t, other);
     return t;
 }
 
@@ -446,7 +833,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_ref<T>::value, T>
 operator+=(T t, const OtherType& other) {
-    t = t + other;
+    float_grad_detail::add_assign(t, other);
     return t;
 }
 
@@ -454,7 +841,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_val<T>::value, T&>
 operator-=(T& t, const OtherType& other) {
-    t = t - other;
+    float_grad_detail::sub_assign(t, other);
     return t;
 }
 
@@ -462,7 +849,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_ref<T>::value, T>
 operator-=(T t, const OtherType& other) {
-    t = t - other;
+    float_grad_detail::sub_assign(t, other);
     return t;
 }
 
@@ -470,7 +857,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_val<T>::value, T&>
 operator*=(T& t, const OtherType& other) {
-    t = t * other;
+    float_grad_detail::mul_assign(t, other);
     return t;
 }
 
@@ -478,7 +865,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_ref<T>::value, T>
 operator*=(T t, const OtherType& other) {
-    t = t * other;
+    float_grad_detail::mul_assign(t, other);
     return t;
 }
 
@@ -486,7 +873,7 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_val<T>::value, T&>
 operator/=(T& t, const OtherType& other) {
-    t = t / other;
+    float_grad_detail::div_assign(t, other);
     return t;
 }
 
@@ -494,10 +881,55 @@ template <typename T, typename OtherType>
 __host__ __device__
 std::enable_if_t<is_float_grad_ref<T>::value, T>
 operator/=(T t, const OtherType& other) {
-    t = t / other;
+    float_grad_detail::div_assign(t, other);
     return t;
 }
 
+/// Fused multiply-accumulate acc += a * b. Updates the primal and the tangent
+/// with two fmaf each instead of building the product, e.g. for the inner
+/// loop of a dual matrix product.
+
+namespace float_grad_detail {
+
+template <typename Dual, typename T1, typename T2>
+inline __host__ __device__
+void fma_assign_impl(Dual& acc, const T1& a, const T2& b) {
+    constexpr int D = float_grad_depth<Dual>::value;
+    constexpr bool a_active = check_compound_operand<Dual, T1>();
+    constexpr bool b_active = check_compound_operand<Dual, T2>();
+    const auto a_data = get_data_at<D>(a);
+    const auto b_data = get_data_at<D>(b);
+    if constexpr (a_active && b_active) {
+        // Form the product tangent first, so that reductions carry a single
+        // dependent add per step on the accumulator, as plain floats do
+        auto grad = get_grad_at<D>(a) * b_data;
+        multiply_accumulate(grad, a_data, get_grad_at<D>(b));
+        acc.grad() += grad;
+    } else if constexpr (a_active) {
+        multiply_accumulate(acc.grad(), get_grad_at<D>(a), b_data);
+    } else if constexpr (b_active) {
+        multiply_accumulate(acc.grad(), a_data, get_grad_at<D>(b));
+    }
+    multiply_accumulate(acc.data(), a_data, b_data);
+}
+
+} // namespace float_grad_detail
+
+template <typename T, typename T1, typename T2>
+__host__ __device__
+std::enable_if_t<is_float_grad_val<T>::value, T&>
+fma_assign(T& acc, const T1& a, const T2& b) {
+    float_grad_detail::fma_assign_impl(acc, a, b);
+    return acc;
+}
+
+template <typename T, typename T1, typename T2>
+__host__ __device__
+std::enable_if_t<is_float_grad_ref<T>::value, T>
+fma_assign(T acc, const T1& a, const T2& b) {
+    float_grad_detail::fma_assign_impl(acc, a, b);
+    return acc;
+}
 
 #endif // FLOAT_GRAD_BASE_H
 
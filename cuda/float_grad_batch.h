@@ -0,0 +1,459 @@
+#ifndef FLOAT_GRAD_BATCH_H
+#define FLOAT_GRAD_BATCH_H
+
+#include <cstdint>
+
+#include "float_grad_base.h"
+#include "float_grad_float.h"
+#include "float_grad_array.h"
+#include "float_grad_simd.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Batched elementwise kernels over FloatGradArray spans. Data and grad are
+/// separate planes, so n duals are processed as n / W SIMD loads of each
+/// plane, with the vector width W of float_grad_simd.h. Loads are unaligned,
+/// but planes aligned to 64 bytes avoid split cache-line accesses, which
+/// roughly halve AVX-512 throughput on in-cache data. These are host
+/// functions; out may be one of the inputs for in-place updates, but must
+/// not partially overlap them. The transcendental kernels share the
+/// intermediates of the primal with the tangent, as their scalar FloatGrad
+/// overloads do, and hand lanes outside the range of the vector
+/// approximation to those overloads.
+///
+///     batch_mul(out, a, b, n);  // out[i] = a[i] * b[i] for i < n
+//////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+// Primal and tangent lanes of W consecutive duals
+template <typename V>
+struct SimdDual {
+    V d;
+    V g;
+};
+
+template <typename V, typename T>
+inline SimdDual<V> load_duals(const FloatGradArray<T>& a, int64_t i) {
+    static_assert(std::is_same_v<std::remove_const_t<T>, float>,
+                  "Batch kernels operate on FloatGradArray<float>");
+    return {V::load(a.data_ptr() + i), V::load(a.grad_ptr() + i)};
+}
+
+template <typename V>
+inline void store_duals(FloatGradArray<float>& out, int64_t i, V d, V g) {
+    d.store(out.data_ptr() + i);
+    g.store(out.grad_ptr() + i);
+}
+
+template <typename V, typename T>
+inline SimdDual<V> load_duals(const FloatGradInterleavedArray<T>& a, int64_t i) {
+    static_assert(std::is_same_v<std::remove_const_t<T>, float>,
+                  "Batch kernels operate on FloatGradInterleavedArray<float>");
+    SimdDual<V> x;
+    simd_load_pairs(a.data_ptr() + 2 * i, x.d, x.g);
+    return x;
+}
+
+template <typename V>
+inline void store_duals(FloatGradInterleavedArray<float>& out, int64_t i, V d, V g) {
+    simd_store_pairs(out.data_ptr() + 2 * i, d, g);
+}
+
+} // namespace float_grad_detail
+
+/// Binary arithmetic
+
+template <typename TA, typename TB>
+inline void batch_add(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        store_duals(out, i, x.d + y.d, x.g + y.g);
+    });
+}
+
+template <typename TA, typename TB>
+inline void batch_sub(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        store_duals(out, i, x.d - y.d, x.g - y.g);
+    });
+}
+
+template <typename TA, typename TB>
+inline void batch_mul(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        store_duals(out, i, x.d * y.d, simd_fma(x.g, y.d, x.d * y.g));
+    });
+}
+
+// (a / b)' = (a' - q b') / b with q = a / b
+template <typename TA, typename TB>
+inline void batch_div(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        const V q = x.d / y.d;
+        store_duals(out, i, q, (x.g - q * y.g) / y.d);
+    });
+}
+
+// out = a * b + c
+template <typename TA, typename TB, typename TC>
+inline void batch_fma(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, const FloatGradArray<TC>& c, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        const SimdDual<V> z = load_duals<V>(c, i);
+        store_duals(out, i, simd_fma(x.d, y.d, z.d), simd_fma(x.g, y.d, simd_fma(x.d, y.g, z.g)));
+    });
+}
+
+/// Functions
+
+template <typename T>
+inline void batch_sqrt(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V s = simd_sqrt(x.d);
+        store_duals(out, i, s, x.g / (s + s));
+    });
+}
+
+// Exact 1 / sqrt(a), not the hardware approximation
+template <typename T>
+inline void batch_rsqrt(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V r = V::broadcast(1.0f) / simd_sqrt(x.d);
+        store_duals(out, i, r, V::broadcast(-0.5f) * x.g * r * r * r);
+    });
+}
+
+template <typename T>
+inline void batch_exp(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V e = simd_exp(x.d);
+        store_duals(out, i, e, e * x.g);
+    });
+}
+
+/// Selections. The tangent follows the selected operand, with the same tie
+/// rules as the scalar fminf, fmaxf and clamp overloads.
+
+template <typename TA, typename TB>
+inline void batch_min(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        const auto m = simd_less(x.d, y.d);
+        store_duals(out, i, simd_select(m, x.d, y.d), simd_select(m, x.g, y.g));
+    });
+}
+
+template <typename TA, typename TB>
+inline void batch_max(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        const auto m = simd_less(y.d, x.d);
+        store_duals(out, i, simd_select(m, x.d, y.d), simd_select(m, x.g, y.g));
+    });
+}
+
+// Clamp to passive bounds [lo, hi]; the tangent is zero where v is clamped
+template <typename T>
+inline void batch_clamp(FloatGradArray<float> out, const FloatGradArray<T>& v,
+                        float lo, float hi, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(v, i);
+        const V lo_v = V::broadcast(lo);
+        const V hi_v = V::broadcast(hi);
+        const V zero = V::broadcast(0.0f);
+        const auto below_hi = simd_less(x.d, hi_v);
+        const V upper_d = simd_select(below_hi, x.d, hi_v);
+        const V upper_g = simd_select(below_hi, x.g, zero);
+        const auto below_lo = simd_less(upper_d, lo_v);
+        store_duals(out, i, simd_select(below_lo, lo_v, upper_d),
+                    simd_select(below_lo, zero, upper_g));
+    });
+}
+
+/// Transcendentals
+
+template <typename T>
+inline void batch_log(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        store_duals(out, i, simd_log(x.d), x.g / x.d);
+    });
+}
+
+template <typename T>
+inline void batch_log1p(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V u;
+        const V y = simd_log1p(x.d, u);
+        store_duals(out, i, y, x.g / u);
+    });
+}
+
+// sin and cos of a from one range reduction
+template <typename T>
+inline void batch_sincos(FloatGradArray<float> out_sin, FloatGradArray<float> out_cos,
+                         const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V s, c;
+        simd_sincos(x.d, s, c);
+        store_duals(out_sin, i, s, c * x.g);
+        store_duals(out_cos, i, c, simd_neg(s) * x.g);
+        for_each_lane(simd_bits(simd_less(V::broadcast(simd_trig_limit), simd_abs(x.d))), i, [&](int64_t j) {
+            FloatGrad<float> sj, cj;
+            sincosf(a[j], &sj, &cj);
+            out_sin[j] = sj;
+            out_cos[j] = cj;
+        });
+    });
+}
+
+template <typename T>
+inline void batch_sin(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V s, c;
+        simd_sincos(x.d, s, c);
+        store_duals(out, i, s, c * x.g);
+        for_each_lane(simd_bits(simd_less(V::broadcast(simd_trig_limit), simd_abs(x.d))), i, [&](int64_t j) {
+            out[j] = sinf(a[j]);
+        });
+    });
+}
+
+template <typename T>
+inline void batch_cos(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V s, c;
+        simd_sincos(x.d, s, c);
+        store_duals(out, i, c, simd_neg(s) * x.g);
+        for_each_lane(simd_bits(simd_less(V::broadcast(simd_trig_limit), simd_abs(x.d))), i, [&](int64_t j) {
+            out[j] = cosf(a[j]);
+        });
+    });
+}
+
+template <typename T>
+inline void batch_tan(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V s, c;
+        simd_sincos(x.d, s, c);
+        const V t = s / c;
+        store_duals(out, i, t, simd_fma(t, t, V::broadcast(1.0f)) * x.g);
+        for_each_lane(simd_bits(simd_less(V::broadcast(simd_trig_limit), simd_abs(x.d))), i, [&](int64_t j) {
+            out[j] = tanf(a[j]);
+        });
+    });
+}
+
+template <typename T>
+inline void batch_tanh(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V y = simd_tanh(x.d);
+        store_duals(out, i, y, simd_fma(simd_neg(y), y, V::broadcast(1.0f)) * x.g);
+    });
+}
+
+template <typename T>
+inline void batch_sigmoid(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V one = V::broadcast(1.0f);
+        const V y = one / (one + simd_exp(simd_neg(x.d)));
+        store_duals(out, i, y, simd_fma(simd_neg(y), y, y) * x.g);
+    });
+}
+
+template <typename T>
+inline void batch_erf(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        V e;
+        const V y = simd_erf(x.d, e);
+        store_duals(out, i, y, V::broadcast(1.12837917f) * e * x.g);
+    });
+}
+
+template <typename T>
+inline void batch_acos(FloatGradArray<float> out, const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const V one = V::broadcast(1.0f);
+        const V s = simd_sqrt((one - x.d) * (one + x.d));
+        store_duals(out, i, simd_acos(x.d), simd_neg(x.g) / s);
+    });
+}
+
+// a^b, through exp and log for positive finite a and finite b
+template <typename TA, typename TB>
+inline void batch_pow(FloatGradArray<float> out, const FloatGradArray<TA>& a,
+                      const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        V log_x;
+        const V r = simd_pow(x.d, y.d, log_x);
+        store_duals(out, i, r, simd_fma(y.d * r / x.d, x.g, r * log_x * y.g));
+        const V inf = V::broadcast(std::numeric_limits<float>::infinity());
+        const auto ok = simd_and(simd_and(simd_less(V::broadcast(0.0f), x.d), simd_less(x.d, inf)),
+                                 simd_less(simd_abs(y.d), inf));
+        for_each_lane(~simd_bits(ok) & lane_mask<V>, i, [&](int64_t j) {
+            out[j] = powf(a[j], b[j]);
+        });
+    });
+}
+
+// atan2(y, x), with the zero, infinite and NaN cases of atan2f
+template <typename TY, typename TX>
+inline void batch_atan2(FloatGradArray<float> out, const FloatGradArray<TY>& y,
+                        const FloatGradArray<TX>& x, int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> v = load_duals<V>(y, i);
+        const SimdDual<V> u = load_duals<V>(x, i);
+        const V r2 = simd_fma(u.d, u.d, v.d * v.d);
+        store_duals(out, i, simd_atan2(v.d, u.d), (u.d * v.g - v.d * u.g) / r2);
+        const V inf = V::broadcast(std::numeric_limits<float>::infinity());
+        const V ax = simd_abs(u.d);
+        const auto ok = simd_and(simd_and(simd_less(V::broadcast(0.0f), ax), simd_less(ax, inf)),
+                                 simd_less(simd_abs(v.d), inf));
+        for_each_lane(~simd_bits(ok) & lane_mask<V>, i, [&](int64_t j) {
+            out[j] = atan2f(y[j], x[j]);
+        });
+    });
+}
+
+/// Reductions. Each lane accumulates its own partial sums, which are added
+/// across lanes at the end, so the rounding differs from a sequential sum.
+
+template <typename T>
+inline FloatGrad<float> batch_sum(const FloatGradArray<T>& a, int64_t n) {
+    using namespace float_grad_detail;
+    SimdDual<SimdVec> acc = {SimdVec::broadcast(0.0f), SimdVec::broadcast(0.0f)};
+    SimdDual<SimdScalar> tail = {{0.0f}, {0.0f}};
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        if constexpr (std::is_same_v<V, SimdVec>) {
+            acc = {acc.d + x.d, acc.g + x.g};
+        } else {
+            tail = {tail.d + x.d, tail.g + x.g};
+        }
+    });
+    return FloatGrad<float>(simd_sum(acc.d) + tail.d.v, simd_sum(acc.g) + tail.g.v);
+}
+
+// sum of a[i] * b[i], with the tangent sum of a'[i] b[i] + a[i] b'[i]
+template <typename TA, typename TB>
+inline FloatGrad<float> batch_dot(const FloatGradArray<TA>& a, const FloatGradArray<TB>& b, int64_t n) {
+    using namespace float_grad_detail;
+    SimdDual<SimdVec> acc = {SimdVec::broadcast(0.0f), SimdVec::broadcast(0.0f)};
+    SimdDual<SimdScalar> tail = {{0.0f}, {0.0f}};
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(a, i);
+        const SimdDual<V> y = load_duals<V>(b, i);
+        if constexpr (std::is_same_v<V, SimdVec>) {
+            acc = {simd_fma(x.d, y.d, acc.d), simd_fma(x.g, y.d, simd_fma(x.d, y.g, acc.g))};
+        } else {
+            tail = {simd_fma(x.d, y.d, tail.d), simd_fma(x.g, y.d, simd_fma(x.d, y.g, tail.g))};
+        }
+    });
+    return FloatGrad<float>(simd_sum(acc.d) + tail.d.v, simd_sum(acc.g) + tail.g.v);
+}
+
+/// Layout conversion between interleaved (primal, tangent) pairs, as in
+/// torch JVP tensors, and separate planes. out must not overlap in.
+
+template <typename T>
+inline void batch_deinterleave(FloatGradArray<float> out, const FloatGradInterleavedArray<T>& in,
+                               int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(in, i);
+        store_duals(out, i, x.d, x.g);
+    });
+}
+
+template <typename T>
+inline void batch_interleave(FloatGradInterleavedArray<float> out, const FloatGradArray<T>& in,
+                             int64_t n) {
+    using namespace float_grad_detail;
+    for_each_batch(n, [&](auto tag, int64_t i) {
+        using V = typename decltype(tag)::type;
+        const SimdDual<V> x = load_duals<V>(in, i);
+        store_duals(out, i, x.d, x.g);
+    });
+}
+
+#endif // FLOAT_GRAD_BATCH_H
@@ -0,0 +1,257 @@
+#ifndef FLOAT_GRAD_BMM_H
+#define FLOAT_GRAD_BMM_H
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "float_grad_base.h"
+#include "float_grad_tensor.h"
+#include "float_grad_simd.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Host batched products of small dual matrices, C[b] = A[b] B[b] with the
+/// tangent dC[b] = dA[b] B[b] + A[b] dB[b]. The batch is the innermost,
+/// unit-stride dimension of the operands, so a SIMD vector holds the same
+/// element of W matrices and the product is the scalar formula on vectors:
+/// no lane is idle and no shuffles are needed, whatever the matrix size.
+/// Size 1 covers matrix-vector products such as point transforms.
+///
+/// Operands are [M, K, batch], [K, N, batch] and [M, N, batch] views, or
+/// blocked [blocks, M, K, lanes] views of matrix b = block * lanes + lane.
+/// With large batches the blocked layout is the faster one: a block of
+/// bmm_block_lanes matrices is contiguous, where the plain one streams
+/// every matrix element from its own plane.
+///
+///     bmm_jvp<4, 4, 4>(C, A, B);  // sizes fixed at compile time
+///     bmm_jvp(C, A, B);           // sizes 1 to 4 dispatched to the above
+///
+/// As in gemm_jvp, A or B without a tangent plane is passive and C without
+/// one gets only primals. The runtime dispatcher falls back to a scalar
+/// loop for other sizes and for views whose lane stride is not 1.
+//////////////////////////////////////////////////////////////////////////////
+
+// Lanes per block of the blocked layout: one AVX-512 vector, which measured
+// fastest for all sizes from 2 x 2 to 4 x 4 on batches past the caches
+constexpr int64_t bmm_block_lanes = 16;
+
+namespace float_grad_detail {
+
+// A plain [rows, cols, batch] view as one block of a blocked view
+template <typename T>
+inline FloatGradTensor<T, 4> bmm_blocked(const FloatGradTensor<T, 3>& t) {
+    return FloatGradTensor<T, 4>(t.data_ptr(), t.grad_ptr(), {1, t.size(0), t.size(1), t.size(2)},
+                                 {0, t.data_stride(0), t.data_stride(1), t.data_stride(2)},
+                                 {0, t.grad_stride(0), t.grad_stride(1), t.grad_stride(2)});
+}
+
+template <int M, int K, int N, bool DualA, bool DualB>
+inline void bmm_jvp_lanes(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                          const FloatGradTensor<const float, 4>& B) {
+    constexpr bool Dual = DualA || DualB;
+    // Lanes of every matrix element in block 0; block o is o strides further
+    const float* a[M][K];
+    const float* da[M][K];
+    const float* b[K][N];
+    const float* db[K][N];
+    float* c[M][N];
+    float* dc[M][N];
+    for (int i = 0; i < M; ++i) {
+        for (int k = 0; k < K; ++k) {
+            a[i][k] = &A.data(0, i, k, 0);
+            da[i][k] = DualA ? &A.grad(0, i, k, 0) : nullptr;
+        }
+        for (int j = 0; j < N; ++j) {
+            c[i][j] = &C.data(0, i, j, 0);
+            dc[i][j] = Dual ? &C.grad(0, i, j, 0) : nullptr;
+        }
+    }
+    for (int k = 0; k < K; ++k) {
+        for (int j = 0; j < N; ++j) {
+            b[k][j] = &B.data(0, k, j, 0);
+            db[k][j] = DualB ? &B.grad(0, k, j, 0) : nullptr;
+        }
+    }
+
+    for (int64_t o = 0; o < C.size(0); ++o) {
+        const int64_t ao = o * A.data_stride(0), dao = o * A.grad_stride(0);
+        const int64_t bo = o * B.data_stride(0), dbo = o * B.grad_stride(0);
+        const int64_t co = o * C.data_stride(0), dco = o * C.grad_stride(0);
+        // Row i of C accumulates in 2 N vectors over k, with B reloaded from
+        // L1 for every row rather than held in registers, which would take
+        // the whole register file at 4 x 4
+        for_each_batch(C.size(3), [&](auto tag, int64_t l) {
+            using V = typename decltype(tag)::type;
+            for (int i = 0; i < M; ++i) {
+                V d[N], g[N];
+                for (int k = 0; k < K; ++k) {
+                    const V av = V::load(a[i][k] + ao + l);
+                    V dav;
+                    if constexpr (DualA) {
+                        dav = V::load(da[i][k] + dao + l);
+                    }
+                    for (int j = 0; j < N; ++j) {
+                        const V bv = V::load(b[k][j] + bo + l);
+                        d[j] = k == 0 ? av * bv : simd_fma(av, bv, d[j]);
+                        if constexpr (DualA) {
+                            g[j] = k == 0 ? dav * bv : simd_fma(dav, bv, g[j]);
+                        }
+                        if constexpr (DualB) {
+                            const V dbv = V::load(db[k][j] + dbo + l);
+                            g[j] = k == 0 && !DualA ? av * dbv : simd_fma(av, dbv, g[j]);
+                        }
+                    }
+                }
+                for (int j = 0; j < N; ++j) {
+                    d[j].store(c[i][j] + co + l);
+                    if constexpr (Dual) {
+                        g[j].store(dc[i][j] + dco + l);
+                    }
+                }
+            }
+        });
+    }
+}
+
+// Any sizes and strides, one matrix element at a time
+template <bool DualA, bool DualB>
+inline void bmm_jvp_generic(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                            const FloatGradTensor<const float, 4>& B) {
+    for (int64_t o = 0; o < C.size(0); ++o) {
+        for (int64_t l = 0; l < C.size(3); ++l) {
+            for (int64_t i = 0; i < C.size(1); ++i) {
+                for (int64_t j = 0; j < C.size(2); ++j) {
+                    float d = 0.0f;
+                    float g = 0.0f;
+                    for (int64_t k = 0; k < A.size(2); ++k) {
+                        d = fmaf(A.data(o, i, k, l), B.data(o, k, j, l), d);
+                        if constexpr (DualA) {
+                            g = fmaf(A.grad(o, i, k, l), B.data(o, k, j, l), g);
+                        }
+                        if constexpr (DualB) {
+                            g = fmaf(A.data(o, i, k, l), B.grad(o, k, j, l), g);
+                        }
+                    }
+                    C.data(o, i, j, l) = d;
+                    if constexpr (DualA || DualB) {
+                        C.grad(o, i, j, l) = g;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Calls kernel(dual_a, dual_b) with std::bool_constant arguments for the
+// tangent planes present, after zeroing the tangent of C when neither
+// input has one
+template <typename Kernel>
+inline void bmm_jvp_dispatch(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                             const FloatGradTensor<const float, 4>& B, Kernel&& kernel) {
+    const bool dual_a = C.has_grad() && A.has_grad();
+    const bool dual_b = C.has_grad() && B.has_grad();
+    if (C.has_grad() && !(dual_a || dual_b)) {
+        for (int64_t o = 0; o < C.size(0); ++o) {
+            for (int64_t i = 0; i < C.size(1); ++i) {
+                for (int64_t j = 0; j < C.size(2); ++j) {
+                    for (int64_t l = 0; l < C.size(3); ++l) {
+                        C.grad(o, i, j, l) = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+    if (dual_a && dual_b) {
+        kernel(std::true_type{}, std::true_type{});
+    } else if (dual_a) {
+        kernel(std::true_type{}, std::false_type{});
+    } else if (dual_b) {
+        kernel(std::false_type{}, std::true_type{});
+    } else {
+        kernel(std::false_type{}, std::false_type{});
+    }
+}
+
+// Whether every plane of a blocked view has unit stride along the lanes
+template <typename T>
+inline bool bmm_lanes_contiguous(const FloatGradTensor<T, 4>& t) {
+    return t.size(3) <= 1 || (t.data_stride(3) == 1 && (!t.has_grad() || t.grad_stride(3) == 1));
+}
+
+// Sizes with a compiled bmm_jvp
+inline bool bmm_small_size(int64_t n) {
+    return n >= 1 && n <= 4;
+}
+
+// Calls f(std::integral_constant<int, n>{}) for a small size n
+template <typename Function>
+inline void bmm_with_size(int64_t n, Function&& f) {
+    switch (n) {
+        case 1: f(std::integral_constant<int, 1>{}); break;
+        case 2: f(std::integral_constant<int, 2>{}); break;
+        case 3: f(std::integral_constant<int, 3>{}); break;
+        default: f(std::integral_constant<int, 4>{}); break;
+    }
+}
+
+template <int M, int K, int N>
+inline void bmm_jvp_fixed(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                          const FloatGradTensor<const float, 4>& B) {
+    assert(C.size(1) == M && C.size(2) == N && A.size(1) == M && A.size(2) == K
+           && B.size(1) == K && B.size(2) == N && "bmm_jvp shape mismatch");
+    assert(bmm_lanes_contiguous(A) && bmm_lanes_contiguous(B) && bmm_lanes_contiguous(C)
+           && "bmm_jvp needs unit lane strides");
+    bmm_jvp_dispatch(C, A, B, [&](auto dual_a, auto dual_b) {
+        bmm_jvp_lanes<M, K, N, decltype(dual_a)::value, decltype(dual_b)::value>(C, A, B);
+    });
+}
+
+inline void bmm_jvp_any(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                        const FloatGradTensor<const float, 4>& B) {
+    if (bmm_small_size(C.size(1)) && bmm_small_size(A.size(2)) && bmm_small_size(C.size(2))
+        && bmm_lanes_contiguous(A) && bmm_lanes_contiguous(B) && bmm_lanes_contiguous(C)) {
+        bmm_with_size(C.size(1), [&](auto m) {
+            bmm_with_size(A.size(2), [&](auto k) {
+                bmm_with_size(C.size(2), [&](auto n) {
+                    bmm_jvp_fixed<decltype(m)::value, decltype(k)::value, decltype(n)::value>(C, A, B);
+                });
+            });
+        });
+        return;
+    }
+    bmm_jvp_dispatch(C, A, B, [&](auto dual_a, auto dual_b) {
+        bmm_jvp_generic<decltype(dual_a)::value, decltype(dual_b)::value>(C, A, B);
+    });
+}
+
+} // namespace float_grad_detail
+
+// C[b] = A[b] B[b] over the batch of plain [rows, cols, batch] views, with
+// unit batch stride. C must not overlap A or B.
+template <int M, int K, int N>
+inline void bmm_jvp(const FloatGradTensor<float, 3>& C, const FloatGradTensor<const float, 3>& A,
+                    const FloatGradTensor<const float, 3>& B) {
+    using namespace float_grad_detail;
+    bmm_jvp_fixed<M, K, N>(bmm_blocked(C), bmm_blocked(A), bmm_blocked(B));
+}
+
+// Same over blocked [blocks, rows, cols, lanes] views, with unit lane stride
+template <int M, int K, int N>
+inline void bmm_jvp(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                    const FloatGradTensor<const float, 4>& B) {
+    float_grad_detail::bmm_jvp_fixed<M, K, N>(C, A, B);
+}
+
+// Products with sizes known at run time, of either layout
+inline void bmm_jvp(const FloatGradTensor<float, 3>& C, const FloatGradTensor<const float, 3>& A,
+                    const FloatGradTensor<const float, 3>& B) {
+    using namespace float_grad_detail;
+    bmm_jvp_any(bmm_blocked(C), bmm_blocked(A), bmm_blocked(B));
+}
+
+inline void bmm_jvp(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                    const FloatGradTensor<const float, 4>& B) {
+    float_grad_detail::bmm_jvp_any(C, A, B);
+}
+
+#endif // FLOAT_GRAD_BMM_H
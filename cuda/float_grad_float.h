@@ -3,8 +3,9 @@
 
 #include <type_traits>
 
+// Innermost scalar is float, so FloatGrad<FloatGrad<float>> also qualifies
 template <typename T>
-using is_float_type = std::is_same<std::decay_t<decltype(get_data(std::declval<T>()))>, float>;
+using is_float_type = std::is_same<float_grad_scalar_t<T>, float>;
 
 //////////////////////////////////////////////////////////////////////////////
 /// Additional builtin functions
@@ -15,65 +16,69 @@ using is_float_type = std::is_same<std::decay_t<decltype(get_data(std::declval<T
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 operator+(T x) {
-    return FloatGrad<float>(x);
+    return float_grad_result_t<float, T>(x);
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 operator-(T x) {
-    return FloatGrad<float>(-get_data(x), -get_grad(x));
+    return float_grad_result_t<float, T>(-get_data(x), -get_grad(x));
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 fabs(T x) {
-    return x >= 0.0f ? FloatGrad<float>(x) : FloatGrad<float>(-x);
+    using Result = float_grad_result_t<float, T>;
+    return x >= 0.0f ? Result(x) : Result(-x);
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 sqrtf(T a) {
-    float data = sqrtf(get_data(a));
-    float grad = get_grad(a) / (2.0f * data);
-    return FloatGrad<float>(data, grad);
+    auto data = sqrtf(get_data(a));
+    auto grad = get_grad(a) / (2.0f * data);
+    return float_grad_result_t<float, T>(data, grad);
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 floorf(T x) {
-    return FloatGrad<float>(floorf(get_data(x)), 0.0f);
+    using Result = float_grad_result_t<float, T>;
+    return Result(floorf(get_data(x)), typename Result::GradType{});
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 ceilf(T x) {
-    return FloatGrad<float>(ceilf(get_data(x)), 0.0f);
+    using Result = float_grad_result_t<float, T>;
+    return Result(ceilf(get_data(x)), typename Result::GradType{});
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 roundf(T x) {
-    return FloatGrad<float>(roundf(get_data(x)), 0.0f);
+    using Result = float_grad_result_t<float, T>;
+    return Result(roundf(get_data(x)), typename Result::GradType{});
 }
 
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 truncf(T x) {
     return x >= 0.0f ? floorf(x) : ceilf(x);
 }
@@ -81,7 +86,8 @@ truncf(T x) {
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float_type<T1>::value && is_float_type<T2>::value
-                 && (is_float_grad<T1>::value || is_float_grad<T2>::value), FloatGrad<float>>
+                 && (is_float_grad<T1>::value || is_float_grad<T2>::value),
+                 float_grad_result_t<float, T1, T2>>
 fmodf(const T1 x, const T2 y) {
     return x - y * truncf(x / y);
 }
@@ -89,11 +95,203 @@ fmodf(const T1 x, const T2 y) {
 template <typename T>
 __host__ __device__
 inline std::enable_if_t<is_float_type<T>::value
-                        && is_float_grad<T>::value, FloatGrad<float>>
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
 expf(T x) {
-    float data = expf(get_data(x));
-    float grad = data * get_grad(x);
-    return FloatGrad<float>(data, grad);
+    auto data = expf(get_data(x));
+    auto grad = data * get_grad(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+logf(T x) {
+    auto data = logf(get_data(x));
+    auto grad = get_grad(x) / get_data(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+log1pf(T x) {
+    auto data = log1pf(get_data(x));
+    auto grad = get_grad(x) / (1.0f + get_data(x));
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+namespace float_grad_detail {
+
+// sincosf is a CUDA and glibc extension, elsewhere use sinf and cosf
+inline __host__ __device__
+void sincos_primal(float x, float* s, float* c) {
+#if defined(__CUDACC__) || (defined(__GLIBC__) && defined(_GNU_SOURCE))
+    ::sincosf(x, s, c);
+#else
+    *s = ::sinf(x);
+    *c = ::cosf(x);
+#endif
+}
+
+// Primals of nested duals are duals themselves
+template <typename T>
+inline __host__ __device__
+void sincos_primal(const T& x, T* s, T* c) {
+    sincosf(x, s, c);
+}
+
+} // namespace float_grad_detail
+
+// sin and cos from one sincosf of the primal; each is the other's derivative
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value && is_float_grad<T>::value>
+sincosf(T x, float_grad_result_t<float, T>* s, float_grad_result_t<float, T>* c) {
+    using Result = float_grad_result_t<float, T>;
+    float_grad_primal_t<Result> sin_data, cos_data;
+    float_grad_detail::sincos_primal(get_data(x), &sin_data, &cos_data);
+    *s = Result(sin_data, cos_data * get_grad(x));
+    *c = Result(cos_data, -sin_data * get_grad(x));
+}
+
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+sinf(T x) {
+    float_grad_result_t<float, T> s, c;
+    sincosf(x, &s, &c);
+    return s;
+}
+
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+cosf(T x) {
+    float_grad_result_t<float, T> s, c;
+    sincosf(x, &s, &c);
+    return c;
+}
+
+// tan' = 1 + tan^2
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+tanf(T x) {
+    auto data = tanf(get_data(x));
+    auto grad = (1.0f + data * data) * get_grad(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+// tanh' = 1 - tanh^2
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+tanhf(T x) {
+    auto data = tanhf(get_data(x));
+    auto grad = (1.0f - data * data) * get_grad(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+__host__ __device__
+inline float sigmoid(float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+// sigmoid' = sigmoid (1 - sigmoid)
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+sigmoid(T x) {
+    auto data = sigmoid(get_data(x));
+    auto grad = (data - data * data) * get_grad(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+// erf' = 2 / sqrt(pi) exp(-x^2)
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+erff(T x) {
+    auto data = erff(get_data(x));
+    auto grad = 1.12837917f * expf(-get_data(x) * get_data(x)) * get_grad(x);
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+// acos' = -1 / sqrt((1 - x) (1 + x))
+template <typename T>
+__host__ __device__
+inline std::enable_if_t<is_float_type<T>::value
+                        && is_float_grad<T>::value, float_grad_result_t<float, T>>
+acosf(T x) {
+    auto data = acosf(get_data(x));
+    auto grad = -get_grad(x) / sqrtf((1.0f - get_data(x)) * (1.0f + get_data(x)));
+    return float_grad_result_t<float, T>(data, grad);
+}
+
+// d(x^y) = y x^y / x dx + x^y log(x) dy, reusing x^y away from x = 0. As in
+// torch, the dy term is 0 at x = 0 for y >= 0 rather than 0 * -inf = NaN
+template <typename T1, typename T2>
+inline __host__ __device__
+std::enable_if_t<is_float_type<T1>::value && is_float_type<T2>::value
+                 && (is_float_grad<T1>::value || is_float_grad<T2>::value),
+                 float_grad_result_t<float, T1, T2>>
+powf(const T1& a, const T2& b) {
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    const auto x = get_data_at<D>(a);
+    const auto y = get_data_at<D>(b);
+    auto data = powf(x, y);
+    using DataType = decltype(data);
+    tangent_t<DataType, N> grad;
+    if constexpr (has_tangent_at<T1, D>) {
+        const DataType dx = x != 0.0f ? DataType(y * data / x) : DataType(y * powf(x, y - 1.0f));
+        grad = dx * get_grad_at<D>(a);
+    }
+    if constexpr (has_tangent_at<T2, D>) {
+        const DataType dy = x == 0.0f && y >= 0.0f ? DataType(0.0f) : DataType(data * logf(x));
+        if constexpr (has_tangent_at<T1, D>) {
+            grad += dy * get_grad_at<D>(b);
+        } else {
+            grad = dy * get_grad_at<D>(b);
+        }
+    }
+    return FloatGrad<DataType, N>(data, grad);
+}
+
+// d atan2(y, x) = (x dy - y dx) / (x^2 + y^2)
+template <typename T1, typename T2>
+inline __host__ __device__
+std::enable_if_t<is_float_type<T1>::value && is_float_type<T2>::value
+                 && (is_float_grad<T1>::value || is_float_grad<T2>::value),
+                 float_grad_result_t<float, T1, T2>>
+atan2f(const T1& a, const T2& b) {
+    constexpr int D = float_grad_depth_v<T1, T2>;
+    constexpr int N = num_tangents_v<T1, T2>;
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    const auto y = get_data_at<D>(a);
+    const auto x = get_data_at<D>(b);
+    auto data = atan2f(y, x);
+    const auto r2 = x * x + y * y;
+    tangent_t<decltype(data), N> grad;
+    if constexpr (has_tangent_at<T1, D> && has_tangent_at<T2, D>) {
+        grad = (x * get_grad_at<D>(a) - y * get_grad_at<D>(b)) / r2;
+    } else if constexpr (has_tangent_at<T1, D>) {
+        grad = x * get_grad_at<D>(a) / r2;
+    } else if constexpr (has_tangent_at<T2, D>) {
+        grad = -y * get_grad_at<D>(b) / r2;
+    }
+    return FloatGrad<decltype(data), N>(data, grad);
 }
 
 #endif // FLOAT_GRAD_FLOAT_H
@@ -1,20 +1,20 @@
 #ifndef FLOAT_GRAD_FLOAT2_H
 #define FLOAT_GRAD_FLOAT2_H
 
-// Specialization for get_grad
+// Specialization for get_grad. Plain vectors are passive
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<float2>(const float2& v) {
-    return float2{0.0f, 0.0f};
+decltype(auto) get_grad<float2>(const float2&) {
+    return ZeroTangent{};
 }
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<const float2>(const float2& v) {
-    return float2{0.0f, 0.0f};
+decltype(auto) get_grad<const float2>(const float2&) {
+    return ZeroTangent{};
 }
 
 template <typename T>
-using is_float2_type = std::is_same<std::decay_t<decltype(get_data(std::declval<T>()))>, float2>;
+using is_float2_type = std::is_same<float_grad_scalar_t<T>, float2>;
 
 template <>
 struct FloatGradRef<float2> : FloatGradRefBase<float2> {
@@ -22,9 +22,10 @@ struct FloatGradRef<float2> : FloatGradRefBase<float2> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<float2>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y) {}
+    : FloatGradRefBase<float2>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
 
     // All assignment operators
     template <typename OtherType>
@@ -34,8 +35,23 @@ struct FloatGradRef<float2> : FloatGradRefBase<float2> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
 };
 
 template <>
@@ -44,9 +60,7 @@ struct FloatGrad<float2> : FloatGradBase<float2> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<float2>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y) {}
+    : FloatGradBase<float2>(std::forward<Args>(args)...) {}
 
     // All assignment operators
     template <typename OtherType>
@@ -56,8 +70,23 @@ struct FloatGrad<float2> : FloatGradBase<float2> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
 };
 
 template <>
@@ -65,12 +94,20 @@ struct FloatGradRef<const float2> : FloatGradRefBase<const float2> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<const float2>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y) {}
+    : FloatGradRefBase<const float2>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
 
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
 };
 
 template <>
@@ -78,23 +115,137 @@ struct FloatGrad<const float2> : FloatGradBase<const float2> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<const float2>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y) {}
+    : FloatGradBase<const float2>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+};
+
+/// Multi-tangent specializations. The tangent lanes of a component are
+/// strided by the vector width, so components are returned by value.
+
+template <int N>
+struct FloatGradRef<float2, N> : FloatGradRefBase<float2, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<float2, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    template <typename OtherType>
+    __host__ __device__
+    FloatGradRef& operator=(const OtherType& other) {
+        FloatGradRefBase<float2, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float2::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float2::y));
+    }
+};
+
+template <int N>
+struct FloatGrad<float2, N> : FloatGradBase<float2, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<float2, N>(std::forward<Args>(args)...) {}
 
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
+    template <typename OtherType>
+    __host__ __device__
+    FloatGrad& operator=(const OtherType& other) {
+        FloatGradBase<float2, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float2::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float2::y));
+    }
 };
 
+template <int N>
+struct FloatGradRef<const float2, N> : FloatGradRefBase<const float2, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<const float2, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float2::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float2::y));
+    }
+};
+
+template <int N>
+struct FloatGrad<const float2, N> : FloatGradBase<const float2, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<const float2, N>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float2::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float2::y));
+    }
+};
+
+static_assert(sizeof(FloatGrad<float2>) == 2 * sizeof(float2),
+              "FloatGrad<float2> must only hold its data and grad");
+static_assert(sizeof(FloatGrad<const float2>) == 2 * sizeof(float2),
+              "FloatGrad<const float2> must only hold its data and grad");
+static_assert(std::is_trivially_copyable_v<FloatGrad<float2>>
+              && std::is_trivially_copyable_v<FloatGrad<const float2>>
+              && std::is_trivially_copyable_v<FloatGradRef<float2>>
+              && std::is_trivially_copyable_v<FloatGradRef<const float2>>,
+              "float2 dual types must be trivially copyable");
+static_assert(std::is_standard_layout_v<FloatGrad<float2>>
+              && std::is_standard_layout_v<FloatGradRef<float2>>,
+              "float2 dual types must be standard layout");
+
 template <typename T1, typename T2,
           typename = std::enable_if_t<is_float_type<T1>::value
                                       && is_float_type<T2>::value
                                       && (is_float_grad<T1>::value 
                                          || is_float_grad<T2>::value)>>
 __host__ __device__
-inline FloatGrad<float2> make_float2(const T1& x, const T2& y) {
-    return FloatGrad<float2>(float2{get_data(x), get_data(y)}, 
-                             float2{get_grad(x), get_grad(y)});
+inline float_grad_result_t<float2, T1, T2>
+make_float2(const T1& x, const T2& y) {
+    // The constructor gathers the component primals and tangents
+    return float_grad_result_t<float2, T1, T2>(x, y);
 }
 
 #endif // FLOAT_GRAD_FLOAT2_H
@@ -1,20 +1,20 @@
 #ifndef FLOAT_GRAD_FLOAT3_H
 #define FLOAT_GRAD_FLOAT3_H
 
-// Specialization for get_grad
+// Specialization for get_grad. Plain vectors are passive
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<float3>(const float3& v) {
-    return float3{0.0f, 0.0f, 0.0f};
+decltype(auto) get_grad<float3>(const float3&) {
+    return ZeroTangent{};
 }
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<const float3>(const float3& v) {
-    return float3{0.0f, 0.0f, 0.0f};
+decltype(auto) get_grad<const float3>(const float3&) {
+    return ZeroTangent{};
 }
 
 template <typename T>
-using is_float3_type = std::is_same<std::decay_t<decltype(get_data(std::declval<T>()))>, float3>;
+using is_float3_type = std::is_same<float_grad_scalar_t<T>, float3>;
 
 template <>
 struct FloatGradRef<float3> : FloatGradRefBase<float3> {
@@ -22,10 +22,10 @@ struct FloatGradRef<float3> : FloatGradRefBase<float3> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<float3>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z) {}
+    : FloatGradRefBase<float3>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
 
     // All assignment operators
     template <typename OtherType>
@@ -35,9 +35,31 @@ struct FloatGradRef<float3> : FloatGradRefBase<float3> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
-    FloatGradRef<float> z;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<float> z() {
+        return FloatGradRef<float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
 };
 
 template <>
@@ -46,10 +68,7 @@ struct FloatGrad<float3> : FloatGradBase<float3> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<float3>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z) {}
+    : FloatGradBase<float3>(std::forward<Args>(args)...) {}
 
     // All assignment operators
     template <typename OtherType>
@@ -59,9 +78,31 @@ struct FloatGrad<float3> : FloatGradBase<float3> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
-    FloatGradRef<float> z;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<float> z() {
+        return FloatGradRef<float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
 };
 
 template <>
@@ -69,14 +110,24 @@ struct FloatGradRef<const float3> : FloatGradRefBase<const float3> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<const float3>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z) {}
-
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
-    FloatGradRef<const float> z;
+    : FloatGradRefBase<const float3>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
 };
 
 template <>
@@ -84,16 +135,147 @@ struct FloatGrad<const float3> : FloatGradBase<const float3> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<const float3>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z) {}
-
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
-    FloatGradRef<const float> z;
+    : FloatGradBase<const float3>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
+};
+
+/// Multi-tangent specializations. The tangent lanes of a component are
+/// strided by the vector width, so components are returned by value.
+
+template <int N>
+struct FloatGradRef<float3, N> : FloatGradRefBase<float3, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<float3, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    template <typename OtherType>
+    __host__ __device__
+    FloatGradRef& operator=(const OtherType& other) {
+        FloatGradRefBase<float3, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float3::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float3::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float3::z));
+    }
+};
+
+template <int N>
+struct FloatGrad<float3, N> : FloatGradBase<float3, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<float3, N>(std::forward<Args>(args)...) {}
+
+    template <typename OtherType>
+    __host__ __device__
+    FloatGrad& operator=(const OtherType& other) {
+        FloatGradBase<float3, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float3::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float3::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float3::z));
+    }
+};
+
+template <int N>
+struct FloatGradRef<const float3, N> : FloatGradRefBase<const float3, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<const float3, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float3::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float3::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float3::z));
+    }
+};
+
+template <int N>
+struct FloatGrad<const float3, N> : FloatGradBase<const float3, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<const float3, N>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float3::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float3::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float3::z));
+    }
 };
 
+static_assert(sizeof(FloatGrad<float3>) == 2 * sizeof(float3),
+              "FloatGrad<float3> must only hold its data and grad");
+static_assert(sizeof(FloatGrad<const float3>) == 2 * sizeof(float3),
+              "FloatGrad<const float3> must only hold its data and grad");
+static_assert(std::is_trivially_copyable_v<FloatGrad<float3>>
+              && std::is_trivially_copyable_v<FloatGrad<const float3>>
+              && std::is_trivially_copyable_v<FloatGradRef<float3>>
+              && std::is_trivially_copyable_v<FloatGradRef<const float3>>,
+              "float3 dual types must be trivially copyable");
+static_assert(std::is_standard_layout_v<FloatGrad<float3>>
+              && std::is_standard_layout_v<FloatGradRef<float3>>,
+              "float3 dual types must be standard layout");
+
 template <typename T1, typename T2, typename T3,
           typename = std::enable_if_t<is_float_type<T1>::value
                                       && is_float_type<T2>::value
@@ -102,9 +284,10 @@ template <typename T1, typename T2, typename T3,
                                           || is_float_grad<T2>::value
                                           || is_float_grad<T3>::value)>>
 __host__ __device__
-inline FloatGrad<float3> make_float3(const T1& x, const T2& y, const T3& z) {
-    return FloatGrad<float3>(float3{get_data(x), get_data(y), get_data(z)}, 
-                             float3{get_grad(x), get_grad(y), get_grad(z)});
+inline float_grad_result_t<float3, T1, T2, T3>
+make_float3(const T1& x, const T2& y, const T3& z) {
+    // The constructor gathers the component primals and tangents
+    return float_grad_result_t<float3, T1, T2, T3>(x, y, z);
 }
 
 #endif // FLOAT_GRAD_FLOAT3_H
@@ -1,20 +1,20 @@
 #ifndef FLOAT_GRAD_FLOAT4_H
 #define FLOAT_GRAD_FLOAT4_H
 
-// Specialization for get_grad
+// Specialization for get_grad. Plain vectors are passive
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<float4>(const float4& v) {
-    return float4{0.0f, 0.0f, 0.0f, 0.0f};
+decltype(auto) get_grad<float4>(const float4&) {
+    return ZeroTangent{};
 }
 template <>
 inline __host__ __device__
-decltype(auto) get_grad<const float4>(const float4& v) {
-    return float4{0.0f, 0.0f, 0.0f, 0.0f};
+decltype(auto) get_grad<const float4>(const float4&) {
+    return ZeroTangent{};
 }
 
 template <typename T>
-using is_float4_type = std::is_same<std::decay_t<decltype(get_data(std::declval<T>()))>, float4>;
+using is_float4_type = std::is_same<float_grad_scalar_t<T>, float4>;
 
 template <>
 struct FloatGradRef<float4> : FloatGradRefBase<float4> {
@@ -22,11 +22,10 @@ struct FloatGradRef<float4> : FloatGradRefBase<float4> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<float4>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z),
-      w(&data().w, &grad().w) {}
+    : FloatGradRefBase<float4>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
 
     // All assignment operators
     template <typename OtherType>
@@ -36,10 +35,39 @@ struct FloatGradRef<float4> : FloatGradRefBase<float4> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
-    FloatGradRef<float> z;
-    FloatGradRef<float> w;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<float> z() {
+        return FloatGradRef<float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<float> w() {
+        return FloatGradRef<float>(&data().w, &grad().w);
+    }
+    __host__ __device__
+    FloatGradRef<const float> w() const {
+        return FloatGradRef<const float>(&data().w, &grad().w);
+    }
 };
 
 template <>
@@ -48,11 +76,7 @@ struct FloatGrad<float4> : FloatGradBase<float4> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<float4>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z),
-      w(&data().w, &grad().w) {}
+    : FloatGradBase<float4>(std::forward<Args>(args)...) {}
 
     // All assignment operators
     template <typename OtherType>
@@ -62,10 +86,39 @@ struct FloatGrad<float4> : FloatGradBase<float4> {
         return *this;
     }
 
-    FloatGradRef<float> x;
-    FloatGradRef<float> y;
-    FloatGradRef<float> z;
-    FloatGradRef<float> w;
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<float> x() {
+        return FloatGradRef<float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<float> y() {
+        return FloatGradRef<float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<float> z() {
+        return FloatGradRef<float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<float> w() {
+        return FloatGradRef<float>(&data().w, &grad().w);
+    }
+    __host__ __device__
+    FloatGradRef<const float> w() const {
+        return FloatGradRef<const float>(&data().w, &grad().w);
+    }
 };
 
 template <>
@@ -73,16 +126,28 @@ struct FloatGradRef<const float4> : FloatGradRefBase<const float4> {
     template <typename... Args>
     __host__ __device__
     FloatGradRef(Args&&... args)
-    : FloatGradRefBase<const float4>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z),
-      w(&data().w, &grad().w) {}
-
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
-    FloatGradRef<const float> z;
-    FloatGradRef<const float> w;
+    : FloatGradRefBase<const float4>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> w() const {
+        return FloatGradRef<const float>(&data().w, &grad().w);
+    }
 };
 
 template <>
@@ -90,18 +155,167 @@ struct FloatGrad<const float4> : FloatGradBase<const float4> {
     template <typename... Args>
     __host__ __device__
     FloatGrad(Args&&... args)
-    : FloatGradBase<const float4>(std::forward<Args>(args)...),
-      x(&data().x, &grad().x), 
-      y(&data().y, &grad().y),
-      z(&data().z, &grad().z),
-      w(&data().w, &grad().w) {}
-
-    FloatGradRef<const float> x;
-    FloatGradRef<const float> y;
-    FloatGradRef<const float> z;
-    FloatGradRef<const float> w;
+    : FloatGradBase<const float4>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGradRef<const float> x() const {
+        return FloatGradRef<const float>(&data().x, &grad().x);
+    }
+    __host__ __device__
+    FloatGradRef<const float> y() const {
+        return FloatGradRef<const float>(&data().y, &grad().y);
+    }
+    __host__ __device__
+    FloatGradRef<const float> z() const {
+        return FloatGradRef<const float>(&data().z, &grad().z);
+    }
+    __host__ __device__
+    FloatGradRef<const float> w() const {
+        return FloatGradRef<const float>(&data().w, &grad().w);
+    }
+};
+
+/// Multi-tangent specializations. The tangent lanes of a component are
+/// strided by the vector width, so components are returned by value.
+
+template <int N>
+struct FloatGradRef<float4, N> : FloatGradRefBase<float4, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<float4, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    template <typename OtherType>
+    __host__ __device__
+    FloatGradRef& operator=(const OtherType& other) {
+        FloatGradRefBase<float4, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float4::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float4::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float4::z));
+    }
+    __host__ __device__
+    FloatGrad<float, N> w() const {
+        return FloatGrad<float, N>(this->data().w, tangent_component(this->grad(), &float4::w));
+    }
+};
+
+template <int N>
+struct FloatGrad<float4, N> : FloatGradBase<float4, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<float4, N>(std::forward<Args>(args)...) {}
+
+    template <typename OtherType>
+    __host__ __device__
+    FloatGrad& operator=(const OtherType& other) {
+        FloatGradBase<float4, N>::operator=(other);
+        return *this;
+    }
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float4::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float4::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float4::z));
+    }
+    __host__ __device__
+    FloatGrad<float, N> w() const {
+        return FloatGrad<float, N>(this->data().w, tangent_component(this->grad(), &float4::w));
+    }
+};
+
+template <int N>
+struct FloatGradRef<const float4, N> : FloatGradRefBase<const float4, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGradRef(Args&&... args)
+    : FloatGradRefBase<const float4, N>(std::forward<Args>(args)...) {}
+
+    FloatGradRef(const FloatGradRef& other) = default;
+    FloatGradRef& operator=(const volatile FloatGradRef&) = delete;
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float4::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float4::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float4::z));
+    }
+    __host__ __device__
+    FloatGrad<float, N> w() const {
+        return FloatGrad<float, N>(this->data().w, tangent_component(this->grad(), &float4::w));
+    }
+};
+
+template <int N>
+struct FloatGrad<const float4, N> : FloatGradBase<const float4, N> {
+    template <typename... Args>
+    __host__ __device__
+    FloatGrad(Args&&... args)
+    : FloatGradBase<const float4, N>(std::forward<Args>(args)...) {}
+
+    // Component accessors
+    __host__ __device__
+    FloatGrad<float, N> x() const {
+        return FloatGrad<float, N>(this->data().x, tangent_component(this->grad(), &float4::x));
+    }
+    __host__ __device__
+    FloatGrad<float, N> y() const {
+        return FloatGrad<float, N>(this->data().y, tangent_component(this->grad(), &float4::y));
+    }
+    __host__ __device__
+    FloatGrad<float, N> z() const {
+        return FloatGrad<float, N>(this->data().z, tangent_component(this->grad(), &float4::z));
+    }
+    __host__ __device__
+    FloatGrad<float, N> w() const {
+        return FloatGrad<float, N>(this->data().w, tangent_component(this->grad(), &float4::w));
+    }
 };
 
+static_assert(sizeof(FloatGrad<float4>) == 2 * sizeof(float4),
+              "FloatGrad<float4> must only hold its data and grad");
+static_assert(sizeof(FloatGrad<const float4>) == 2 * sizeof(float4),
+              "FloatGrad<const float4> must only hold its data and grad");
+static_assert(std::is_trivially_copyable_v<FloatGrad<float4>>
+              && std::is_trivially_copyable_v<FloatGrad<const float4>>
+              && std::is_trivially_copyable_v<FloatGradRef<float4>>
+              && std::is_trivially_copyable_v<FloatGradRef<const float4>>,
+              "float4 dual types must be trivially copyable");
+static_assert(std::is_standard_layout_v<FloatGrad<float4>>
+              && std::is_standard_layout_v<FloatGradRef<float4>>,
+              "float4 dual types must be standard layout");
+
 template <typename T1, typename T2, typename T3, typename T4,
           typename = std::enable_if_t<is_float_type<T1>::value
                                       && is_float_type<T2>::value
@@ -112,9 +326,10 @@ template <typename T1, typename T2, typename T3, typename T4,
                                           || is_float_grad<T3>::value
                                           || is_float_grad<T4>::value)>>
 __host__ __device__
-inline FloatGrad<float4> make_float4(const T1& x, const T2& y, const T3& z, const T4& w) {
-    return FloatGrad<float4>(float4{get_data(x), get_data(y), get_data(z), get_data(w)}, 
-                             float4{get_grad(x), get_grad(y), get_grad(z), get_grad(w)});
+inline float_grad_result_t<float4, T1, T2, T3, T4>
+make_float4(const T1& x, const T2& y, const T3& z, const T4& w) {
+    // The constructor gathers the component primals and tangents
+    return float_grad_result_t<float4, T1, T2, T3, T4>(x, y, z, w);
 }
 
 #endif // FLOAT_GRAD_FLOAT4_H
@@ -0,0 +1,423 @@
+#ifndef FLOAT_GRAD_GEMM_H
+#define FLOAT_GRAD_GEMM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "float_grad_base.h"
+#include "float_grad_tensor.h"
+#include "float_grad_simd.h"
+#include "float_grad_parallel.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Host matrix product of dual matrices, C = A B with the tangent
+/// dC = dA B + A dB, computed in one sweep. The structure is the usual
+/// packed, cache-blocked GEMM: panels of B and blocks of A are copied into
+/// contiguous slivers, and a register-tiled micro-kernel accumulates an
+/// MR x NR tile of C and of dC from the same packed panels, so every
+/// primal loaded feeds both the primal and the tangent product.
+///
+///     gemm_jvp(C, A, B);        // FloatGradTensor views of [M, N], [M, K], [K, N]
+///     gemm_jvp(C, A, B, pool);  // blocks of C stolen by the threads of a ThreadPool
+///     gemm_jvp(C, A, B, true);  // C += A B, dC += dA B + A dB
+///
+/// The views may have any strides. A or B without a tangent plane is
+/// passive and its tangent terms are skipped; C without one gets only the
+/// primal product, which makes gemm_jvp a plain sgemm.
+//////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+// Register tile of the micro-kernel: mr rows by nv vectors of columns, with
+// 2 mr nv accumulators for the primal and tangent
+template <typename V>
+struct GemmTile {
+    static constexpr int mr = V::width == 16 ? 6 : 4;
+    static constexpr int nv = V::width == 16 ? 2 : V::width == 8 ? 1 : 4;
+    static constexpr int nr = nv * V::width;
+};
+
+// Block sizes: an mc x kc block of both A planes stays in L2 and a kc x nc
+// panel of both B planes in L3. A longer kc amortizes the tile updates of C
+// and measured faster than a kc x nr sliver of B that fits L1.
+constexpr int64_t gemm_kc = 256;
+constexpr int64_t gemm_mc = 192;
+constexpr int64_t gemm_nc = 3072;
+
+// Packing buffers for blocks of up to mc x kc of A and kc x nc of B,
+// reused across the blocks of one product. Each thread keeps its own set in
+// local(), grown to the largest blocks it has packed.
+template <typename V>
+struct GemmPacks {
+    float* a = nullptr;
+    float* da = nullptr;
+    float* b = nullptr;
+    float* db = nullptr;
+    size_t capacity = 0;
+
+    GemmPacks() = default;
+    GemmPacks(int64_t mc, int64_t kc, int64_t nc) { reserve(mc, kc, nc); }
+    GemmPacks(const GemmPacks&) = delete;
+    GemmPacks& operator=(const GemmPacks&) = delete;
+    ~GemmPacks() { std::free(a); }
+
+    void reserve(int64_t mc, int64_t kc, int64_t nc) {
+        // Slivers are padded to whole register tiles
+        mc = (mc + GemmTile<V>::mr - 1) / GemmTile<V>::mr * GemmTile<V>::mr;
+        nc = (nc + GemmTile<V>::nr - 1) / GemmTile<V>::nr * GemmTile<V>::nr;
+        const size_t a_size = (mc * kc * sizeof(float) + 63) / 64 * 64;
+        const size_t b_size = (kc * nc * sizeof(float) + 63) / 64 * 64;
+        if (2 * a_size + 2 * b_size > capacity) {
+            std::free(a);
+            capacity = 2 * a_size + 2 * b_size;
+            a = static_cast<float*>(std::aligned_alloc(64, capacity));
+        }
+        da = a + a_size / sizeof(float);
+        b = da + a_size / sizeof(float);
+        db = b + b_size / sizeof(float);
+    }
+
+    static GemmPacks& local(int64_t mc, int64_t kc, int64_t nc) {
+        thread_local GemmPacks packs;
+        packs.reserve(mc, kc, nc);
+        return packs;
+    }
+};
+
+// Rows [i0, i0 + mc) and columns [p0, p0 + kc) of a plane of A, as slivers
+// of MR rows stored column by column. Rows past the end are zero.
+template <int MR>
+inline void gemm_pack_a(const float* src, int64_t rs, int64_t cs, int64_t i0, int64_t mc,
+                        int64_t p0, int64_t kc, float* dst) {
+    for (int64_t s = 0; s < mc; s += MR, dst += MR * kc) {
+        const float* rows = src + (i0 + s) * rs + p0 * cs;
+        const int64_t m = std::min<int64_t>(MR, mc - s);
+        for (int64_t k = 0; k < kc; ++k) {
+            for (int r = 0; r < MR; ++r) {
+                dst[k * MR + r] = r < m ? rows[r * rs + k * cs] : 0.0f;
+            }
+        }
+    }
+}
+
+// Rows [p0, p0 + kc) and columns [j0, j0 + nc) of a plane of B, as slivers
+// of NR columns stored row by row. Columns past the end are zero.
+template <int NR>
+inline void gemm_pack_b(const float* src, int64_t rs, int64_t cs, int64_t p0, int64_t kc,
+                        int64_t j0, int64_t nc, float* dst) {
+    for (int64_t s = 0; s < nc; s += NR, dst += NR * kc) {
+        const float* cols = src + p0 * rs + (j0 + s) * cs;
+        const int64_t n = std::min<int64_t>(NR, nc - s);
+        if (n == NR && cs == 1) {
+            for (int64_t k = 0; k < kc; ++k) {
+                for (int j = 0; j < NR; ++j) {
+                    dst[k * NR + j] = cols[k * rs + j];
+                }
+            }
+        } else {
+            for (int64_t k = 0; k < kc; ++k) {
+                for (int j = 0; j < NR; ++j) {
+                    dst[k * NR + j] = j < n ? cols[k * rs + j * cs] : 0.0f;
+                }
+            }
+        }
+    }
+}
+
+// Primal and tangent accumulators of one tile
+template <typename V>
+struct GemmAcc {
+    V c[GemmTile<V>::mr][GemmTile<V>::nv];
+    V dc[GemmTile<V>::mr][GemmTile<V>::nv];
+};
+
+// Product of an MR x kc sliver of A and a kc x NR sliver of B, with
+// dc += da b where A is dual and dc += a db where B is dual
+template <typename V, bool DualA, bool DualB>
+inline void gemm_micro_kernel(int64_t kc, const float* pa, const float* pda,
+                              const float* pb, const float* pdb, GemmAcc<V>& acc) {
+    constexpr int MR = GemmTile<V>::mr;
+    constexpr int NV = GemmTile<V>::nv;
+    constexpr int NR = GemmTile<V>::nr;
+
+    // Local accumulators, which the compiler keeps in registers; acc could
+    // alias the packed panels
+    V c[MR][NV], dc[MR][NV];
+    for (int r = 0; r < MR; ++r) {
+        for (int v = 0; v < NV; ++v) {
+            c[r][v] = V::broadcast(0.0f);
+            dc[r][v] = V::broadcast(0.0f);
+        }
+    }
+    for (int64_t k = 0; k < kc; ++k) {
+        V b[NV], db[NV];
+        for (int v = 0; v < NV; ++v) {
+            b[v] = V::load(pb + k * NR + v * V::width);
+            if constexpr (DualB) {
+                db[v] = V::load(pdb + k * NR + v * V::width);
+            }
+        }
+        for (int r = 0; r < MR; ++r) {
+            const V a = V::broadcast(pa[k * MR + r]);
+            for (int v = 0; v < NV; ++v) {
+                c[r][v] = simd_fma(a, b[v], c[r][v]);
+                if constexpr (DualB) {
+                    dc[r][v] = simd_fma(a, db[v], dc[r][v]);
+                }
+            }
+            if constexpr (DualA) {
+                const V da = V::broadcast(pda[k * MR + r]);
+                for (int v = 0; v < NV; ++v) {
+                    dc[r][v] = simd_fma(da, b[v], dc[r][v]);
+                }
+            }
+        }
+    }
+    for (int r = 0; r < MR; ++r) {
+        for (int v = 0; v < NV; ++v) {
+            acc.c[r][v] = c[r][v];
+            acc.dc[r][v] = dc[r][v];
+        }
+    }
+}
+
+// How tiles are written to C: rows of contiguous planes, rows of
+// interleaved (primal, tangent) pairs, or element by element
+enum class GemmLayout { Planar, Interleaved, Strided };
+
+inline GemmLayout gemm_layout(const FloatGradTensor<float, 2>& C) {
+    if (C.data_stride(1) == 1 && (!C.has_grad() || C.grad_stride(1) == 1)) {
+        return GemmLayout::Planar;
+    }
+    if (C.has_grad() && C.data_stride(1) == 2 && C.grad_stride(1) == 2
+        && C.grad_ptr() == C.data_ptr() + 1 && C.grad_stride(0) == C.data_stride(0)) {
+        return GemmLayout::Interleaved;
+    }
+    return GemmLayout::Strided;
+}
+
+// Writes, or adds when accumulate is set, the rows x cols corner of a tile
+// to C at (i0, j0). The tangent is written only when Dual.
+template <typename V, bool Dual>
+inline void gemm_store_tile(const FloatGradTensor<float, 2>& C, GemmLayout layout,
+                            int64_t i0, int64_t j0, int64_t rows, int64_t cols,
+                            const GemmAcc<V>& acc, bool accumulate) {
+    constexpr int MR = GemmTile<V>::mr;
+    constexpr int NV = GemmTile<V>::nv;
+    constexpr int NR = GemmTile<V>::nr;
+    constexpr int W = V::width;
+
+    if (rows == MR && cols == NR && layout == GemmLayout::Planar) {
+        for (int r = 0; r < MR; ++r) {
+            float* c = &C.data(i0 + r, j0);
+            for (int v = 0; v < NV; ++v) {
+                const V x = accumulate ? V::load(c + v * W) + acc.c[r][v] : acc.c[r][v];
+                x.store(c + v * W);
+            }
+            if constexpr (Dual) {
+                float* dc = &C.grad(i0 + r, j0);
+                for (int v = 0; v < NV; ++v) {
+                    const V x = accumulate ? V::load(dc + v * W) + acc.dc[r][v] : acc.dc[r][v];
+                    x.store(dc + v * W);
+                }
+            }
+        }
+    } else if (rows == MR && cols == NR && layout == GemmLayout::Interleaved) {
+        for (int r = 0; r < MR; ++r) {
+            float* pairs = &C.data(i0 + r, j0);
+            for (int v = 0; v < NV; ++v) {
+                V d = acc.c[r][v];
+                V g = Dual ? acc.dc[r][v] : V::broadcast(0.0f);
+                if (accumulate || !Dual) {
+                    V d0, g0;
+                    simd_load_pairs(pairs + 2 * v * W, d0, g0);
+                    d = accumulate ? d0 + d : d;
+                    g = Dual ? g0 + g : g0;
+                }
+                simd_store_pairs(pairs + 2 * v * W, d, g);
+            }
+        }
+    } else {
+        alignas(64) float c[MR * NR];
+        alignas(64) float dc[MR * NR];
+        for (int r = 0; r < MR; ++r) {
+            for (int v = 0; v < NV; ++v) {
+                acc.c[r][v].store(c + r * NR + v * W);
+                if constexpr (Dual) {
+                    acc.dc[r][v].store(dc + r * NR + v * W);
+                }
+            }
+        }
+        for (int64_t r = 0; r < rows; ++r) {
+            for (int64_t j = 0; j < cols; ++j) {
+                float& x = C.data(i0 + r, j0 + j);
+                x = accumulate ? x + c[r * NR + j] : c[r * NR + j];
+                if constexpr (Dual) {
+                    float& dx = C.grad(i0 + r, j0 + j);
+                    dx = accumulate ? dx + dc[r * NR + j] : dc[r * NR + j];
+                }
+            }
+        }
+    }
+}
+
+// Rows [i0, i1) and columns [j0, j1) of C over the full depth of A and B
+template <typename V, bool DualA, bool DualB>
+inline void gemm_jvp_block(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                           const FloatGradTensor<const float, 2>& B, int64_t i0, int64_t i1,
+                           int64_t j0, int64_t j1, GemmPacks<V>& packs, bool accumulate) {
+    constexpr int MR = GemmTile<V>::mr;
+    constexpr int NR = GemmTile<V>::nr;
+    constexpr bool Dual = DualA || DualB;
+    const int64_t K = A.size(1);
+    const GemmLayout layout = gemm_layout(C);
+
+    for (int64_t jc = j0; jc < j1; jc += gemm_nc) {
+        const int64_t nc = std::min(gemm_nc, j1 - jc);
+        for (int64_t pc = 0; pc < K; pc += gemm_kc) {
+            const int64_t kc = std::min(gemm_kc, K - pc);
+            gemm_pack_b<NR>(B.data_ptr(), B.data_stride(0), B.data_stride(1), pc, kc, jc, nc, packs.b);
+            if constexpr (DualB) {
+                gemm_pack_b<NR>(B.grad_ptr(), B.grad_stride(0), B.grad_stride(1), pc, kc, jc, nc, packs.db);
+            }
+            for (int64_t ic = i0; ic < i1; ic += gemm_mc) {
+                const int64_t mc = std::min(gemm_mc, i1 - ic);
+                gemm_pack_a<MR>(A.data_ptr(), A.data_stride(0), A.data_stride(1), ic, mc, pc, kc, packs.a);
+                if constexpr (DualA) {
+                    gemm_pack_a<MR>(A.grad_ptr(), A.grad_stride(0), A.grad_stride(1), ic, mc, pc, kc, packs.da);
+                }
+                for (int64_t jr = 0; jr < nc; jr += NR) {
+                    for (int64_t ir = 0; ir < mc; ir += MR) {
+                        GemmAcc<V> acc;
+                        gemm_micro_kernel<V, DualA, DualB>(kc, packs.a + ir * kc, packs.da + ir * kc,
+                                                           packs.b + jr * kc, packs.db + jr * kc, acc);
+                        gemm_store_tile<V, Dual>(C, layout, ic + ir, jc + jr,
+                                                 std::min<int64_t>(MR, mc - ir),
+                                                 std::min<int64_t>(NR, nc - jr), acc,
+                                                 accumulate || pc > 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Products below this many multiply-adds run on one thread, where waking
+// the pool would cost more than it saves
+constexpr int64_t gemm_parallel_min_work = int64_t(1) << 21;
+
+// Blocks of C per thread that gemm_jvp hands to the work-stealing
+// scheduler, so that threads finishing early take over blocks of slower ones
+constexpr int gemm_blocks_per_thread = 4;
+
+// Splits C into a grid of tm x tn blocks. Every block packs its rows of A
+// and its columns of B, so tm is the divisor of blocks that minimizes the
+// packed M / tm + N / tn.
+inline void gemm_block_grid(int64_t M, int64_t N, int blocks, int& tm, int& tn) {
+    tm = 1;
+    for (int d = 1; d <= blocks; ++d) {
+        if (blocks % d == 0 && M / d + N / (blocks / d) < M / tm + N / (blocks / tm)) {
+            tm = d;
+        }
+    }
+    tn = blocks / tm;
+}
+
+// Part p of parts of [0, n), split at multiples of unit
+inline void gemm_split(int64_t n, int64_t unit, int p, int parts, int64_t& begin, int64_t& end) {
+    const int64_t units = (n + unit - 1) / unit;
+    begin = std::min(n, units * p / parts * unit);
+    end = std::min(n, units * (p + 1) / parts * unit);
+}
+
+template <bool DualA, bool DualB>
+inline void gemm_jvp_dispatch(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                              const FloatGradTensor<const float, 2>& B, ThreadPool* pool,
+                              bool accumulate) {
+    using V = SimdVec;
+    const int64_t M = C.size(0);
+    const int64_t N = C.size(1);
+    const int64_t K = A.size(1);
+    auto block = [&](int64_t i0, int64_t i1, int64_t j0, int64_t j1) {
+        GemmPacks<V>& packs = GemmPacks<V>::local(std::min(gemm_mc, i1 - i0), std::min(gemm_kc, K),
+                                                  std::min(gemm_nc, j1 - j0));
+        gemm_jvp_block<V, DualA, DualB>(C, A, B, i0, i1, j0, j1, packs, accumulate);
+    };
+    if (pool == nullptr || pool->size() == 1 || M * N * K < gemm_parallel_min_work) {
+        block(0, M, 0, N);
+        return;
+    }
+    int tm, tn;
+    gemm_block_grid(M, N, pool->size() * gemm_blocks_per_thread, tm, tn);
+    parallel_for(*pool, int64_t(tm) * tn, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            int64_t i0, i1, j0, j1;
+            gemm_split(M, GemmTile<V>::mr, static_cast<int>(b / tn), tm, i0, i1);
+            gemm_split(N, GemmTile<V>::nr, static_cast<int>(b % tn), tn, j0, j1);
+            if (i0 < i1 && j0 < j1) {
+                block(i0, i1, j0, j1);
+            }
+        }
+    });
+}
+
+inline void gemm_jvp_impl(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                          const FloatGradTensor<const float, 2>& B, ThreadPool* pool,
+                          bool accumulate) {
+    const bool dual_a = C.has_grad() && A.has_grad();
+    const bool dual_b = C.has_grad() && B.has_grad();
+
+    // Terms that are zero leave an accumulated C as it is
+    if (accumulate && (A.size(1) == 0 || C.size(0) == 0 || C.size(1) == 0)) {
+        return;
+    }
+    if (C.has_grad() && !accumulate && (!(dual_a || dual_b) || A.size(1) == 0)) {
+        for (int64_t i = 0; i < C.size(0); ++i) {
+            for (int64_t j = 0; j < C.size(1); ++j) {
+                C.grad(i, j) = 0.0f;
+            }
+        }
+    }
+    if (A.size(1) == 0) {
+        for (int64_t i = 0; i < C.size(0); ++i) {
+            for (int64_t j = 0; j < C.size(1); ++j) {
+                C.data(i, j) = 0.0f;
+            }
+        }
+        return;
+    }
+    if (C.size(0) == 0 || C.size(1) == 0) {
+        return;
+    }
+
+    if (dual_a && dual_b) {
+        gemm_jvp_dispatch<true, true>(C, A, B, pool, accumulate);
+    } else if (dual_a) {
+        gemm_jvp_dispatch<true, false>(C, A, B, pool, accumulate);
+    } else if (dual_b) {
+        gemm_jvp_dispatch<false, true>(C, A, B, pool, accumulate);
+    } else {
+        gemm_jvp_dispatch<false, false>(C, A, B, pool, accumulate);
+    }
+}
+
+} // namespace float_grad_detail
+
+// C = A B and, if C has a tangent plane, dC = dA B + A dB. A is M x K, B is
+// K x N and C is M x N; C must not overlap A or B. With accumulate, the
+// products are added to C and dC instead.
+inline void gemm_jvp(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                     const FloatGradTensor<const float, 2>& B, bool accumulate = false) {
+    float_grad_detail::gemm_jvp_impl(C, A, B, nullptr, accumulate);
+}
+
+// Same product with large ones split into blocks of C, balanced over the
+// threads of pool
+inline void gemm_jvp(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                     const FloatGradTensor<const float, 2>& B, ThreadPool& pool,
+                     bool accumulate = false) {
+    float_grad_detail::gemm_jvp_impl(C, A, B, &pool, accumulate);
+}
+
+#endif // FLOAT_GRAD_GEMM_H
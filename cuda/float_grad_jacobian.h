@@ -0,0 +1,195 @@
+#ifndef FLOAT_GRAD_JACOBIAN_H
+#define FLOAT_GRAD_JACOBIAN_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "float_grad_base.h"
+#include "float_grad_array.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sparse Jacobian assembly with column compression (Curtis-Powell-Reid).
+/// Columns that never share a row are structurally orthogonal and can be
+/// seeded together in one forward pass, so a Jacobian with n columns needs
+/// one pass per color instead of one per column.
+///
+/// The function is a host callable
+///     void f(FloatGradArray<const float> x, FloatGradArray<float> y)
+/// that reads n inputs from x and writes m outputs to y.
+//////////////////////////////////////////////////////////////////////////////
+
+// Nonzero structure of an m x n Jacobian in CSR form
+struct JacobianSparsity {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> row_ptr;   // size rows + 1
+    std::vector<int> col_idx;   // size nnz, sorted within each row
+
+    JacobianSparsity() = default;
+
+    JacobianSparsity(int rows, int cols, std::vector<int> row_ptr, std::vector<int> col_idx)
+        : rows(rows), cols(cols), row_ptr(std::move(row_ptr)), col_idx(std::move(col_idx)) {
+        if (rows < 0 || cols < 0) {
+            throw std::invalid_argument("JacobianSparsity: negative dimensions");
+        }
+        if (static_cast<int>(this->row_ptr.size()) != rows + 1 || this->row_ptr[0] != 0
+            || this->row_ptr.back() != static_cast<int>(this->col_idx.size())) {
+            throw std::invalid_argument("JacobianSparsity: malformed CSR row pointers");
+        }
+        for (int i = 0; i < rows; ++i) {
+            if (this->row_ptr[i] > this->row_ptr[i + 1]) {
+                throw std::invalid_argument("JacobianSparsity: decreasing CSR row pointers");
+            }
+        }
+        for (int c : this->col_idx) {
+            if (c < 0 || c >= cols) {
+                throw std::invalid_argument("JacobianSparsity: column index out of range");
+            }
+        }
+    }
+
+    int nnz() const {
+        return static_cast<int>(col_idx.size());
+    }
+
+    // Banded pattern with `lower` sub- and `upper` super-diagonals
+    static JacobianSparsity banded(int rows, int cols, int lower, int upper) {
+        std::vector<int> row_ptr(1, 0);
+        std::vector<int> col_idx;
+        for (int i = 0; i < rows; ++i) {
+            for (int j = std::max(0, i - lower); j <= std::min(cols - 1, i + upper); ++j) {
+                col_idx.push_back(j);
+            }
+            row_ptr.push_back(static_cast<int>(col_idx.size()));
+        }
+        return JacobianSparsity(rows, cols, std::move(row_ptr), std::move(col_idx));
+    }
+};
+
+// Column grouping. Columns with the same color share a seed direction.
+struct JacobianColoring {
+    int num_colors = 0;
+    std::vector<int> color;     // size cols
+};
+
+// Greedy distance-2 coloring of the column intersection graph: two columns
+// conflict when they have a nonzero in a common row.
+inline JacobianColoring color_jacobian_columns(const JacobianSparsity& pattern) {
+    // Column-major view to find the rows touched by each column
+    std::vector<int> col_ptr(pattern.cols + 1, 0);
+    for (int c : pattern.col_idx) {
+        ++col_ptr[c + 1];
+    }
+    for (int j = 0; j < pattern.cols; ++j) {
+        col_ptr[j + 1] += col_ptr[j];
+    }
+    std::vector<int> row_idx(pattern.nnz());
+    std::vector<int> fill(col_ptr.begin(), col_ptr.end() - 1);
+    for (int i = 0; i < pattern.rows; ++i) {
+        for (int k = pattern.row_ptr[i]; k < pattern.row_ptr[i + 1]; ++k) {
+            row_idx[fill[pattern.col_idx[k]]++] = i;
+        }
+    }
+
+    JacobianColoring coloring;
+    coloring.color.assign(pattern.cols, -1);
+    // forbidden[c] == j marks color c as taken by a neighbour of column j
+    std::vector<int> forbidden;
+    for (int j = 0; j < pattern.cols; ++j) {
+        for (int k = col_ptr[j]; k < col_ptr[j + 1]; ++k) {
+            int i = row_idx[k];
+            for (int l = pattern.row_ptr[i]; l < pattern.row_ptr[i + 1]; ++l) {
+                int c = coloring.color[pattern.col_idx[l]];
+                if (c >= 0) {
+                    forbidden[c] = j;
+                }
+            }
+        }
+        int c = 0;
+        while (c < coloring.num_colors && forbidden[c] == j) {
+            ++c;
+        }
+        if (c == coloring.num_colors) {
+            ++coloring.num_colors;
+            forbidden.push_back(-1);
+        }
+        coloring.color[j] = c;
+    }
+    return coloring;
+}
+
+// Compressed forward passes. Calls `on_pass(color, y_grad)` with the output
+// tangents after seeding every column of `color`.
+template <typename Function, typename OnPass>
+inline void seed_jacobian_colors(Function&& f,
+                                 const std::vector<float>& x,
+                                 int m,
+                                 const JacobianColoring& coloring,
+                                 OnPass&& on_pass) {
+    const int n = static_cast<int>(x.size());
+    if (static_cast<int>(coloring.color.size()) != n) {
+        throw std::invalid_argument("seed_jacobian_colors: coloring does not match input size");
+    }
+    std::vector<float> x_grad(n);
+    std::vector<float> y_data(m);
+    std::vector<float> y_grad(m);
+
+    for (int c = 0; c < coloring.num_colors; ++c) {
+        for (int j = 0; j < n; ++j) {
+            x_grad[j] = coloring.color[j] == c ? 1.0f : 0.0f;
+        }
+        std::fill(y_grad.begin(), y_grad.end(), 0.0f);
+        f(FloatGradArray<const float>(x.data(), x_grad.data()),
+          FloatGradArray<float>(y_data.data(), y_grad.data()));
+        on_pass(c, y_grad);
+    }
+}
+
+// Jacobian values in the CSR layout of `pattern` (one value per col_idx entry)
+template <typename Function>
+inline std::vector<float> jacobian_csr(Function&& f,
+                                       const std::vector<float>& x,
+                                       const JacobianSparsity& pattern,
+                                       const JacobianColoring& coloring) {
+    if (static_cast<int>(x.size()) != pattern.cols) {
+        throw std::invalid_argument("jacobian_csr: input size does not match the pattern");
+    }
+    std::vector<float> values(pattern.nnz());
+    seed_jacobian_colors(f, x, pattern.rows, coloring,
+        [&](int c, const std::vector<float>& y_grad) {
+            for (int i = 0; i < pattern.rows; ++i) {
+                for (int k = pattern.row_ptr[i]; k < pattern.row_ptr[i + 1]; ++k) {
+                    if (coloring.color[pattern.col_idx[k]] == c) {
+                        values[k] = y_grad[i];
+                    }
+                }
+            }
+        });
+    return values;
+}
+
+template <typename Function>
+inline std::vector<float> jacobian_csr(Function&& f,
+                                       const std::vector<float>& x,
+                                       const JacobianSparsity& pattern) {
+    return jacobian_csr(f, x, pattern, color_jacobian_columns(pattern));
+}
+
+// Row-major dense m x n Jacobian. Entries outside the pattern are zero.
+template <typename Function>
+inline std::vector<float> jacobian_dense(Function&& f,
+                                         const std::vector<float>& x,
+                                         const JacobianSparsity& pattern) {
+    std::vector<float> values = jacobian_csr(f, x, pattern);
+    std::vector<float> dense(static_cast<size_t>(pattern.rows) * pattern.cols, 0.0f);
+    for (int i = 0; i < pattern.rows; ++i) {
+        for (int k = pattern.row_ptr[i]; k < pattern.row_ptr[i + 1]; ++k) {
+            dense[static_cast<size_t>(i) * pattern.cols + pattern.col_idx[k]] = values[k];
+        }
+    }
+    return dense;
+}
+
+#endif // FLOAT_GRAD_JACOBIAN_H
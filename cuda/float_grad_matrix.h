@@ -0,0 +1,521 @@
+#ifndef FLOAT_GRAD_MATRIX_H
+#define FLOAT_GRAD_MATRIX_H
+
+#include <type_traits>
+#include <utility>
+
+#include "helper_math.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Fixed-size 3 x 3 and 4 x 4 matrices and their duals. Matrices store their
+/// columns as float3 / float4, so a float4x4 is one 64-byte block aligned as
+/// a float4 (16 bytes), matrix-vector products are sums of scaled columns,
+/// and every kernel is unrolled at compile time into a few vector operations
+/// per column.
+///
+///     FloatGrad<float4x4> M = ...;
+///     FloatGrad<float4> y = M * make_float4(p, 1.0f);  // dy = dM p + M dp
+///     FloatGrad<float3x3> R = quat_to_rotation(q);
+///
+/// +, - and * on dual matrices go through the generic FloatGrad operators,
+/// which apply the product rule to the plain matrix operations below, so
+/// they work with any number of tangent lanes and with passive operands.
+/// transpose, determinant, inverse and quat_to_rotation have their own JVP
+/// rules.
+//////////////////////////////////////////////////////////////////////////////
+
+// Column-major: col[j] is column j, element (i, j) is component i of it
+struct float3x3 {
+    float3 col[3];
+};
+
+struct alignas(16) float4x4 {
+    float4 col[4];
+};
+
+// Specialization for get_grad. Plain matrices are passive
+template <>
+inline __host__ __device__
+decltype(auto) get_grad<float3x3>(const float3x3&) {
+    return ZeroTangent{};
+}
+template <>
+inline __host__ __device__
+decltype(auto) get_grad<const float3x3>(const float3x3&) {
+    return ZeroTangent{};
+}
+template <>
+inline __host__ __device__
+decltype(auto) get_grad<float4x4>(const float4x4&) {
+    return ZeroTangent{};
+}
+template <>
+inline __host__ __device__
+decltype(auto) get_grad<const float4x4>(const float4x4&) {
+    return ZeroTangent{};
+}
+
+template <typename T>
+using is_float3x3_type = std::is_same<float_grad_scalar_t<T>, float3x3>;
+
+template <typename T>
+using is_float4x4_type = std::is_same<float_grad_scalar_t<T>, float4x4>;
+
+template <typename T>
+using is_float_matrix_type = std::bool_constant<is_float3x3_type<T>::value
+                                                || is_float4x4_type<T>::value>;
+
+static_assert(sizeof(float3x3) == 9 * sizeof(float), "float3x3 must be 9 packed floats");
+static_assert(sizeof(float4x4) == 16 * sizeof(float) && alignof(float4x4) == 16,
+              "float4x4 must be 16 floats aligned as float4");
+static_assert(sizeof(FloatGrad<float4x4>) == 2 * sizeof(float4x4),
+              "FloatGrad<float4x4> must only hold its data and grad");
+static_assert(std::is_trivially_copyable_v<FloatGrad<float3x3>>
+              && std::is_trivially_copyable_v<FloatGrad<float4x4>>
+              && std::is_trivially_copyable_v<FloatGradRef<float3x3>>
+              && std::is_trivially_copyable_v<FloatGradRef<const float4x4>>,
+              "matrix dual types must be trivially copyable");
+
+namespace float_grad_detail {
+
+template <typename T>
+struct matrix_traits {
+    static constexpr int size = 0;
+};
+
+template <>
+struct matrix_traits<float3x3> {
+    static constexpr int size = 3;
+    using vector_type = float3;
+};
+
+template <>
+struct matrix_traits<float4x4> {
+    static constexpr int size = 4;
+    using vector_type = float4;
+};
+
+// Plain matrices, as opposed to their duals
+template <typename T>
+using is_plain_matrix = std::bool_constant<matrix_traits<std::decay_t<T>>::size != 0>;
+
+template <typename Function, int... I>
+__forceinline__ __host__ __device__
+void unroll_impl(Function& f, std::integer_sequence<int, I...>) {
+    (f(std::integral_constant<int, I>{}), ...);
+}
+
+// Calls f(std::integral_constant<int, i>{}) for i = 0 .. N - 1, expanded at
+// compile time so that column indices are constants on host and device
+template <int N, typename Function>
+__forceinline__ __host__ __device__
+void unroll(Function&& f) {
+    unroll_impl(f, std::make_integer_sequence<int, N>{});
+}
+
+// Applies f to every tangent lane of a dual, keeping passive tangents zero
+template <typename Grad, typename Function>
+__forceinline__ __host__ __device__
+auto map_tangent_lanes(const Grad& grad, Function&& f) {
+    if constexpr (is_zero_tangent<Grad>::value) {
+        return ZeroTangent{};
+    } else if constexpr (is_float_tangents<Grad>::value) {
+        FloatTangents<std::decay_t<decltype(f(grad[0]))>, Grad::size> r;
+        for (int i = 0; i < Grad::size; ++i) {
+            r[i] = f(grad[i]);
+        }
+        return r;
+    } else {
+        return f(grad);
+    }
+}
+
+// Same over two tangents of the same number of lanes
+template <typename Grad1, typename Grad2, typename Function>
+__forceinline__ __host__ __device__
+auto map_tangent_lanes(const Grad1& a, const Grad2& b, Function&& f) {
+    if constexpr (is_float_tangents<Grad1>::value) {
+        FloatTangents<std::decay_t<decltype(f(a[0], b[0]))>, Grad1::size> r;
+        for (int i = 0; i < Grad1::size; ++i) {
+            r[i] = f(a[i], b[i]);
+        }
+        return r;
+    } else {
+        return f(a, b);
+    }
+}
+
+template <typename Mat>
+__forceinline__ __host__ __device__
+auto matrix_vector(const Mat& a, const typename matrix_traits<Mat>::vector_type& v) {
+    auto r = a.col[0] * v.x;
+    unroll<matrix_traits<Mat>::size - 1>([&](auto k) {
+        constexpr int j = decltype(k)::value + 1;
+        r += a.col[j] * component<j>(v);
+    });
+    return r;
+}
+
+// Sum of the elementwise products of a and b, i.e. trace(a^T b)
+template <typename Mat>
+__forceinline__ __host__ __device__
+float matrix_inner(const Mat& a, const Mat& b) {
+    float r = dot(a.col[0], b.col[0]);
+    unroll<matrix_traits<Mat>::size - 1>([&](auto k) {
+        constexpr int j = decltype(k)::value + 1;
+        r += dot(a.col[j], b.col[j]);
+    });
+    return r;
+}
+
+// Gradient of the determinant: column j is d det / d col[j], which is the
+// cofactor matrix. Returns the determinant through det.
+__forceinline__ __host__ __device__
+float3x3 determinant_gradient(const float3x3& m, float& det) {
+    const float3x3 g{{cross(m.col[1], m.col[2]), cross(m.col[2], m.col[0]),
+                      cross(m.col[0], m.col[1])}};
+    det = dot(m.col[0], g.col[0]);
+    return g;
+}
+
+// The 4 x 4 cofactors from the cross products of the upper 3-vectors of the
+// columns, as in Lengyel, Foundations of Game Engine Development, vol. 1
+__forceinline__ __host__ __device__
+float4x4 determinant_gradient(const float4x4& m, float& det) {
+    const float3 a = make_float3(m.col[0]), b = make_float3(m.col[1]);
+    const float3 c = make_float3(m.col[2]), d = make_float3(m.col[3]);
+    const float x = m.col[0].w, y = m.col[1].w, z = m.col[2].w, w = m.col[3].w;
+    const float3 s = cross(a, b);
+    const float3 t = cross(c, d);
+    const float3 u = a * y - b * x;
+    const float3 v = c * w - d * z;
+    det = dot(s, v) + dot(t, u);
+    return float4x4{{make_float4(cross(b, v) + t * y, -dot(b, t)),
+                     make_float4(cross(v, a) - t * x, dot(a, t)),
+                     make_float4(cross(d, u) + s * w, -dot(d, s)),
+                     make_float4(cross(u, c) - s * z, dot(c, s))}};
+}
+
+// Symmetric bilinear P(q, p) with R(q) = I - P(q, q) / |q|^2 for the rotation
+// R(q) of a quaternion q = (x, y, z, w), w the real part
+__forceinline__ __host__ __device__
+float3x3 quat_rotation_polar(const float4& q, const float4& p) {
+    const float xx = q.x * p.x, yy = q.y * p.y, zz = q.z * p.z;
+    const float xy = q.x * p.y + p.x * q.y, xz = q.x * p.z + p.x * q.z;
+    const float yz = q.y * p.z + p.y * q.z;
+    const float xw = q.x * p.w + p.x * q.w, yw = q.y * p.w + p.y * q.w;
+    const float zw = q.z * p.w + p.z * q.w;
+    return float3x3{{make_float3(2.0f * (yy + zz), -(xy + zw), yw - xz),
+                     make_float3(zw - xy, 2.0f * (xx + zz), -(yz + xw)),
+                     make_float3(-(xz + yw), xw - yz, 2.0f * (xx + yy))}};
+}
+
+} // namespace float_grad_detail
+
+//////////////////////////////////////////////////////////////////////////////
+/// Plain matrix operations
+//////////////////////////////////////////////////////////////////////////////
+
+inline __host__ __device__
+float3x3 make_float3x3(float3 c0, float3 c1, float3 c2) {
+    return float3x3{{c0, c1, c2}};
+}
+
+inline __host__ __device__
+float4x4 make_float4x4(float4 c0, float4 c1, float4 c2, float4 c3) {
+    return float4x4{{c0, c1, c2, c3}};
+}
+
+// Columns of duals, e.g. of FloatGrad<float3>
+template <typename T1, typename T2, typename T3,
+          typename = std::enable_if_t<is_float3_type<T1>::value
+                                      && is_float3_type<T2>::value
+                                      && is_float3_type<T3>::value
+                                      && (is_float_grad<T1>::value
+                                          || is_float_grad<T2>::value
+                                          || is_float_grad<T3>::value)>>
+inline __host__ __device__
+float_grad_result_t<float3x3, T1, T2, T3>
+make_float3x3(const T1& c0, const T2& c1, const T3& c2) {
+    // The constructor gathers the column primals and tangents
+    return float_grad_result_t<float3x3, T1, T2, T3>(c0, c1, c2);
+}
+
+template <typename T1, typename T2, typename T3, typename T4,
+          typename = std::enable_if_t<is_float4_type<T1>::value
+                                      && is_float4_type<T2>::value
+                                      && is_float4_type<T3>::value
+                                      && is_float4_type<T4>::value
+                                      && (is_float_grad<T1>::value
+                                          || is_float_grad<T2>::value
+                                          || is_float_grad<T3>::value
+                                          || is_float_grad<T4>::value)>>
+inline __host__ __device__
+float_grad_result_t<float4x4, T1, T2, T3, T4>
+make_float4x4(const T1& c0, const T2& c1, const T3& c2, const T4& c3) {
+    return float_grad_result_t<float4x4, T1, T2, T3, T4>(c0, c1, c2, c3);
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator+(const Mat& a, const Mat& b) {
+    Mat r;
+    float_grad_detail::unroll<float_grad_detail::matrix_traits<Mat>::size>([&](auto j) {
+        r.col[j] = a.col[j] + b.col[j];
+    });
+    return r;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator-(const Mat& a, const Mat& b) {
+    Mat r;
+    float_grad_detail::unroll<float_grad_detail::matrix_traits<Mat>::size>([&](auto j) {
+        r.col[j] = a.col[j] - b.col[j];
+    });
+    return r;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator-(const Mat& a) {
+    Mat r;
+    float_grad_detail::unroll<float_grad_detail::matrix_traits<Mat>::size>([&](auto j) {
+        r.col[j] = -a.col[j];
+    });
+    return r;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator*(const Mat& a, float s) {
+    Mat r;
+    float_grad_detail::unroll<float_grad_detail::matrix_traits<Mat>::size>([&](auto j) {
+        r.col[j] = a.col[j] * s;
+    });
+    return r;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator*(float s, const Mat& a) {
+    return a * s;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator/(const Mat& a, float s) {
+    return a * (1.0f / s);
+}
+
+// Matrix-vector product, a sum of scaled columns
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+typename float_grad_detail::matrix_traits<Mat>::vector_type
+operator*(const Mat& a, const typename float_grad_detail::matrix_traits<Mat>::vector_type& v) {
+    return float_grad_detail::matrix_vector(a, v);
+}
+
+// Matrix product, column j of the result is a b.col[j]
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat operator*(const Mat& a, const Mat& b) {
+    Mat r;
+    float_grad_detail::unroll<float_grad_detail::matrix_traits<Mat>::size>([&](auto j) {
+        r.col[j] = float_grad_detail::matrix_vector(a, b.col[j]);
+    });
+    return r;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+void operator+=(Mat& a, const Mat& b) {
+    a = a + b;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+void operator-=(Mat& a, const Mat& b) {
+    a = a - b;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+void operator*=(Mat& a, float s) {
+    a = a * s;
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+void operator/=(Mat& a, float s) {
+    a = a / s;
+}
+
+inline __host__ __device__
+float3x3 transpose(const float3x3& m) {
+    return float3x3{{make_float3(m.col[0].x, m.col[1].x, m.col[2].x),
+                     make_float3(m.col[0].y, m.col[1].y, m.col[2].y),
+                     make_float3(m.col[0].z, m.col[1].z, m.col[2].z)}};
+}
+
+inline __host__ __device__
+float4x4 transpose(const float4x4& m) {
+    return float4x4{{make_float4(m.col[0].x, m.col[1].x, m.col[2].x, m.col[3].x),
+                     make_float4(m.col[0].y, m.col[1].y, m.col[2].y, m.col[3].y),
+                     make_float4(m.col[0].z, m.col[1].z, m.col[2].z, m.col[3].z),
+                     make_float4(m.col[0].w, m.col[1].w, m.col[2].w, m.col[3].w)}};
+}
+
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+float determinant(const Mat& m) {
+    float det;
+    float_grad_detail::determinant_gradient(m, det);
+    return det;
+}
+
+// The adjugate, the transposed cofactors, over the determinant. Singular
+// matrices give infinities.
+template <typename Mat, typename = std::enable_if_t<float_grad_detail::is_plain_matrix<Mat>::value>>
+inline __host__ __device__
+Mat inverse(const Mat& m) {
+    float det;
+    const Mat cofactors = float_grad_detail::determinant_gradient(m, det);
+    return transpose(cofactors) * (1.0f / det);
+}
+
+// Rotation of a quaternion q = (x, y, z, w) with real part w. q need not be
+// normalized: R = I - P(q, q) / |q|^2 is the rotation of q / |q|.
+inline __host__ __device__
+float3x3 quat_to_rotation(const float4& q) {
+    const float s = 1.0f / dot(q, q);
+    float3x3 r = float_grad_detail::quat_rotation_polar(q, q) * -s;
+    r.col[0].x += 1.0f;
+    r.col[1].y += 1.0f;
+    r.col[2].z += 1.0f;
+    return r;
+}
+
+// Homogeneous transform of a point, m (p, 1)
+inline __host__ __device__
+float4 transform_point(const float4x4& m, const float3& p) {
+    return m.col[0] * p.x + m.col[1] * p.y + m.col[2] * p.z + m.col[3];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Dual matrix operations
+//////////////////////////////////////////////////////////////////////////////
+
+// Column j of a plain or dual matrix
+template <typename T, typename = std::enable_if_t<is_float_matrix_type<T>::value>>
+inline __host__ __device__
+auto get_col(const T& m, int j) {
+    if constexpr (is_float_grad<T>::value) {
+        static_assert(float_grad_depth<T>::value == 1, "Nested matrix duals are not supported");
+        using Mat = float_grad_scalar_t<T>;
+        using Vec = typename float_grad_detail::matrix_traits<Mat>::vector_type;
+        return FloatGrad<Vec, num_tangents<T>::value>(
+            m.data().col[j],
+            float_grad_detail::map_tangent_lanes(m.grad(), [&](const Mat& g) { return g.col[j]; }));
+    } else {
+        return m.col[j];
+    }
+}
+
+template <typename T>
+inline __host__ __device__
+std::enable_if_t<is_float_matrix_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float_grad_scalar_t<T>, T>>
+transpose(const T& m) {
+    static_assert(float_grad_depth<T>::value == 1, "Nested matrix duals are not supported");
+    using Mat = float_grad_scalar_t<T>;
+    return float_grad_result_t<Mat, T>(
+        transpose(m.data()),
+        float_grad_detail::map_tangent_lanes(m.grad(), [](const Mat& g) { return transpose(g); }));
+}
+
+// d det = sum of the cofactors times dm, i.e. trace(adj(m) dm)
+template <typename T>
+inline __host__ __device__
+std::enable_if_t<is_float_matrix_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float, T>>
+determinant(const T& m) {
+    static_assert(float_grad_depth<T>::value == 1, "Nested matrix duals are not supported");
+    using Mat = float_grad_scalar_t<T>;
+    float det;
+    const Mat cofactors = float_grad_detail::determinant_gradient(m.data(), det);
+    return float_grad_result_t<float, T>(
+        det, float_grad_detail::map_tangent_lanes(m.grad(), [&](const Mat& g) {
+            return float_grad_detail::matrix_inner(cofactors, g);
+        }));
+}
+
+// d(m^-1) = -m^-1 dm m^-1
+template <typename T>
+inline __host__ __device__
+std::enable_if_t<is_float_matrix_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float_grad_scalar_t<T>, T>>
+inverse(const T& m) {
+    static_assert(float_grad_depth<T>::value == 1, "Nested matrix duals are not supported");
+    using Mat = float_grad_scalar_t<T>;
+    const Mat inv = inverse(m.data());
+    const Mat neg_inv = -inv;
+    return float_grad_result_t<Mat, T>(
+        inv, float_grad_detail::map_tangent_lanes(m.grad(), [&](const Mat& g) {
+            return neg_inv * (g * inv);
+        }));
+}
+
+// With s = 1 / |q|^2, R = I - s P(q, q) and P bilinear and symmetric:
+// dR = 2 s (s (q . dq) P(q, q) - P(q, dq))
+template <typename T>
+inline __host__ __device__
+std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float3x3, T>>
+quat_to_rotation(const T& q) {
+    static_assert(float_grad_depth<T>::value == 1, "Nested quaternion duals are not supported");
+    const float4 qd = q.data();
+    const float s = 1.0f / dot(qd, qd);
+    const float3x3 polar = float_grad_detail::quat_rotation_polar(qd, qd);
+    return float_grad_result_t<float3x3, T>(
+        quat_to_rotation(qd), float_grad_detail::map_tangent_lanes(q.grad(), [&](const float4& dq) {
+            return (polar * (s * dot(qd, dq)) - float_grad_detail::quat_rotation_polar(qd, dq))
+                   * (2.0f * s);
+        }));
+}
+
+// d(m (p, 1)) = dm (p, 1) + m (dp, 0), with the passive terms dropped
+template <typename T1, typename T2>
+inline __host__ __device__
+std::enable_if_t<is_float4x4_type<T1>::value && is_float3_type<T2>::value
+                 && (is_float_grad<T1>::value || is_float_grad<T2>::value),
+                 float_grad_result_t<float4, T1, T2>>
+transform_point(const T1& m, const T2& p) {
+    static_assert(float_grad_depth_v<T1, T2> == 1, "Nested matrix duals are not supported");
+    static_assert(same_num_tangents_v<T1, T2>,
+                  "FloatGrad operands must have the same number of tangents");
+    const float4x4& md = get_data(m);
+    const float3& pd = get_data(p);
+    const auto dm = get_grad(m);
+    const auto dp = get_grad(p);
+    using DM = std::decay_t<decltype(dm)>;
+    using DP = std::decay_t<decltype(dp)>;
+    auto grad = [&] {
+        if constexpr (!is_zero_tangent<DM>::value && !is_zero_tangent<DP>::value) {
+            return float_grad_detail::map_tangent_lanes(dm, dp, [&](const float4x4& g, const float3& v) {
+                return transform_point(g, pd) + (md.col[0] * v.x + md.col[1] * v.y + md.col[2] * v.z);
+            });
+        } else if constexpr (!is_zero_tangent<DM>::value) {
+            return float_grad_detail::map_tangent_lanes(dm, [&](const float4x4& g) {
+                return transform_point(g, pd);
+            });
+        } else {
+            return float_grad_detail::map_tangent_lanes(dp, [&](const float3& v) {
+                return md.col[0] * v.x + md.col[1] * v.y + md.col[2] * v.z;
+            });
+        }
+    }();
+    return float_grad_result_t<float4, T1, T2>(transform_point(md, pd), grad);
+}
+
+#endif // FLOAT_GRAD_MATRIX_H
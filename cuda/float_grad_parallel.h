@@ -0,0 +1,333 @@
+#ifndef FLOAT_GRAD_PARALLEL_H
+#define FLOAT_GRAD_PARALLEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Host-only builds define __noinline__ in cuda_compat.h, which libstdc++
+// uses as an attribute name inside these headers
+#pragma push_macro("__noinline__")
+#undef __noinline__
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#pragma pop_macro("__noinline__")
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// Host thread pool for the dual kernels. run(f) calls f(tid) once for
+/// every tid < size(), on the calling thread for tid 0 and on the workers
+/// for the others, and returns when all calls have returned. A run() from
+/// inside a running f executes serially on the calling thread, so kernels
+/// can nest without deadlocking. f must not throw.
+///
+/// parallel_for and parallel_reduce cut a range into leaves of a grain
+/// multiple and balance them with work stealing: every thread owns a deque
+/// of leaf ranges, splits its own ranges in half as it goes, and when out of
+/// work takes the largest range left on another thread's deque.
+///
+///     ThreadPool pool(8, true);           // 8 threads, workers pinned
+///     parallel_for(pool, n, 4096, [&](int64_t begin, int64_t end) {
+///         batch_mul(out + begin, a + begin, b + begin, end - begin);
+///     });
+///
+/// ThreadPool::global() is sized by FLOAT_GRAD_NUM_THREADS, or the number of
+/// hardware threads, and pins its workers if FLOAT_GRAD_PIN_THREADS is 1.
+//////////////////////////////////////////////////////////////////////////////
+
+class ThreadPool {
+public:
+    // Workers are pinned to CPUs 1, 2, ... when pin is set; the calling
+    // thread keeps its affinity
+    explicit ThreadPool(int num_threads, bool pin = false) {
+        num_threads = std::max(num_threads, 1);
+        workers_.reserve(num_threads - 1);
+        for (int tid = 1; tid < num_threads; ++tid) {
+            workers_.emplace_back([this, tid] { worker(tid); });
+            if (pin) {
+                pin_thread(workers_.back(), tid);
+            }
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (std::thread& t : workers_) {
+            t.join();
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(workers_.size()) + 1;
+    }
+
+    template <typename Function>
+    void run(Function&& f) {
+        if (workers_.empty() || in_parallel_region()) {
+            for (int tid = 0; tid < size(); ++tid) {
+                f(tid);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = {&call<std::remove_reference_t<Function>>, &f};
+            pending_ = static_cast<int>(workers_.size());
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        in_parallel_region() = true;
+        f(0);
+        in_parallel_region() = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait(done_cv_, lock, [this] { return pending_ == 0; });
+    }
+
+    static ThreadPool& global() {
+        static ThreadPool pool(env_int("FLOAT_GRAD_NUM_THREADS", hardware_threads()),
+                               env_int("FLOAT_GRAD_PIN_THREADS", 0) == 1);
+        return pool;
+    }
+
+    static int hardware_threads() {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+private:
+    struct Job {
+        void (*call)(void*, int);
+        void* f;
+    };
+
+    template <typename Function>
+    static void call(void* f, int tid) {
+        (*static_cast<Function*>(f))(tid);
+    }
+
+    // condition_variable::wait(lock) has a GLIBCXX_3.4.30 symbol version
+    // since GCC 12, which older runtimes such as conda's libstdc++ lack; the
+    // timed wait is inline
+    template <typename Predicate>
+    static void wait(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, Predicate ready) {
+        while (!ready()) {
+            cv.wait_for(lock, std::chrono::seconds(1));
+        }
+    }
+
+    static bool& in_parallel_region() {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    static int env_int(const char* name, int fallback) {
+        const char* value = std::getenv(name);
+        return value != nullptr && *value != '\0' ? std::atoi(value) : fallback;
+    }
+
+    static void pin_thread(std::thread& t, int cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % hardware_threads(), &set);
+        pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+        (void)t;
+        (void)cpu;
+#endif
+    }
+
+    void worker(int tid) {
+        in_parallel_region() = true;
+        uint64_t seen = 0;
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wait(start_cv_, lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+            }
+            job.call(job.f, tid);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0) {
+                    done_cv_.notify_one();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    Job job_ = {nullptr, nullptr};
+    uint64_t generation_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+};
+
+namespace float_grad_detail {
+
+// Most leaves a range is split into per thread: enough for idle threads to
+// find work to steal when leaves take uneven time, few enough that each
+// one amortizes a deque operation
+constexpr int64_t parallel_leaves_per_thread = 16;
+
+// Leaves [begin, end) of a parallel_for
+struct LeafRange {
+    int64_t begin, end;
+};
+
+// One thread's leaves. The owner pops from the back and pushes back the
+// halves it splits off, so it walks its leaves in order; thieves take the
+// front, which is the largest range left.
+struct alignas(64) LeafDeque {
+    std::mutex mutex;
+    std::deque<LeafRange> ranges;
+
+    void push(LeafRange r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ranges.push_back(r);
+    }
+
+    bool pop(LeafRange& r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ranges.empty()) {
+            return false;
+        }
+        r = ranges.back();
+        ranges.pop_back();
+        return true;
+    }
+
+    bool steal(LeafRange& r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ranges.empty()) {
+            return false;
+        }
+        r = ranges.front();
+        ranges.pop_front();
+        return true;
+    }
+};
+
+// Number of leaves of at least grain elements covering n, and the leaf
+// length as a multiple of grain. The split depends only on n, grain and the
+// pool size, never on timing.
+inline int64_t parallel_leaves(const ThreadPool& pool, int64_t n, int64_t grain, int64_t& length) {
+    grain = std::max<int64_t>(grain, 1);
+    const int64_t grains = (n + grain - 1) / grain;
+    int64_t leaves = std::min<int64_t>(pool.size() * parallel_leaves_per_thread, grains);
+    length = (grains + leaves - 1) / leaves * grain;
+    return (n + length - 1) / length;
+}
+
+// Calls leaf(i) once for every i < leaves on the threads of pool. Each
+// thread starts on a contiguous share of the leaves, halving its range
+// until one leaf is left to run, and once its deque is empty steals ranges
+// from the others in turn.
+template <typename Leaf>
+void run_stealing(ThreadPool& pool, int64_t leaves, Leaf&& leaf) {
+    const int threads = pool.size();
+    std::unique_ptr<LeafDeque[]> deques(new LeafDeque[threads]);
+    for (int t = 0; t < threads; ++t) {
+        const int64_t begin = leaves * t / threads;
+        const int64_t end = leaves * (t + 1) / threads;
+        if (begin < end) {
+            deques[t].ranges.push_back({begin, end});
+        }
+    }
+    std::atomic<int64_t> remaining(leaves);
+    pool.run([&](int tid) {
+        LeafRange r;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            bool found = deques[tid].pop(r);
+            for (int v = 1; !found && v < threads; ++v) {
+                found = deques[(tid + v) % threads].steal(r);
+            }
+            if (!found) {
+                // Every leaf is taken, some are still running
+                std::this_thread::yield();
+                continue;
+            }
+            while (r.end - r.begin > 1) {
+                const int64_t mid = r.begin + (r.end - r.begin) / 2;
+                deques[tid].push({mid, r.end});
+                r.end = mid;
+            }
+            leaf(r.begin);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    });
+}
+
+} // namespace float_grad_detail
+
+// Calls f(begin, end) on contiguous leaves covering [0, n), each a multiple
+// of grain elements except the last. Leaves are balanced over the threads
+// by work stealing, so uneven leaf costs do not leave threads idle.
+template <typename Function>
+void parallel_for(ThreadPool& pool, int64_t n, int64_t grain, Function&& f) {
+    if (n <= 0) {
+        return;
+    }
+    int64_t length;
+    const int64_t leaves = float_grad_detail::parallel_leaves(pool, n, grain, length);
+    if (leaves == 1 || pool.size() == 1) {
+        f(int64_t(0), n);
+        return;
+    }
+    float_grad_detail::run_stealing(pool, leaves, [&](int64_t i) {
+        f(i * length, std::min(n, (i + 1) * length));
+    });
+}
+
+// Reduces f(begin, end) over the leaves of parallel_for with combine, in
+// leaf order so that the result does not depend on which thread ran what
+template <typename T, typename Function, typename Combine>
+T parallel_reduce(ThreadPool& pool, int64_t n, int64_t grain, T init, Function&& f, Combine&& combine) {
+    if (n <= 0) {
+        return init;
+    }
+    int64_t length;
+    const int64_t leaves = float_grad_detail::parallel_leaves(pool, n, grain, length);
+    if (leaves == 1 || pool.size() == 1) {
+        return combine(init, f(int64_t(0), n));
+    }
+    std::vector<T> partials(leaves, init);
+    float_grad_detail::run_stealing(pool, leaves, [&](int64_t i) {
+        partials[i] = f(i * length, std::min(n, (i + 1) * length));
+    });
+    T result = init;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+#endif // FLOAT_GRAD_PARALLEL_H
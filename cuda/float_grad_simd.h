@@ -0,0 +1,460 @@
+#ifndef FLOAT_GRAD_SIMD_H
+#define FLOAT_GRAD_SIMD_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if !defined(__CUDA_ARCH__) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)))
+#include <immintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// Host SIMD layer for the batch kernels of float_grad_batch.h. SimdVec is
+/// the widest float vector of the target: 16 lanes under AVX-512, 8 under
+/// AVX2 + FMA, and SimdScalar otherwise. The ISA is picked at compile time
+/// from the target flags (e.g. -march=native). SimdScalar also runs the
+/// tails of the vector loops, through the same generic math functions, so a
+/// batch result does not depend on the position of its element.
+//////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+template <typename V>
+struct SimdTag {
+    using type = V;
+};
+
+/// Portable single lane
+
+struct SimdScalar {
+    static constexpr int width = 1;
+    using Mask = bool;
+    float v;
+
+    static SimdScalar load(const float* p) { return {*p}; }
+    static SimdScalar broadcast(float x) { return {x}; }
+    void store(float* p) const { *p = v; }
+};
+
+inline SimdScalar operator+(SimdScalar a, SimdScalar b) { return {a.v + b.v}; }
+inline SimdScalar operator-(SimdScalar a, SimdScalar b) { return {a.v - b.v}; }
+inline SimdScalar operator*(SimdScalar a, SimdScalar b) { return {a.v * b.v}; }
+inline SimdScalar operator/(SimdScalar a, SimdScalar b) { return {a.v / b.v}; }
+inline SimdScalar simd_fma(SimdScalar a, SimdScalar b, SimdScalar c) { return {fmaf(a.v, b.v, c.v)}; }
+inline SimdScalar simd_sqrt(SimdScalar a) { return {sqrtf(a.v)}; }
+// Same NaN behaviour as minps/maxps: the second operand unless a < b (a > b)
+inline SimdScalar simd_min(SimdScalar a, SimdScalar b) { return {a.v < b.v ? a.v : b.v}; }
+inline SimdScalar simd_max(SimdScalar a, SimdScalar b) { return {a.v > b.v ? a.v : b.v}; }
+inline SimdScalar simd_abs(SimdScalar a) { return {fabsf(a.v)}; }
+inline SimdScalar simd_copysign(SimdScalar a, SimdScalar b) { return {copysignf(a.v, b.v)}; }
+inline SimdScalar simd_round(SimdScalar a) { return {rintf(a.v)}; }
+inline SimdScalar simd_floor(SimdScalar a) { return {floorf(a.v)}; }
+inline SimdScalar simd_scale2(SimdScalar a, SimdScalar n) { return {ldexpf(a.v, static_cast<int>(n.v))}; }
+// Mantissa in [0.5, 1) and exponent of a positive normal float
+inline SimdScalar simd_frexp(SimdScalar a, SimdScalar& e) {
+    int ei;
+    const float m = frexpf(a.v, &ei);
+    e = {static_cast<float>(ei)};
+    return {m};
+}
+inline bool simd_less(SimdScalar a, SimdScalar b) { return a.v < b.v; }
+inline bool simd_equal(SimdScalar a, SimdScalar b) { return a.v == b.v; }
+inline bool simd_and(bool a, bool b) { return a && b; }
+inline unsigned simd_bits(bool m) { return m; }
+inline SimdScalar simd_select(bool m, SimdScalar a, SimdScalar b) { return m ? a : b; }
+// Sum of the lanes
+inline float simd_sum(SimdScalar a) { return a.v; }
+// W interleaved (even, odd) pairs from 2 W floats at p, and back
+inline void simd_load_pairs(const float* p, SimdScalar& even, SimdScalar& odd) {
+    even = {p[0]};
+    odd = {p[1]};
+}
+inline void simd_store_pairs(float* p, SimdScalar even, SimdScalar odd) {
+    p[0] = even.v;
+    p[1] = odd.v;
+}
+
+#if !defined(__CUDA_ARCH__) && defined(__AVX512F__)
+
+struct Simd512 {
+    static constexpr int width = 16;
+    using Mask = __mmask16;
+    __m512 v;
+
+    static Simd512 load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    static Simd512 broadcast(float x) { return {_mm512_set1_ps(x)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+};
+
+inline Simd512 operator+(Simd512 a, Simd512 b) { return {_mm512_add_ps(a.v, b.v)}; }
+inline Simd512 operator-(Simd512 a, Simd512 b) { return {_mm512_sub_ps(a.v, b.v)}; }
+inline Simd512 operator*(Simd512 a, Simd512 b) { return {_mm512_mul_ps(a.v, b.v)}; }
+inline Simd512 operator/(Simd512 a, Simd512 b) { return {_mm512_div_ps(a.v, b.v)}; }
+inline Simd512 simd_fma(Simd512 a, Simd512 b, Simd512 c) { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+inline Simd512 simd_sqrt(Simd512 a) { return {_mm512_sqrt_ps(a.v)}; }
+inline Simd512 simd_min(Simd512 a, Simd512 b) { return {_mm512_min_ps(a.v, b.v)}; }
+inline Simd512 simd_max(Simd512 a, Simd512 b) { return {_mm512_max_ps(a.v, b.v)}; }
+inline Simd512 simd_abs(Simd512 a) { return {_mm512_abs_ps(a.v)}; }
+inline Simd512 simd_copysign(Simd512 a, Simd512 b) {
+    const __m512i sign = _mm512_set1_epi32(INT32_MIN);
+    const __m512i mag = _mm512_andnot_epi32(sign, _mm512_castps_si512(a.v));
+    return {_mm512_castsi512_ps(_mm512_or_epi32(mag, _mm512_and_epi32(sign, _mm512_castps_si512(b.v))))};
+}
+inline Simd512 simd_round(Simd512 a) {
+    return {_mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline Simd512 simd_floor(Simd512 a) {
+    return {_mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)};
+}
+// a * 2^n for integral n
+inline Simd512 simd_scale2(Simd512 a, Simd512 n) { return {_mm512_scalef_ps(a.v, n.v)}; }
+inline Simd512 simd_frexp(Simd512 a, Simd512& e) {
+    e = {_mm512_add_ps(_mm512_getexp_ps(a.v), _mm512_set1_ps(1.0f))};
+    return {_mm512_getmant_ps(a.v, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_src)};
+}
+inline __mmask16 simd_less(Simd512 a, Simd512 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+inline __mmask16 simd_equal(Simd512 a, Simd512 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ); }
+inline __mmask16 simd_and(__mmask16 a, __mmask16 b) { return a & b; }
+inline unsigned simd_bits(__mmask16 m) { return m; }
+inline Simd512 simd_select(__mmask16 m, Simd512 a, Simd512 b) {
+    return {_mm512_mask_blend_ps(m, b.v, a.v)};
+}
+inline float simd_sum(Simd512 a) { return _mm512_reduce_add_ps(a.v); }
+inline void simd_load_pairs(const float* p, Simd512& even, Simd512& odd) {
+    const __m512 lo = _mm512_loadu_ps(p);
+    const __m512 hi = _mm512_loadu_ps(p + 16);
+    const __m512i even_idx = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                               16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i odd_idx = _mm512_add_epi32(even_idx, _mm512_set1_epi32(1));
+    even = {_mm512_permutex2var_ps(lo, even_idx, hi)};
+    odd = {_mm512_permutex2var_ps(lo, odd_idx, hi)};
+}
+inline void simd_store_pairs(float* p, Simd512 even, Simd512 odd) {
+    const __m512i lo_idx = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19,
+                                             4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i hi_idx = _mm512_add_epi32(lo_idx, _mm512_set1_epi32(8));
+    _mm512_storeu_ps(p, _mm512_permutex2var_ps(even.v, lo_idx, odd.v));
+    _mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(even.v, hi_idx, odd.v));
+}
+
+using SimdVec = Simd512;
+
+#elif !defined(__CUDA_ARCH__) && defined(__AVX2__) && defined(__FMA__)
+
+struct Simd256 {
+    static constexpr int width = 8;
+    using Mask = __m256;
+    __m256 v;
+
+    static Simd256 load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Simd256 broadcast(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+inline Simd256 operator+(Simd256 a, Simd256 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Simd256 operator-(Simd256 a, Simd256 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Simd256 operator*(Simd256 a, Simd256 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Simd256 operator/(Simd256 a, Simd256 b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Simd256 simd_fma(Simd256 a, Simd256 b, Simd256 c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+inline Simd256 simd_sqrt(Simd256 a) { return {_mm256_sqrt_ps(a.v)}; }
+inline Simd256 simd_min(Simd256 a, Simd256 b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Simd256 simd_max(Simd256 a, Simd256 b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Simd256 simd_abs(Simd256 a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+inline Simd256 simd_copysign(Simd256 a, Simd256 b) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    return {_mm256_or_ps(_mm256_andnot_ps(sign, a.v), _mm256_and_ps(sign, b.v))};
+}
+inline Simd256 simd_round(Simd256 a) {
+    return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline Simd256 simd_floor(Simd256 a) { return {_mm256_floor_ps(a.v)}; }
+// a * 2^n for integral n in [-252, 254], in two exponent steps so that both
+// ends of the float range stay representable
+inline Simd256 simd_scale2(Simd256 a, Simd256 n) {
+    const __m256i ni = _mm256_cvtps_epi32(n.v);
+    const __m256i n1 = _mm256_srai_epi32(ni, 1);
+    const __m256i n2 = _mm256_sub_epi32(ni, n1);
+    const __m256i bias = _mm256_set1_epi32(127);
+    const __m256 s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23));
+    const __m256 s2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23));
+    return {_mm256_mul_ps(_mm256_mul_ps(a.v, s1), s2)};
+}
+inline Simd256 simd_frexp(Simd256 a, Simd256& e) {
+    const __m256i bits = _mm256_castps_si256(a.v);
+    const __m256i biased = _mm256_srli_epi32(bits, 23);
+    e = {_mm256_cvtepi32_ps(_mm256_sub_epi32(biased, _mm256_set1_epi32(126)))};
+    const __m256i mant = _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff));
+    return {_mm256_castsi256_ps(_mm256_or_si256(mant, _mm256_set1_epi32(0x3f000000)))};
+}
+inline __m256 simd_less(Simd256 a, Simd256 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline __m256 simd_equal(Simd256 a, Simd256 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+inline __m256 simd_and(__m256 a, __m256 b) { return _mm256_and_ps(a, b); }
+inline unsigned simd_bits(__m256 m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+inline Simd256 simd_select(__m256 m, Simd256 a, Simd256 b) {
+    return {_mm256_blendv_ps(b.v, a.v, m)};
+}
+inline float simd_sum(Simd256 a) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+}
+// The in-lane shuffles leave 64-bit pairs in the order 0 2 1 3
+inline void simd_load_pairs(const float* p, Simd256& even, Simd256& odd) {
+    const __m256 lo = _mm256_loadu_ps(p);
+    const __m256 hi = _mm256_loadu_ps(p + 8);
+    const __m256 e = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 o = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    even = {_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(e), _MM_SHUFFLE(3, 1, 2, 0)))};
+    odd = {_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(o), _MM_SHUFFLE(3, 1, 2, 0)))};
+}
+inline void simd_store_pairs(float* p, Simd256 even, Simd256 odd) {
+    const __m256 lo = _mm256_unpacklo_ps(even.v, odd.v);
+    const __m256 hi = _mm256_unpackhi_ps(even.v, odd.v);
+    _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+using SimdVec = Simd256;
+
+#else
+
+using SimdVec = SimdScalar;
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// Math on SIMD lanes. Cephes-style range reduction and polynomials, within
+/// a few ulp of the libm float functions on their documented ranges. Min and
+/// max take x second so that NaN propagates.
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename V>
+inline V simd_neg(V x) {
+    return x * V::broadcast(-1.0f);
+}
+
+// Polynomial c[0] x^(n-1) + ... + c[n-1] by Horner's rule
+template <typename V, int Size>
+inline V simd_poly(V x, const float (&c)[Size]) {
+    V p = V::broadcast(c[0]);
+    for (int k = 1; k < Size; ++k) {
+        p = simd_fma(p, x, V::broadcast(c[k]));
+    }
+    return p;
+}
+
+// exp(x) = 2^n exp(r) with n = round(x / ln 2) and a degree 7 polynomial for
+// exp(r) on |r| <= ln 2 / 2
+template <typename V>
+inline V simd_exp(V x) {
+    const V lo = V::broadcast(-103.972077f);
+    const V hi = V::broadcast(88.7228394f);
+    const V xc = simd_max(lo, simd_min(hi, x));
+    const V n = simd_round(xc * V::broadcast(1.44269504f));
+    V r = simd_fma(n, V::broadcast(-0.693359375f), xc);
+    r = simd_fma(n, V::broadcast(2.12194440e-4f), r);
+    static constexpr float c[] = {1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                                  4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+    const V p = simd_fma(simd_poly(r, c) * r, r, r + V::broadcast(1.0f));
+    const V e = simd_scale2(p, n);
+    // Outside the clamp the result overflows or underflows
+    const V big = simd_select(simd_less(hi, x), V::broadcast(std::numeric_limits<float>::infinity()), e);
+    return simd_select(simd_less(x, lo), V::broadcast(0.0f), big);
+}
+
+// Splits a positive finite x into 2^e m with m in [sqrt(1/2), sqrt(2)), so
+// that log(m) = f + c with f = m - 1 exact and the small correction c
+template <typename V>
+inline V simd_log_reduce(V x, V& e, V& c) {
+    // Scale subnormals into the normal range first
+    const auto tiny = simd_less(x, V::broadcast(std::numeric_limits<float>::min()));
+    x = simd_select(tiny, x * V::broadcast(33554432.0f), x);
+    V m = simd_frexp(x, e);
+    e = e - simd_select(tiny, V::broadcast(25.0f), V::broadcast(0.0f));
+    const auto small = simd_less(m, V::broadcast(0.707106781186547524f));
+    e = e - simd_select(small, V::broadcast(1.0f), V::broadcast(0.0f));
+    const V f = simd_select(small, m + m, m) - V::broadcast(1.0f);
+    static constexpr float p[] = {7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                                  -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                                  2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f};
+    const V z = f * f;
+    c = simd_fma(V::broadcast(-0.5f), z, simd_poly(f, p) * f * z);
+    return f;
+}
+
+template <typename V>
+inline V simd_log(V x) {
+    V e, c;
+    const V f = simd_log_reduce(x, e, c);
+    V r = f + simd_fma(e, V::broadcast(-2.12194440e-4f), c);
+    r = simd_fma(e, V::broadcast(0.693359375f), r);
+    const V inf = V::broadcast(std::numeric_limits<float>::infinity());
+    const V special = simd_select(simd_equal(x, V::broadcast(0.0f)), simd_neg(inf),
+                                  simd_select(simd_equal(x, inf), inf,
+                                              V::broadcast(std::numeric_limits<float>::quiet_NaN())));
+    return simd_select(simd_and(simd_less(V::broadcast(0.0f), x), simd_less(x, inf)), r, special);
+}
+
+// log(1 + x) = log(u) x / (u - 1) with u = 1 + x, which cancels the rounding
+// of u. Also returns u, the reciprocal of the derivative.
+template <typename V>
+inline V simd_log1p(V x, V& u) {
+    u = V::broadcast(1.0f) + x;
+    const V d = u - V::broadcast(1.0f);
+    const V r = simd_log(u) * (x / d);
+    const V big = V::broadcast(std::numeric_limits<float>::max());
+    return simd_select(simd_equal(d, V::broadcast(0.0f)), x, simd_select(simd_less(big, x), x, r));
+}
+
+// Largest |x| for which the three-part reduction by pi / 2 stays accurate
+constexpr float simd_trig_limit = 8192.0f;
+
+// sin(x) and cos(x) from one reduction x = n pi / 2 + r, |r| <= pi / 4
+template <typename V>
+inline void simd_sincos(V x, V& s, V& c) {
+    const V n = simd_round(x * V::broadcast(0.636619772f));
+    V r = simd_fma(n, V::broadcast(-1.5703125f), x);
+    r = simd_fma(n, V::broadcast(-4.837512969970703125e-4f), r);
+    r = simd_fma(n, V::broadcast(-7.54978995489188216e-8f), r);
+    const V z = r * r;
+    static constexpr float sc[] = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+    static constexpr float cc[] = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+    const V sr = simd_fma(simd_poly(z, sc) * z, r, r);
+    const V cr = simd_fma(simd_poly(z, cc) * z, z, simd_fma(V::broadcast(-0.5f), z, V::broadcast(1.0f)));
+    // Quadrant q = n mod 4
+    const V q = n - V::broadcast(4.0f) * simd_floor(n * V::broadcast(0.25f));
+    const auto odd = simd_less(V::broadcast(0.5f), q - V::broadcast(2.0f) * simd_floor(q * V::broadcast(0.5f)));
+    const V sv = simd_select(odd, cr, sr);
+    const V cv = simd_select(odd, sr, cr);
+    s = simd_select(simd_less(V::broadcast(1.5f), q), simd_neg(sv), sv);
+    c = simd_select(simd_and(simd_less(V::broadcast(0.5f), q), simd_less(q, V::broadcast(2.5f))),
+                    simd_neg(cv), cv);
+}
+
+// tanh(x) = x + x^3 P(x^2) for |x| < 0.625, else 1 - 2 / (exp(2|x|) + 1)
+template <typename V>
+inline V simd_tanh(V x) {
+    const V a = simd_abs(x);
+    static constexpr float c[] = {-5.70498872745e-3f, 2.06390887954e-2f, -5.37397155531e-2f,
+                                  1.33314422036e-1f, -3.33332819422e-1f};
+    const V z = x * x;
+    const V small = simd_fma(simd_poly(z, c) * z, x, x);
+    const V e = simd_exp(a + a);
+    const V big = simd_copysign(V::broadcast(1.0f) - V::broadcast(2.0f) / (e + V::broadcast(1.0f)), x);
+    return simd_select(simd_less(a, V::broadcast(0.625f)), small, big);
+}
+
+// atan(x) for x >= 0, reduced to |x| <= tan(pi / 8)
+template <typename V>
+inline V simd_atan_positive(V a) {
+    const auto big = simd_less(V::broadcast(2.414213562373095f), a);
+    const auto mid = simd_less(V::broadcast(0.4142135623730950f), a);
+    const V one = V::broadcast(1.0f);
+    const V xr = simd_select(big, simd_neg(one / a), simd_select(mid, (a - one) / (a + one), a));
+    const V y0 = simd_select(big, V::broadcast(1.5707963267948966f),
+                             simd_select(mid, V::broadcast(0.7853981633974483f), V::broadcast(0.0f)));
+    static constexpr float c[] = {8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f,
+                                  -3.33329491539e-1f};
+    const V z = xr * xr;
+    return y0 + simd_fma(simd_poly(z, c) * z, xr, xr);
+}
+
+// atan2(y, x) for finite y and finite nonzero x
+template <typename V>
+inline V simd_atan2(V y, V x) {
+    const V t = y / x;
+    const V a = simd_copysign(simd_atan_positive(simd_abs(t)), t);
+    const V pi = simd_copysign(V::broadcast(3.14159265358979f), y);
+    return simd_select(simd_less(x, V::broadcast(0.0f)), a + pi, a);
+}
+
+// erf(x) = x P(x^2) for |x| < 1, else 1 - exp(-x^2) R(1 / |x|), with the
+// sign of x. Also returns exp(-x^2), which the derivative reuses.
+template <typename V>
+inline V simd_erf(V x, V& exp_neg_x2) {
+    const V a = simd_abs(x);
+    const V z = x * x;
+    exp_neg_x2 = simd_exp(simd_neg(z));
+    static constexpr float p[] = {-5.6480598655e-4f, 4.9217620279e-3f, -2.6715054232e-2f,
+                                  1.1280316653e-1f, -3.7612343775e-1f, 1.1283791262e+0f};
+    static constexpr float r[] = {-1.9605029370e-2f, 1.2847945060e-1f, -3.6856255863e-1f,
+                                  5.8989717301e-1f, -5.1389912240e-1f, 5.3599493623e-2f,
+                                  5.5729263505e-1f, 3.8153229442e-4f};
+    const V small = x * simd_poly(z, p);
+    const V tail = exp_neg_x2 * simd_poly(V::broadcast(1.0f) / a, r);
+    const V big = simd_copysign(V::broadcast(1.0f) - tail, x);
+    return simd_select(simd_less(a, V::broadcast(1.0f)), small, big);
+}
+
+// acos(x) = pi / 2 - asin(x) for |x| <= 1 / 2, else through
+// asin(sqrt((1 - |x|) / 2))
+template <typename V>
+inline V simd_acos(V x) {
+    const V a = simd_abs(x);
+    const auto big = simd_less(V::broadcast(0.5f), a);
+    const V zb = V::broadcast(0.5f) * (V::broadcast(1.0f) - a);
+    const V w = simd_select(big, simd_sqrt(zb), x);
+    const V z = simd_select(big, zb, x * x);
+    static constexpr float c[] = {4.2163199048e-2f, 2.4181311049e-2f, 4.5470025998e-2f,
+                                  7.4953002686e-2f, 1.6666752422e-1f};
+    const V asin_w = simd_fma(simd_poly(z, c) * z, w, w);
+    const V pi = V::broadcast(3.14159265358979f);
+    const V twice = asin_w + asin_w;
+    const V acos_big = simd_select(simd_less(x, V::broadcast(0.0f)), pi - twice, twice);
+    return simd_select(big, acos_big, V::broadcast(1.5707963267948966f) - asin_w);
+}
+
+// x^y for positive finite x and finite y, as exp(y log x) with log x and the
+// product carried in two floats each. Also returns log x for the derivative
+// in y.
+template <typename V>
+inline V simd_pow(V x, V y, V& log_x) {
+    V e, c;
+    const V f = simd_log_reduce(x, e, c);
+    // log x = l_hi + l_lo, from the exact e ln2_hi + f and its rounding error
+    const V a = e * V::broadcast(0.693359375f);
+    const V l_hi = a + f;
+    const V f_part = l_hi - a;
+    const V l_err = (a - (l_hi - f_part)) + (f - f_part);
+    const V l_lo = l_err + simd_fma(e, V::broadcast(-2.12194440e-4f), c);
+    log_x = l_hi + l_lo;
+    // y log x = t + t_lo
+    const V p = y * l_hi;
+    const V q = simd_fma(y, l_lo, simd_fma(y, l_hi, simd_neg(p)));
+    const V t = p + q;
+    const V t_lo = q - (t - p);
+    const V r = simd_exp(t);
+    const V inf = V::broadcast(std::numeric_limits<float>::infinity());
+    return simd_select(simd_less(r, inf), simd_fma(r, t_lo, r), r);
+}
+
+// Runs f(SimdTag<V>{}, i) over [0, n), in SIMD blocks and then a scalar tail
+template <typename Function>
+inline void for_each_batch(int64_t n, Function&& f) {
+    int64_t i = 0;
+    if constexpr (SimdVec::width > 1) {
+        for (; i + SimdVec::width <= n; i += SimdVec::width) {
+            f(SimdTag<SimdVec>{}, i);
+        }
+    }
+    for (; i < n; ++i) {
+        f(SimdTag<SimdScalar>{}, i);
+    }
+}
+
+// Bits of all lanes of V, to complement simd_bits
+template <typename V>
+constexpr unsigned lane_mask = (1u << V::width) - 1;
+
+// Calls f(i + k) for the lanes k set in bits
+template <typename Function>
+inline void for_each_lane(unsigned bits, int64_t i, Function&& f) {
+    for (; bits != 0; bits &= bits - 1) {
+        f(i + __builtin_ctz(bits));
+    }
+}
+
+} // namespace float_grad_detail
+
+#endif // FLOAT_GRAD_SIMD_H
@@ -0,0 +1,345 @@
+#ifndef FLOAT_GRAD_TANGENT_H
+#define FLOAT_GRAD_TANGENT_H
+
+#include "float_grad_base.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Tangent storage for vector-mode FloatGrad<FloatType, N>. The primal is
+/// computed once and every operation updates the N tangent lanes with a
+/// fixed-trip-count loop the compiler can vectorize. N == 1 keeps using a
+/// plain FloatType so single-tangent duals are unchanged. N == 0 stores a
+/// ZeroTangent, for passive values that are duals only by type.
+//////////////////////////////////////////////////////////////////////////////
+
+// Tangent of a passive value, known to be zero at compile time. Arithmetic on
+// it folds away in the type system, so zero tangent terms cost no FLOPs even
+// where IEEE semantics would keep a literal 0.0f * x. It only turns into a
+// real zero when stored into an active tangent.
+struct ZeroTangent {
+    template <typename T,
+              typename = std::enable_if_t<!is_float_grad<T>::value>>
+    __host__ __device__
+    constexpr operator T() const {
+        return T{};
+    }
+};
+
+std::false_type is_zero_tangent_impl(const void*);
+std::true_type is_zero_tangent_impl(const ZeroTangent*);
+template <typename T>
+using is_zero_tangent = decltype(is_zero_tangent_impl(std::declval<T*>()));
+
+template <typename FloatType, int N>
+struct FloatTangents {
+    static_assert(N > 1, "Single tangents are stored as plain FloatType");
+
+    static constexpr int size = N;
+
+    FloatType v[N];
+
+    __host__ __device__
+    FloatType& operator[](int i) {
+        return v[i];
+    }
+    __host__ __device__
+    const FloatType& operator[](int i) const {
+        return v[i];
+    }
+};
+
+std::false_type is_float_tangents_impl(const void*);
+template <typename T, int N>
+std::true_type is_float_tangents_impl(const FloatTangents<T, N>*);
+template <typename T>
+using is_float_tangents = decltype(is_float_tangents_impl(std::declval<T*>()));
+
+// Anything a tangent lane can be scaled by, including the dual primals of
+// nested FloatGrad<FloatGrad<float>, N>
+template <typename T>
+using is_tangent_scalar = std::bool_constant<!is_float_tangents<T>::value
+                                             && !is_float_grad_array<T>::value
+                                             && !is_zero_tangent<T>::value>;
+
+namespace float_grad_detail {
+
+template <typename FloatType, int N>
+struct tangent_type {
+    using type = FloatTangents<FloatType, N>;
+};
+
+template <typename FloatType, int N>
+struct tangent_type<const FloatType, N> {
+    using type = const typename tangent_type<FloatType, N>::type;
+};
+
+template <typename FloatType>
+struct tangent_type<FloatType, 1> {
+    using type = FloatType;
+};
+
+template <typename FloatType>
+struct tangent_type<const FloatType, 1> {
+    using type = const FloatType;
+};
+
+template <typename FloatType>
+struct tangent_type<FloatType, 0> {
+    using type = ZeroTangent;
+};
+
+template <typename FloatType>
+struct tangent_type<const FloatType, 0> {
+    using type = const ZeroTangent;
+};
+
+} // namespace float_grad_detail
+
+// Storage type of the tangent for a FloatGrad<FloatType, N>
+template <typename FloatType, int N>
+using tangent_t = typename float_grad_detail::tangent_type<FloatType, N>::type;
+
+/// Lane access. Passive (non-tangent) values broadcast to every lane.
+
+template <typename T>
+inline __host__ __device__
+decltype(auto) tangent_lane(const T& t, int i) {
+    if constexpr (is_float_tangents<T>::value) {
+        return t[i];
+    } else {
+        return t;
+    }
+}
+
+// Build tangent storage from per-component tangents, e.g. the tangents of
+// the x and y arguments of a float2 constructor
+template <typename FloatType, int N, typename... Grads>
+inline __host__ __device__
+tangent_t<FloatType, N> gather_tangents(const Grads&... grads) {
+    if constexpr (N == 0) {
+        static_assert((is_zero_tangent<Grads>::value && ...),
+                      "Cannot store an active tangent in a passive FloatGrad<T, 0>");
+        return ZeroTangent{};
+    } else if constexpr (N == 1) {
+        return FloatType{grads...};
+    } else {
+        FloatTangents<FloatType, N> r;
+        for (int i = 0; i < N; ++i) {
+            r[i] = FloatType{tangent_lane(grads, i)...};
+        }
+        return r;
+    }
+}
+
+// Extract one component of vector tangents, e.g. the x lanes of a float2
+template <typename VecType, typename CompType, int N>
+inline __host__ __device__
+FloatTangents<CompType, N> tangent_component(const FloatTangents<VecType, N>& t,
+                                             CompType VecType::*comp) {
+    FloatTangents<CompType, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = t[i].*comp;
+    }
+    return r;
+}
+
+template <typename VecType, typename CompType>
+inline __host__ __device__
+ZeroTangent tangent_component(ZeroTangent, CompType VecType::*) {
+    return {};
+}
+
+/// Lane-wise arithmetic
+
+template <typename T, int N>
+inline __host__ __device__
+FloatTangents<T, N> operator-(const FloatTangents<T, N>& a) {
+    FloatTangents<T, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = -a[i];
+    }
+    return r;
+}
+
+template <typename T, typename U, int N>
+inline __host__ __device__
+auto operator+(const FloatTangents<T, N>& a, const FloatTangents<U, N>& b) {
+    FloatTangents<std::decay_t<decltype(a[0] + b[0])>, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = a[i] + b[i];
+    }
+    return r;
+}
+
+template <typename T, typename U, int N>
+inline __host__ __device__
+auto operator-(const FloatTangents<T, N>& a, const FloatTangents<U, N>& b) {
+    FloatTangents<std::decay_t<decltype(a[0] - b[0])>, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = a[i] - b[i];
+    }
+    return r;
+}
+
+template <typename T, typename U, int N,
+          typename = std::enable_if_t<is_tangent_scalar<U>::value>>
+inline __host__ __device__
+auto operator*(const FloatTangents<T, N>& a, const U& s) {
+    FloatTangents<std::decay_t<decltype(a[0] * s)>, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = a[i] * s;
+    }
+    return r;
+}
+
+template <typename T, typename U, int N,
+          typename = std::enable_if_t<is_tangent_scalar<U>::value>>
+inline __host__ __device__
+auto operator*(const U& s, const FloatTangents<T, N>& a) {
+    FloatTangents<std::decay_t<decltype(s * a[0])>, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = s * a[i];
+    }
+    return r;
+}
+
+template <typename T, typename U, int N,
+          typename = std::enable_if_t<is_tangent_scalar<U>::value>>
+inline __host__ __device__
+auto operator/(const FloatTangents<T, N>& a, const U& s) {
+    FloatTangents<std::decay_t<decltype(a[0] / s)>, N> r;
+    for (int i = 0; i < N; ++i) {
+        r[i] = a[i] / s;
+    }
+    return r;
+}
+
+/// Lane-wise compound assignment, used by the in-place FloatGrad operators
+
+template <typename T, typename U, int N>
+inline __host__ __device__
+FloatTangents<T, N>& operator+=(FloatTangents<T, N>& a, const FloatTangents<U, N>& b) {
+    for (int i = 0; i < N; ++i) {
+        a[i] += b[i];
+    }
+    return a;
+}
+
+template <typename T, typename U, int N>
+inline __host__ __device__
+FloatTangents<T, N>& operator-=(FloatTangents<T, N>& a, const FloatTangents<U, N>& b) {
+    for (int i = 0; i < N; ++i) {
+        a[i] -= b[i];
+    }
+    return a;
+}
+
+template <typename T, typename U, int N,
+          typename = std::enable_if_t<is_tangent_scalar<U>::value>>
+inline __host__ __device__
+FloatTangents<T, N>& operator*=(FloatTangents<T, N>& a, const U& s) {
+    for (int i = 0; i < N; ++i) {
+        a[i] *= s;
+    }
+    return a;
+}
+
+template <typename T, typename U, int N,
+          typename = std::enable_if_t<is_tangent_scalar<U>::value>>
+inline __host__ __device__
+FloatTangents<T, N>& operator/=(FloatTangents<T, N>& a, const U& s) {
+    for (int i = 0; i < N; ++i) {
+        a[i] /= s;
+    }
+    return a;
+}
+
+/// ZeroTangent arithmetic. Sums drop the zero, products and quotients with a
+/// zero factor are zero.
+
+inline __host__ __device__
+ZeroTangent operator-(ZeroTangent) {
+    return {};
+}
+
+inline __host__ __device__
+ZeroTangent operator+(ZeroTangent, ZeroTangent) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+T operator+(const T& a, ZeroTangent) {
+    return a;
+}
+
+template <typename T>
+inline __host__ __device__
+T operator+(ZeroTangent, const T& b) {
+    return b;
+}
+
+inline __host__ __device__
+ZeroTangent operator-(ZeroTangent, ZeroTangent) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+T operator-(const T& a, ZeroTangent) {
+    return a;
+}
+
+template <typename T>
+inline __host__ __device__
+auto operator-(ZeroTangent, const T& b) {
+    return -b;
+}
+
+inline __host__ __device__
+ZeroTangent operator*(ZeroTangent, ZeroTangent) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+ZeroTangent operator*(const T&, ZeroTangent) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+ZeroTangent operator*(ZeroTangent, const T&) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+ZeroTangent operator/(ZeroTangent, const T&) {
+    return {};
+}
+
+template <typename T>
+inline __host__ __device__
+T& operator+=(T& a, ZeroTangent) {
+    return a;
+}
+
+template <typename T>
+inline __host__ __device__
+T& operator-=(T& a, ZeroTangent) {
+    return a;
+}
+
+template <typename T>
+inline __host__ __device__
+ZeroTangent& operator*=(ZeroTangent& a, const T&) {
+    return a;
+}
+
+template <typename T>
+inline __host__ __device__
+ZeroTangent& operator/=(ZeroTangent& a, const T&) {
+    return a;
+}
+
+#endif // FLOAT_GRAD_TANGENT_H
@@ -0,0 +1,369 @@
+#ifndef FLOAT_GRAD_TAYLOR_H
+#define FLOAT_GRAD_TAYLOR_H
+
+#include "float_grad_base.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Truncated Taylor polynomials. FloatTaylor<FloatType, K> carries the
+/// normalized coefficients c[k] = f^(k) / k! of a value along one direction
+/// up to order K. Products, quotients and elementary functions use the
+/// O(K^2) Cauchy-product recurrences, where nesting first-order duals K deep
+/// would cost O(2^K).
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename FloatType, int K>
+struct FloatTaylor {
+    static_assert(K >= 1, "FloatTaylor needs at least one derivative");
+
+    FloatType c[K + 1];
+
+    // Seeds
+    __host__ __device__
+    static FloatTaylor constant(const FloatType& x) {
+        FloatTaylor t;
+        t[0] = x;
+        for (int k = 1; k <= K; ++k) {
+            t[k] = FloatType{};
+        }
+        return t;
+    }
+
+    __host__ __device__
+    static FloatTaylor variable(const FloatType& x, const FloatType& dir) {
+        FloatTaylor t = constant(x);
+        t[1] = dir;
+        return t;
+    }
+
+    __host__ __device__
+    FloatType& operator[](int k) {
+        return c[k];
+    }
+    __host__ __device__
+    const FloatType& operator[](int k) const {
+        return c[k];
+    }
+
+    __host__ __device__
+    FloatType& data() {
+        return c[0];
+    }
+    __host__ __device__
+    const FloatType& data() const {
+        return c[0];
+    }
+
+    // k-th directional derivative, k! * c[k]
+    __host__ __device__
+    FloatType derivative(int k) const {
+        FloatType d = c[k];
+        for (int i = 2; i <= k; ++i) {
+            d = d * static_cast<float>(i);
+        }
+        return d;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<FloatTaylor<float, 4>>
+              && sizeof(FloatTaylor<float, 4>) == 5 * sizeof(float),
+              "FloatTaylor must only hold its coefficients");
+
+/////////////////////////////////////////////////////////////////////////////
+/// SFINAE utility
+/////////////////////////////////////////////////////////////////////////////
+
+std::false_type is_float_taylor_impl(const void*);
+template <typename T, int K>
+std::true_type is_float_taylor_impl(const FloatTaylor<T, K>*);
+template <typename T>
+using is_float_taylor = decltype(is_float_taylor_impl(std::declval<T*>()));
+
+// Truncation order of a type, 0 for constants
+std::integral_constant<int, 0> taylor_order_impl(const void*);
+template <typename T, int K>
+std::integral_constant<int, K> taylor_order_impl(const FloatTaylor<T, K>*);
+template <typename T>
+using taylor_order = decltype(taylor_order_impl(std::declval<T*>()));
+
+template <typename T1, typename T2>
+constexpr int taylor_order_v = taylor_order<T1>::value > taylor_order<T2>::value
+                               ? taylor_order<T1>::value : taylor_order<T2>::value;
+
+template <typename T1, typename T2>
+constexpr bool same_taylor_order_v = taylor_order<T1>::value == 0
+                                     || taylor_order<T2>::value == 0
+                                     || taylor_order<T1>::value == taylor_order<T2>::value;
+
+template <typename T1, typename T2>
+using is_float_taylor_operands =
+    std::bool_constant<is_float_taylor<T1>::value || is_float_taylor<T2>::value>;
+
+// Constant term. Non-Taylor operands are constants.
+template <typename T>
+inline __host__ __device__
+decltype(auto) get_taylor_data(const T& t) {
+    if constexpr (is_float_taylor<T>::value) {
+        return t.data();
+    } else {
+        return t;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Cauchy products
+/////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+struct TaylorMul {
+    template <typename A, typename B>
+    __host__ __device__
+    auto operator()(const A& a, const B& b) const {
+        return a * b;
+    }
+};
+
+} // namespace float_grad_detail
+
+// r[k] = sum_{j=0}^{k} op(a[j], b[k - j]). Constant operands only have a
+// zeroth coefficient, which reduces the sum to a single term.
+template <typename Op, typename T1, typename T2>
+inline __host__ __device__
+auto taylor_convolve(const T1& a, const T2& b, Op op) {
+    constexpr int K = taylor_order_v<T1, T2>;
+    static_assert(same_taylor_order_v<T1, T2>,
+                  "FloatTaylor operands must have the same order");
+    using Coeff = std::decay_t<decltype(op(get_taylor_data(a), get_taylor_data(b)))>;
+    FloatTaylor<Coeff, K> r;
+    for (int k = 0; k <= K; ++k) {
+        if constexpr (is_float_taylor<T1>::value && is_float_taylor<T2>::value) {
+            Coeff sum = op(a[0], b[k]);
+            for (int j = 1; j <= k; ++j) {
+                sum = sum + op(a[j], b[k - j]);
+            }
+            r[k] = sum;
+        } else if constexpr (is_float_taylor<T1>::value) {
+            r[k] = op(a[k], b);
+        } else {
+            r[k] = op(a, b[k]);
+        }
+    }
+    return r;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Arithmetic operators
+/////////////////////////////////////////////////////////////////////////////
+
+template <typename T, int K>
+inline __host__ __device__
+FloatTaylor<T, K> operator-(const FloatTaylor<T, K>& a) {
+    FloatTaylor<T, K> r;
+    for (int k = 0; k <= K; ++k) {
+        r[k] = -a[k];
+    }
+    return r;
+}
+
+template <typename T1, typename T2,
+          std::enable_if_t<is_float_taylor_operands<T1, T2>::value, int> = 0>
+inline __host__ __device__
+auto operator+(const T1& a, const T2& b) {
+    constexpr int K = taylor_order_v<T1, T2>;
+    static_assert(same_taylor_order_v<T1, T2>,
+                  "FloatTaylor operands must have the same order");
+    using Coeff = std::decay_t<decltype(get_taylor_data(a) + get_taylor_data(b))>;
+    FloatTaylor<Coeff, K> r;
+    r[0] = get_taylor_data(a) + get_taylor_data(b);
+    for (int k = 1; k <= K; ++k) {
+        if constexpr (is_float_taylor<T1>::value && is_float_taylor<T2>::value) {
+            r[k] = a[k] + b[k];
+        } else if constexpr (is_float_taylor<T1>::value) {
+            r[k] = a[k];
+        } else {
+            r[k] = b[k];
+        }
+    }
+    return r;
+}
+
+template <typename T1, typename T2,
+          std::enable_if_t<is_float_taylor_operands<T1, T2>::value, int> = 0>
+inline __host__ __device__
+auto operator-(const T1& a, const T2& b) {
+    constexpr int K = taylor_order_v<T1, T2>;
+    static_assert(same_taylor_order_v<T1, T2>,
+                  "FloatTaylor operands must have the same order");
+    using Coeff = std::decay_t<decltype(get_taylor_data(a) - get_taylor_data(b))>;
+    FloatTaylor<Coeff, K> r;
+    r[0] = get_taylor_data(a) - get_taylor_data(b);
+    for (int k = 1; k <= K; ++k) {
+        if constexpr (is_float_taylor<T1>::value && is_float_taylor<T2>::value) {
+            r[k] = a[k] - b[k];
+        } else if constexpr (is_float_taylor<T1>::value) {
+            r[k] = a[k];
+        } else {
+            r[k] = -b[k];
+        }
+    }
+    return r;
+}
+
+template <typename T1, typename T2,
+          std::enable_if_t<is_float_taylor_operands<T1, T2>::value, int> = 0>
+inline __host__ __device__
+auto operator*(const T1& a, const T2& b) {
+    return taylor_convolve(a, b, float_grad_detail::TaylorMul{});
+}
+
+// q[k] = (a[k] - sum_{j=1}^{k} b[j] q[k - j]) / b[0]
+template <typename T1, typename T2,
+          std::enable_if_t<is_float_taylor_operands<T1, T2>::value, int> = 0>
+inline __host__ __device__
+auto operator/(const T1& a, const T2& b) {
+    constexpr int K = taylor_order_v<T1, T2>;
+    static_assert(same_taylor_order_v<T1, T2>,
+                  "FloatTaylor operands must have the same order");
+    using Coeff = std::decay_t<decltype(get_taylor_data(a) / get_taylor_data(b))>;
+    FloatTaylor<Coeff, K> q;
+    if constexpr (!is_float_taylor<T2>::value) {
+        for (int k = 0; k <= K; ++k) {
+            q[k] = a[k] / b;
+        }
+    } else {
+        const float inv_b0 = 1.0f / b[0];
+        for (int k = 0; k <= K; ++k) {
+            Coeff sum;
+            if constexpr (is_float_taylor<T1>::value) {
+                sum = a[k];
+            } else {
+                sum = k == 0 ? Coeff(a) : Coeff{};
+            }
+            for (int j = 1; j <= k; ++j) {
+                sum = sum - b[j] * q[k - j];
+            }
+            q[k] = sum * inv_b0;
+        }
+    }
+    return q;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Elementary functions
+/////////////////////////////////////////////////////////////////////////////
+
+// e[k] = (1/k) sum_{j=1}^{k} j a[j] e[k - j]
+template <int K>
+inline __host__ __device__
+FloatTaylor<float, K> expf(const FloatTaylor<float, K>& a) {
+    FloatTaylor<float, K> e;
+    e[0] = expf(a[0]);
+    for (int k = 1; k <= K; ++k) {
+        float sum = 0.0f;
+        for (int j = 1; j <= k; ++j) {
+            sum += static_cast<float>(j) * a[j] * e[k - j];
+        }
+        e[k] = sum / static_cast<float>(k);
+    }
+    return e;
+}
+
+// s[k] = (a[k] - sum_{j=1}^{k-1} s[j] s[k - j]) / (2 s[0])
+template <int K>
+inline __host__ __device__
+FloatTaylor<float, K> sqrtf(const FloatTaylor<float, K>& a) {
+    FloatTaylor<float, K> s;
+    s[0] = sqrtf(a[0]);
+    const float inv_2s0 = 0.5f / s[0];
+    for (int k = 1; k <= K; ++k) {
+        float sum = a[k];
+        for (int j = 1; j < k; ++j) {
+            sum -= s[j] * s[k - j];
+        }
+        s[k] = sum * inv_2s0;
+    }
+    return s;
+}
+
+template <int K>
+inline __host__ __device__
+FloatTaylor<float, K> rsqrtf(const FloatTaylor<float, K>& a) {
+    return 1.0f / sqrtf(a);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Vector types
+/////////////////////////////////////////////////////////////////////////////
+
+template <typename VecType, typename CompType, int K>
+inline __host__ __device__
+FloatTaylor<CompType, K> taylor_component(const FloatTaylor<VecType, K>& t,
+                                          CompType VecType::*comp) {
+    FloatTaylor<CompType, K> r;
+    for (int k = 0; k <= K; ++k) {
+        r[k] = t[k].*comp;
+    }
+    return r;
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+auto get_x(const FloatTaylor<VecType, K>& t) {
+    return taylor_component(t, &VecType::x);
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+auto get_y(const FloatTaylor<VecType, K>& t) {
+    return taylor_component(t, &VecType::y);
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+auto get_z(const FloatTaylor<VecType, K>& t) {
+    return taylor_component(t, &VecType::z);
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+auto get_w(const FloatTaylor<VecType, K>& t) {
+    return taylor_component(t, &VecType::w);
+}
+
+template <int K>
+inline __host__ __device__
+FloatTaylor<float2, K> make_float2(const FloatTaylor<float, K>& x,
+                                   const FloatTaylor<float, K>& y) {
+    FloatTaylor<float2, K> r;
+    for (int k = 0; k <= K; ++k) {
+        r[k] = float2{x[k], y[k]};
+    }
+    return r;
+}
+
+template <int K>
+inline __host__ __device__
+FloatTaylor<float3, K> make_float3(const FloatTaylor<float, K>& x,
+                                   const FloatTaylor<float, K>& y,
+                                   const FloatTaylor<float, K>& z) {
+    FloatTaylor<float3, K> r;
+    for (int k = 0; k <= K; ++k) {
+        r[k] = float3{x[k], y[k], z[k]};
+    }
+    return r;
+}
+
+template <int K>
+inline __host__ __device__
+FloatTaylor<float4, K> make_float4(const FloatTaylor<float, K>& x,
+                                   const FloatTaylor<float, K>& y,
+                                   const FloatTaylor<float, K>& z,
+                                   const FloatTaylor<float, K>& w) {
+    FloatTaylor<float4, K> r;
+    for (int k = 0; k <= K; ++k) {
+        r[k] = float4{x[k], y[k], z[k], w[k]};
+    }
+    return r;
+}
+
+#endif // FLOAT_GRAD_TAYLOR_H
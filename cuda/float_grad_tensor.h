@@ -0,0 +1,243 @@
+#ifndef FLOAT_GRAD_TENSOR_H
+#define FLOAT_GRAD_TENSOR_H
+
+#include <cstdint>
+
+#include "float_grad_base.h"
+#include "float_grad_array.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Strided N-dimensional view of duals, in the spirit of std::mdspan. The
+/// primal and tangent planes have their own strides, in elements, so one
+/// view type covers planar storage, interleaved (primal, tangent) pairs and
+/// transposed or sliced torch tensors without copies. Offsets are 64-bit.
+///
+///     FloatGradTensor<float, 2> m(data, grad, {rows, cols});
+///     m(i, j) = m(i, j) * 2.0f;            // FloatGradRef to element (i, j)
+///     FloatGradTensor<float, 2> mt = m.transpose(0, 1);
+///
+/// A view with a null grad pointer only holds primals: data(...) is valid on
+/// it, operator() is not.
+///
+/// With N > 1 tangents, grad points to the first of N contiguous lanes per
+/// element and operator() returns a FloatGradRef<FloatType, N>. A
+/// contiguous [..., 1 + N] buffer, with every primal followed by its
+/// tangents, is then viewed with grad = data + 1.
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename FloatType, int Rank, int N = 1>
+struct FloatGradTensor {
+    static_assert(Rank >= 1, "FloatGradTensor needs at least one dimension");
+    static_assert(N >= 1, "FloatGradTensor needs at least one tangent");
+
+    using GradType = tangent_t<FloatType, N>;
+
+    FloatType* data_;
+    FloatType* grad_;
+    int64_t shape_[Rank];
+    int64_t data_strides_[Rank];
+    int64_t grad_strides_[Rank];
+
+    __host__ __device__
+    FloatGradTensor() : data_(nullptr), grad_(nullptr), shape_{}, data_strides_{}, grad_strides_{} {}
+
+    // Row-major planes
+    __host__ __device__
+    FloatGradTensor(FloatType* data, FloatType* grad, const int64_t (&shape)[Rank])
+        : data_(data), grad_(grad) {
+        int64_t stride = 1;
+        for (int d = Rank - 1; d >= 0; --d) {
+            shape_[d] = shape[d];
+            data_strides_[d] = stride;
+            grad_strides_[d] = stride;
+            stride *= shape[d];
+        }
+    }
+
+    __host__ __device__
+    FloatGradTensor(FloatType* data, FloatType* grad, const int64_t (&shape)[Rank],
+                    const int64_t (&data_strides)[Rank], const int64_t (&grad_strides)[Rank])
+        : data_(data), grad_(grad) {
+        for (int d = 0; d < Rank; ++d) {
+            shape_[d] = shape[d];
+            data_strides_[d] = data_strides[d];
+            grad_strides_[d] = grad_strides[d];
+        }
+    }
+
+    // Row-major view of the planes of a FloatGradArray
+    __host__ __device__
+    FloatGradTensor(const FloatGradArray<FloatType>& array, const int64_t (&shape)[Rank])
+        : FloatGradTensor(array.data_arr_, array.grad_arr_, shape) {}
+
+    // Row-major view of interleaved (primal, tangent) pairs
+    __host__ __device__
+    FloatGradTensor(const FloatGradInterleavedArray<FloatType>& array, const int64_t (&shape)[Rank])
+        : FloatGradTensor(array.pairs_, array.pairs_ + 1, shape) {
+        for (int d = 0; d < Rank; ++d) {
+            data_strides_[d] *= FloatGradInterleavedArray<FloatType>::stride;
+            grad_strides_[d] *= FloatGradInterleavedArray<FloatType>::stride;
+        }
+    }
+
+    // Read-only view of a mutable one
+    template <typename OtherType,
+              typename = std::enable_if_t<std::is_same_v<const OtherType, FloatType>
+                                          && !std::is_same_v<OtherType, FloatType>>>
+    __host__ __device__
+    FloatGradTensor(const FloatGradTensor<OtherType, Rank, N>& other)
+        : FloatGradTensor(other.data_, other.grad_, other.shape_,
+                          other.data_strides_, other.grad_strides_) {}
+
+    __host__ __device__
+    int64_t size(int dim) const {
+        return shape_[dim];
+    }
+
+    __host__ __device__
+    int64_t data_stride(int dim) const {
+        return data_strides_[dim];
+    }
+
+    __host__ __device__
+    int64_t grad_stride(int dim) const {
+        return grad_strides_[dim];
+    }
+
+    __host__ __device__
+    int64_t numel() const {
+        int64_t n = 1;
+        for (int d = 0; d < Rank; ++d) {
+            n *= shape_[d];
+        }
+        return n;
+    }
+
+    __host__ __device__
+    bool has_grad() const {
+        return grad_ != nullptr;
+    }
+
+    template <typename... Index>
+    __host__ __device__
+    int64_t data_offset(Index... index) const {
+        return offset(data_strides_, index...);
+    }
+
+    template <typename... Index>
+    __host__ __device__
+    int64_t grad_offset(Index... index) const {
+        return offset(grad_strides_, index...);
+    }
+
+    template <typename... Index>
+    __host__ __device__
+    FloatType& data(Index... index) const {
+        return data_[data_offset(index...)];
+    }
+
+    template <typename... Index>
+    __host__ __device__
+    GradType& grad(Index... index) const {
+        return *reinterpret_cast<GradType*>(grad_ + grad_offset(index...));
+    }
+
+    template <typename... Index>
+    __host__ __device__
+    FloatGradRef<FloatType, N> operator()(Index... index) const {
+        return FloatGradRef<FloatType, N>(data_ + data_offset(index...), &grad(index...));
+    }
+
+    // Swaps two dimensions, e.g. transpose(0, 1) of a matrix
+    __host__ __device__
+    FloatGradTensor transpose(int dim0, int dim1) const {
+        FloatGradTensor t = *this;
+        swap(t.shape_[dim0], t.shape_[dim1]);
+        swap(t.data_strides_[dim0], t.data_strides_[dim1]);
+        swap(t.grad_strides_[dim0], t.grad_strides_[dim1]);
+        return t;
+    }
+
+    // Elements [start, start + length) of one dimension
+    __host__ __device__
+    FloatGradTensor narrow(int dim, int64_t start, int64_t length) const {
+        FloatGradTensor t = *this;
+        t.data_ += start * data_strides_[dim];
+        if (grad_ != nullptr) {
+            t.grad_ += start * grad_strides_[dim];
+        }
+        t.shape_[dim] = length;
+        return t;
+    }
+
+    // Drops a dimension at a fixed index, e.g. select(0, i) is row i
+    template <int R = Rank, typename = std::enable_if_t<(R > 1)>>
+    __host__ __device__
+    FloatGradTensor<FloatType, R - 1, N> select(int dim, int64_t index) const {
+        FloatGradTensor<FloatType, R - 1, N> t;
+        t.data_ = data_ + index * data_strides_[dim];
+        t.grad_ = grad_ != nullptr ? grad_ + index * grad_strides_[dim] : nullptr;
+        for (int d = 0, e = 0; d < Rank; ++d) {
+            if (d != dim) {
+                t.shape_[e] = shape_[d];
+                t.data_strides_[e] = data_strides_[d];
+                t.grad_strides_[e] = grad_strides_[d];
+                ++e;
+            }
+        }
+        return t;
+    }
+
+    // Same view without its tangent plane
+    __host__ __device__
+    FloatGradTensor primals() const {
+        FloatGradTensor t = *this;
+        t.grad_ = nullptr;
+        return t;
+    }
+
+    // Whether both planes are row-major without gaps
+    __host__ __device__
+    bool is_contiguous() const {
+        int64_t stride = 1;
+        for (int d = Rank - 1; d >= 0; --d) {
+            if (shape_[d] != 1 && (data_strides_[d] != stride || grad_strides_[d] != stride)) {
+                return false;
+            }
+            stride *= shape_[d];
+        }
+        return true;
+    }
+
+    __host__ __device__
+    FloatType* data_ptr() const {
+        return data_;
+    }
+
+    __host__ __device__
+    FloatType* grad_ptr() const {
+        return grad_;
+    }
+
+private:
+    template <typename... Index>
+    __host__ __device__
+    static int64_t offset(const int64_t (&strides)[Rank], Index... index) {
+        static_assert(sizeof...(Index) == Rank, "FloatGradTensor needs one index per dimension");
+        const int64_t idx[Rank] = {static_cast<int64_t>(index)...};
+        int64_t off = 0;
+        for (int d = 0; d < Rank; ++d) {
+            off += idx[d] * strides[d];
+        }
+        return off;
+    }
+
+    __host__ __device__
+    static void swap(int64_t& a, int64_t& b) {
+        const int64_t t = a;
+        a = b;
+        b = t;
+    }
+};
+
+#endif // FLOAT_GRAD_TENSOR_H
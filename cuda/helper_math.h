@@ -39,7 +39,7 @@
 #ifndef HELPER_MATH_H
 #define HELPER_MATH_H
 
-#include "cuda_runtime.h"
+#include "cuda/cuda_compat.h"
 #include "float_grad.h"
 
 typedef unsigned int uint;
@@ -71,20 +71,26 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float_type<T1>::value && is_float_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float>>
-fminf(T1 a, T2 b) { return a < b ? FloatGrad<float>(a) : FloatGrad<float>(b); }
+                 float_grad_result_t<float, T1, T2>>
+fminf(T1 a, T2 b) {
+    using Result = float_grad_result_t<float, T1, T2>;
+    return a < b ? Result(a) : Result(b);
+}
 
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float_type<T1>::value && is_float_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float>>
-fmaxf(T1 a, T2 b) { return a > b ? FloatGrad<float>(a) : FloatGrad<float>(b); }
+                 float_grad_result_t<float, T1, T2>>
+fmaxf(T1 a, T2 b) {
+    using Result = float_grad_result_t<float, T1, T2>;
+    return a > b ? Result(a) : Result(b);
+}
 
 template <typename T1, typename = std::enable_if_t<is_float_type<T1>::value
                                                    && is_float_grad<T1>::value>>
 inline __host__ __device__
-FloatGrad<float> rsqrtf(T1 x) { return 1.0f / sqrtf(x); }
+float_grad_result_t<float, T1> rsqrtf(T1 x) { return 1.0f / sqrtf(x); }
 
 ////////////////////////////////////////////////////////////////////////////////
 // constructors
@@ -101,12 +107,14 @@ inline __host__ __device__ float2 make_float2(uint2 a) {
 
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float2>>
+std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float2, T1>>
 make_float2(T1 s) { return make_float2(s, s); }
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float3_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float2>>
-make_float2(T1 a) { return make_float2(a.x, a.y); }
+std::enable_if_t<is_float3_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float2, T1>>
+make_float2(T1 a) { return make_float2(get_x(a), get_y(a)); }
 
 inline __host__ __device__ int2 make_int2(int s) { return make_int2(s, s); }
 inline __host__ __device__ int2 make_int2(int3 a) { return make_int2(a.x, a.y); }
@@ -132,24 +140,26 @@ inline __host__ __device__ float3 make_float3(uint3 a) {
 
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float3>>
+std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float3, T1>>
 make_float3(T1 s) { return make_float3(s, s, s); }
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float2_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float3>>
-make_float3(T1 a) { return make_float2(a.x, a.y, 0.0f); }
+std::enable_if_t<is_float2_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float3, T1>>
+make_float3(T1 a) { return make_float2(get_x(a), get_y(a), 0.0f); }
 template <typename T1, typename T2>
 inline __host__ __device__ 
 std::enable_if_t<is_float2_type<T1>::value
                  && is_float_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float3>>
-make_float3(T1 a, T2 s) { return make_float3(a.x, a.y, s); }
+                 float_grad_result_t<float3, T1, T2>>
+make_float3(T1 a, T2 s) { return make_float3(get_x(a), get_y(a), s); }
 template <typename T1>
 inline __host__ __device__ 
 std::enable_if_t<is_float4_type<T1>::value && is_float_grad<T1>::value,
-                 FloatGrad<float3>>
-make_float3(T1 a) { return make_float3(a.x, a.y, a.z); }
+                 float_grad_result_t<float3, T1>>
+make_float3(T1 a) { return make_float3(get_x(a), get_y(a), get_z(a)); }
 
 inline __host__ __device__ int3 make_int3(int s) { return make_int3(s, s, s); }
 inline __host__ __device__ int3 make_int3(int2 a) { return make_int3(a.x, a.y, 0); }
@@ -183,19 +193,21 @@ inline __host__ __device__ float4 make_float4(uint4 a) {
 
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float4>>
+std::enable_if_t<is_float_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float4, T1>>
 make_float4(T1 s) { return make_float4(s, s, s, s); }
 template <typename T1>
 inline __host__ __device__ 
-std::enable_if_t<is_float3_type<T1>::value && is_float_grad<T1>::value, FloatGrad<float4>>
-make_float4(T1 a) { return make_float4(a.x, a.y, a.z, 0.0f); }
+std::enable_if_t<is_float3_type<T1>::value && is_float_grad<T1>::value,
+                 float_grad_result_t<float4, T1>>
+make_float4(T1 a) { return make_float4(get_x(a), get_y(a), get_z(a), 0.0f); }
 template <typename T1, typename T2>
 inline __host__ __device__ 
 std::enable_if_t<is_float3_type<T1>::value
                  && is_float_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float4>>
-make_float4(T1 a, T2 s) { return make_float4(a.x, a.y, a.z, s); }
+                 float_grad_result_t<float4, T1, T2>>
+make_float4(T1 a, T2 s) { return make_float4(get_x(a), get_y(a), get_z(a), s); }
 
 inline __host__ __device__ int4 make_int4(int s) { return make_int4(s, s, s, s); }
 inline __host__ __device__ int4 make_int4(int3 a) { return make_int4(a.x, a.y, a.z, 0); }
@@ -231,16 +243,19 @@ inline __host__ __device__ int4 operator-(const int4 &a) { return make_int4(-a.x
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value, FloatGrad<float2>>
-operator-(const T &a) { return make_float2(-a.x, -a.y); }
+std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float2, T>>
+operator-(const T &a) { return make_float2(-get_x(a), -get_y(a)); }
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value, FloatGrad<float3>>
-operator-(const T &a) { return make_float3(-a.x, -a.y, -a.z); }
+std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float3, T>>
+operator-(const T &a) { return make_float3(-get_x(a), -get_y(a), -get_z(a)); }
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value, FloatGrad<float4>>
-operator-(const T &a) { return make_float4(-a.x, -a.y, -a.z, -a.w); }
+std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float4, T>>
+operator-(const T &a) { return make_float4(-get_x(a), -get_y(a), -get_z(a), -get_w(a)); }
 
 ////////////////////////////////////////////////////////////////////////////////
 // addition
@@ -850,26 +865,27 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float2_type<T1>::value && is_float2_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float2>>
+                 float_grad_result_t<float2, T1, T2>>
 fminf(T1 a, T2 b) {
-    return make_float2(fminf(a.x, b.x), fminf(a.y, b.y));
+    return make_float2(fminf(get_x(a), get_x(b)), fminf(get_y(a), get_y(b)));
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2>>
 fminf(T1 a, T2 b) {
-    return make_float3(fminf(a.x, b.x), fminf(a.y, b.y), fminf(a.z, b.z));
+    return make_float3(fminf(get_x(a), get_x(b)), fminf(get_y(a), get_y(b)),
+                       fminf(get_z(a), get_z(b)));
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float4_type<T1>::value && is_float4_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float4>>
+                 float_grad_result_t<float4, T1, T2>>
 fminf(T1 a, T2 b) {
-    return make_float4(fminf(a.x, b.x), fminf(a.y, b.y),
-                       fminf(a.z, b.z), fminf(a.w, b.w));
+    return make_float4(fminf(get_x(a), get_x(b)), fminf(get_y(a), get_y(b)),
+                       fminf(get_z(a), get_z(b)), fminf(get_w(a), get_w(b)));
 }
 
 inline __host__ __device__ int2 min(int2 a, int2 b) {
@@ -910,26 +926,27 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float2_type<T1>::value && is_float2_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float2>>
+                 float_grad_result_t<float2, T1, T2>>
 fmaxf(T1 a, T2 b) {
-    return make_float2(fmaxf(a.x, b.x), fmaxf(a.y, b.y));
+    return make_float2(fmaxf(get_x(a), get_x(b)), fmaxf(get_y(a), get_y(b)));
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2>>
 fmaxf(T1 a, T2 b) {
-    return make_float3(fmaxf(a.x, b.x), fmaxf(a.y, b.y), fmaxf(a.z, b.z));
+    return make_float3(fmaxf(get_x(a), get_x(b)), fmaxf(get_y(a), get_y(b)),
+                       fmaxf(get_z(a), get_z(b)));
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float4_type<T1>::value && is_float4_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float4>>
+                 float_grad_result_t<float4, T1, T2>>
 fmaxf(T1 a, T2 b) {
-    return make_float4(fmaxf(a.x, b.x), fmaxf(a.y, b.y),
-                       fmaxf(a.z, b.z), fmaxf(a.w, b.w));
+    return make_float4(fmaxf(get_x(a), get_x(b)), fmaxf(get_y(a), get_y(b)),
+                       fmaxf(get_z(a), get_z(b)), fmaxf(get_w(a), get_w(b)));
 }
 
 inline __host__ __device__ int2 max(int2 a, int2 b) {
@@ -970,7 +987,7 @@ std::enable_if_t<is_float_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float>>
+                 float_grad_result_t<float, T1, T2, T3>>
 lerp(T1 a, T2 b, T3 t) { return a + t * (b - a); }
 
 template <typename T1, typename T2, typename T3>
@@ -981,7 +998,7 @@ std::enable_if_t<is_float2_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float2>>
+                 float_grad_result_t<float2, T1, T2, T3>>
 lerp(T1 a, T2 b, T3 t) { return a + t * (b - a); }
 
 template <typename T1, typename T2, typename T3>
@@ -992,7 +1009,7 @@ std::enable_if_t<is_float3_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value),
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2, T3>>
 lerp(T1 a, T2 b, T3 t) { return a + t * (b - a); }
 
 template <typename T1, typename T2, typename T3>
@@ -1003,7 +1020,7 @@ std::enable_if_t<is_float4_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value),
-                 FloatGrad<float4>>
+                 float_grad_result_t<float4, T1, T2, T3>>
 lerp(T1 a, T2 b, T3 t) { return a + t * (b - a); }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1043,7 +1060,7 @@ std::enable_if_t<is_float_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float>>
+                 float_grad_result_t<float, T1, T2, T3>>
 clamp(T1 f, T2 a, T3 b) { return fmaxf(a, fminf(f, b)); }
 template <typename T1, typename T2, typename T3>
 inline __device__ __host__
@@ -1053,13 +1070,14 @@ std::enable_if_t<is_float2_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float2>>
+                 float_grad_result_t<float2, T1, T2, T3>>
 clamp(T1 v, T2 a, T3 b) { 
     if constexpr (is_float_type<T2>::value && is_float_type<T3>::value) {
-        return make_float2(clamp(v.x, a, b), clamp(v.y, a, b)); 
+        return make_float2(clamp(get_x(v), a, b), clamp(get_y(v), a, b)); 
     } 
     else if constexpr (is_float2_type<T2>::value && is_float2_type<T3>::value) {
-        return make_float2(clamp(v.x, a.x, b.x), clamp(v.y, a.y, b.y));
+        return make_float2(clamp(get_x(v), get_x(a), get_x(b)),
+                           clamp(get_y(v), get_y(a), get_y(b)));
     }
     else {
         static_assert(always_false<T1>::value 
@@ -1075,13 +1093,15 @@ std::enable_if_t<is_float3_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2, T3>>
 clamp(T1 v, T2 a, T3 b) { 
     if constexpr (is_float_type<T2>::value && is_float_type<T3>::value) {
-        return make_float3(clamp(v.x, a, b), clamp(v.y, a, b), clamp(v.z, a, b)); 
+        return make_float3(clamp(get_x(v), a, b), clamp(get_y(v), a, b), clamp(get_z(v), a, b)); 
     } 
     else if constexpr (is_float3_type<T2>::value && is_float3_type<T3>::value) {
-        return make_float3(clamp(v.x, a.x, b.x), clamp(v.y, a.y, b.y), clamp(v.z, a.z, b.z));
+        return make_float3(clamp(get_x(v), get_x(a), get_x(b)),
+                           clamp(get_y(v), get_y(a), get_y(b)),
+                           clamp(get_z(v), get_z(a), get_z(b)));
     }
     else {
         static_assert(always_false<T1>::value 
@@ -1097,15 +1117,17 @@ std::enable_if_t<is_float4_type<T1>::value
                  && (is_float_grad<T1>::value 
                      || is_float_grad<T2>::value 
                      || is_float_grad<T3>::value), 
-                 FloatGrad<float4>>
+                 float_grad_result_t<float4, T1, T2, T3>>
 clamp(T1 v, T2 a, T3 b) { 
     if constexpr (is_float_type<T2>::value && is_float_type<T3>::value) {
-        return make_float4(clamp(v.x, a, b), clamp(v.y, a, b), 
-                           clamp(v.z, a, b), clamp(v.w, a, b));
+        return make_float4(clamp(get_x(v), a, b), clamp(get_y(v), a, b), 
+                           clamp(get_z(v), a, b), clamp(get_w(v), a, b));
     } 
     else if constexpr (is_float4_type<T2>::value && is_float4_type<T3>::value) {
-        return make_float4(clamp(v.x, a.x, b.x), clamp(v.y, a.y, b.y), 
-                           clamp(v.z, a.z, b.z), clamp(v.w, a.w, b.w));
+        return make_float4(clamp(get_x(v), get_x(a), get_x(b)),
+                           clamp(get_y(v), get_y(a), get_y(b)),
+                           clamp(get_z(v), get_z(a), get_z(b)),
+                           clamp(get_w(v), get_w(a), get_w(b)));
     }
     else {
         static_assert(always_false<T1>::value 
@@ -1170,25 +1192,25 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float2_type<T1>::value && is_float2_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float>>
+                 float_grad_result_t<float, T1, T2>>
 dot(T1 a, T2 b) { 
-    return a.x * b.x + a.y * b.y;
+    return get_x(a) * get_x(b) + get_y(a) * get_y(b);
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float>>
+                 float_grad_result_t<float, T1, T2>>
 dot(T1 a, T2 b) { 
-    return a.x * b.x + a.y * b.y + a.z * b.z;
+    return get_x(a) * get_x(b) + get_y(a) * get_y(b) + get_z(a) * get_z(b);
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float4_type<T1>::value && is_float4_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float>>
+                 float_grad_result_t<float, T1, T2>>
 dot(T1 a, T2 b) { 
-    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    return get_x(a) * get_x(b) + get_y(a) * get_y(b) + get_z(a) * get_z(b) + get_w(a) * get_w(b);
 }
 
 inline __host__ __device__ int dot(int2 a, int2 b) { return a.x * b.x + a.y * b.y; }
@@ -1216,7 +1238,7 @@ inline __host__ __device__
 std::enable_if_t<(is_float2_type<T>::value
                   || is_float3_type<T>::value
                   || is_float4_type<T>::value)
-                  && is_float_grad<T>::value, FloatGrad<float>>
+                  && is_float_grad<T>::value, float_grad_result_t<float, T>>
 length(T v) { 
     return sqrtf(dot(v, v));
 }
@@ -1245,7 +1267,7 @@ std::enable_if_t<(is_float2_type<T>::value
                   || is_float4_type<T>::value)
                   && is_float_grad<T>::value, T>
 normalize(T v) { 
-    FloatGrad<float> invLen = rsqrtf(dot(v, v));
+    float_grad_result_t<float, T> invLen = rsqrtf(dot(v, v));
     return v * invLen;
 }
 
@@ -1263,18 +1285,23 @@ inline __host__ __device__ float4 floorf(float4 v) {
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value, FloatGrad<float2>>
-floorf(T v) { return make_float2(floorf(v.x), floorf(v.y)); }
+std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float2, T>>
+floorf(T v) { return make_float2(floorf(get_x(v)), floorf(get_y(v))); }
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value, FloatGrad<float3>>
-floorf(T v) { return make_float3(floorf(v.x), floorf(v.y), floorf(v.z)); }
+std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float3, T>>
+floorf(T v) { return make_float3(floorf(get_x(v)), floorf(get_y(v)), floorf(get_z(v))); }
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value, FloatGrad<float4>>
-floorf(T v) { return make_float4(floorf(v.x), floorf(v.y), floorf(v.z), floorf(v.w)); }
+std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float4, T>>
+floorf(T v) {
+    return make_float4(floorf(get_x(v)), floorf(get_y(v)), floorf(get_z(v)), floorf(get_w(v)));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // frac - returns the fractional portion of a scalar or each vector component
@@ -1291,23 +1318,29 @@ inline __host__ __device__ float4 fracf(float4 v) {
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float_type<T>::value && is_float_grad<T>::value, FloatGrad<float>>
+std::enable_if_t<is_float_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float, T>>
 fracf(T v) { return v - floorf(v); }
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value, FloatGrad<float2>>
-fracf(T v) { return make_float2(fracf(v.x), fracf(v.y)); }
+std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float2, T>>
+fracf(T v) { return make_float2(fracf(get_x(v)), fracf(get_y(v))); }
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value, FloatGrad<float3>>
-fracf(T v) { return make_float3(fracf(v.x), fracf(v.y), fracf(v.z)); }
+std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float3, T>>
+fracf(T v) { return make_float3(fracf(get_x(v)), fracf(get_y(v)), fracf(get_z(v))); }
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value, FloatGrad<float4>>
-fracf(T v) { return make_float4(fracf(v.x), fracf(v.y), fracf(v.z), fracf(v.w)); }
+std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float4, T>>
+fracf(T v) {
+    return make_float4(fracf(get_x(v)), fracf(get_y(v)), fracf(get_z(v)), fracf(get_w(v)));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // fmod
@@ -1327,26 +1360,27 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float2_type<T1>::value && is_float2_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float2>>
+                 float_grad_result_t<float2, T1, T2>>
 fmodf(T1 a, T2 b) { 
-    return make_float2(fmodf(a.x, b.x), fmodf(a.y, b.y)); 
+    return make_float2(fmodf(get_x(a), get_x(b)), fmodf(get_y(a), get_y(b))); 
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2>>
 fmodf(T1 a, T2 b) { 
-    return make_float3(fmodf(a.x, b.x), fmodf(a.y, b.y), fmodf(a.z, b.z));
+    return make_float3(fmodf(get_x(a), get_x(b)), fmodf(get_y(a), get_y(b)),
+                       fmodf(get_z(a), get_z(b)));
 }
 template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float4_type<T1>::value && is_float4_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value), 
-                 FloatGrad<float4>>
+                 float_grad_result_t<float4, T1, T2>>
 fmodf(T1 a, T2 b) { 
-    return make_float4(fmodf(a.x, b.x), fmodf(a.y, b.y), 
-                       fmodf(a.z, b.z), fmodf(a.w, b.w));
+    return make_float4(fmodf(get_x(a), get_x(b)), fmodf(get_y(a), get_y(b)), 
+                       fmodf(get_z(a), get_z(b)), fmodf(get_w(a), get_w(b)));
 }
 
 
@@ -1364,16 +1398,19 @@ inline __host__ __device__ float4 fabs(float4 v) {
 
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value, FloatGrad<float2>>
-fabs(T v) { return make_float2(fabs(v.x), fabs(v.y)); }
+std::enable_if_t<is_float2_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float2, T>>
+fabs(T v) { return make_float2(fabs(get_x(v)), fabs(get_y(v))); }
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value, FloatGrad<float3>>
-fabs(T v) { return make_float3(fabs(v.x), fabs(v.y), fabs(v.z)); }
+std::enable_if_t<is_float3_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float3, T>>
+fabs(T v) { return make_float3(fabs(get_x(v)), fabs(get_y(v)), fabs(get_z(v))); }
 template <typename T>
 inline __host__ __device__
-std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value, FloatGrad<float4>>
-fabs(T v) { return make_float4(fabs(v.x), fabs(v.y), fabs(v.z), fabs(v.w)); }
+std::enable_if_t<is_float4_type<T>::value && is_float_grad<T>::value,
+                 float_grad_result_t<float4, T>>
+fabs(T v) { return make_float4(fabs(get_x(v)), fabs(get_y(v)), fabs(get_z(v)), fabs(get_w(v))); }
 
 inline __host__ __device__ int2 abs(int2 v) { return make_int2(abs(v.x), abs(v.y)); }
 inline __host__ __device__ int3 abs(int3 v) { return make_int3(abs(v.x), abs(v.y), abs(v.z)); }
@@ -1393,7 +1430,7 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2>>
 reflect(T1 i, T2 n) { 
   return i - 2.0f * n * dot(n, i); 
 }
@@ -1410,9 +1447,11 @@ template <typename T1, typename T2>
 inline __host__ __device__
 std::enable_if_t<is_float3_type<T1>::value && is_float3_type<T2>::value
                  && (is_float_grad<T1>::value || is_float_grad<T2>::value),
-                 FloatGrad<float3>>
+                 float_grad_result_t<float3, T1, T2>>
 cross(T1 a, T2 b) { 
-  return make_float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+  return make_float3(get_y(a) * get_z(b) - get_z(a) * get_y(b),
+                     get_z(a) * get_x(b) - get_x(a) * get_z(b),
+                     get_x(a) * get_y(b) - get_y(a) * get_x(b));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1449,22 +1488,22 @@ auto smoothstep(T1 a, T2 b, T3 x) {
   if constexpr (is_float_type<T1>::value 
                 && is_float_type<T2>::value 
                 && is_float_type<T3>::value) {
-    FloatGrad<float> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
+    float_grad_result_t<float, T1, T2, T3> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
     return (y * y * (3.0f - (2.0f * y)));
   } else if constexpr (is_float2_type<T1>::value 
                        && is_float2_type<T2>::value 
                        && is_float2_type<T3>::value) {
-    FloatGrad<float2> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
+    float_grad_result_t<float2, T1, T2, T3> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
     return (y * y * (make_float2(3.0f) - (make_float2(2.0f) * y)));
   } else if constexpr (is_float3_type<T1>::value 
                        && is_float3_type<T2>::value 
                        && is_float3_type<T3>::value) {
-    FloatGrad<float3> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
+    float_grad_result_t<float3, T1, T2, T3> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
     return (y * y * (make_float3(3.0f) - (make_float3(2.0f) * y)));
   } else if constexpr (is_float4_type<T1>::value 
                        && is_float4_type<T2>::value 
                        && is_float4_type<T3>::value) {
-    FloatGrad<float4> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
+    float_grad_result_t<float4, T1, T2, T3> y = clamp((x - a) / (b - a), 0.0f, 1.0f);
     return (y * y * (make_float4(3.0f) - (make_float4(2.0f) * y)));
   } else {
     static_assert(always_false<T1>::value 
@@ -1473,4 +1512,57 @@ auto smoothstep(T1 a, T2 b, T3 x) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FloatTaylor vector operations
+// - Cauchy products of the builtin vector operations over the coefficients
+////////////////////////////////////////////////////////////////////////////////
+
+namespace float_grad_detail {
+
+struct TaylorDot {
+    template <typename A, typename B>
+    __host__ __device__
+    auto operator()(const A& a, const B& b) const {
+        return dot(a, b);
+    }
+};
+
+struct TaylorCross {
+    template <typename A, typename B>
+    __host__ __device__
+    auto operator()(const A& a, const B& b) const {
+        return cross(a, b);
+    }
+};
+
+} // namespace float_grad_detail
+
+template <typename T1, typename T2>
+inline __host__ __device__
+std::enable_if_t<is_float_taylor_operands<T1, T2>::value,
+                 FloatTaylor<float, taylor_order_v<T1, T2>>>
+dot(const T1& a, const T2& b) {
+    return taylor_convolve(a, b, float_grad_detail::TaylorDot{});
+}
+
+template <typename T1, typename T2>
+inline __host__ __device__
+std::enable_if_t<is_float_taylor_operands<T1, T2>::value,
+                 FloatTaylor<float3, taylor_order_v<T1, T2>>>
+cross(const T1& a, const T2& b) {
+    return taylor_convolve(a, b, float_grad_detail::TaylorCross{});
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+FloatTaylor<float, K> length(const FloatTaylor<VecType, K>& v) {
+    return sqrtf(dot(v, v));
+}
+
+template <typename VecType, int K>
+inline __host__ __device__
+FloatTaylor<VecType, K> normalize(const FloatTaylor<VecType, K>& v) {
+    return v / length(v);
+}
+
 #endif
@@ -0,0 +1,95 @@
+#ifndef HOST_LAUNCH_H
+#define HOST_LAUNCH_H
+
+#include <cstdint>
+#include <utility>
+
+#include "cuda/cuda_compat.h"
+
+#ifdef FLOAT_GRAD_HOST_LAUNCH
+#include "float_grad_parallel.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// One launch syntax for __global__ kernels on both targets. Under nvcc
+/// launch_kernel is a <<<grid, block>>> launch. Host compilers run the
+/// same kernel source on an emulated grid: blocks are spread over a
+/// ThreadPool and the threads of a block run in order as a loop over x, y
+/// and z, with the built-in threadIdx, blockIdx, blockDim and gridDim set
+/// for each. The kernel is a template argument, so it inlines into that
+/// loop and the compiler can vectorize across threadIdx.x as it would a
+/// plain for loop.
+///
+///     launch_kernel<matmul_kernel<float, float, float>>(grid, block, A, B, C);
+///
+/// Threads of a block run one after the other to completion, so kernels
+/// that synchronize within a block (__syncthreads, shared memory exchanged
+/// between threads) are not supported on the host, and neither are dynamic
+/// shared memory or streams. Blocks must be independent, as on a GPU.
+//////////////////////////////////////////////////////////////////////////////
+
+#ifdef FLOAT_GRAD_HOST_LAUNCH
+
+// Runs blocks [begin, end) of the grid, by linear index with x fastest, on
+// the calling thread. host_launch splits the grid over a ThreadPool with
+// it; other schedulers, such as at::parallel_for in the torch extension,
+// can call it on their own ranges of blocks.
+template <auto Kernel, typename... Args>
+inline void host_launch_blocks(dim3 grid, dim3 block, int64_t begin, int64_t end, Args&... args) {
+    gridDim = grid;
+    blockDim = block;
+    for (int64_t b = begin; b < end; ++b) {
+        blockIdx.x = static_cast<unsigned int>(b % grid.x);
+        blockIdx.y = static_cast<unsigned int>(b / grid.x % grid.y);
+        blockIdx.z = static_cast<unsigned int>(b / grid.x / grid.y);
+        for (unsigned int z = 0; z < block.z; ++z) {
+            threadIdx.z = z;
+            for (unsigned int y = 0; y < block.y; ++y) {
+                threadIdx.y = y;
+                for (unsigned int x = 0; x < block.x; ++x) {
+                    threadIdx.x = x;
+                    Kernel(args...);
+                }
+            }
+        }
+    }
+}
+
+// Blocks per scheduled range: at least 64k emulated threads, so that small
+// grids do not pay for waking a thread pool
+inline int64_t host_launch_grain(dim3 block) {
+    return (int64_t(1) << 16) / (int64_t(block.x) * block.y * block.z) + 1;
+}
+
+// Runs Kernel(args...) for every thread of every block of the grid, with
+// the blocks split over pool. Returns when all blocks have run.
+template <auto Kernel, typename... Args>
+void host_launch(ThreadPool& pool, dim3 grid, dim3 block, Args... args) {
+    const int64_t blocks = int64_t(grid.x) * grid.y * grid.z;
+    const int64_t threads = int64_t(block.x) * block.y * block.z;
+    if (blocks == 0 || threads == 0) {
+        return;
+    }
+    parallel_for(pool, blocks, host_launch_grain(block), [&](int64_t begin, int64_t end) {
+        host_launch_blocks<Kernel>(grid, block, begin, end, args...);
+    });
+}
+
+template <auto Kernel, typename... Args>
+void host_launch(dim3 grid, dim3 block, Args... args) {
+    host_launch<Kernel>(ThreadPool::global(), grid, block, std::move(args)...);
+}
+
+#endif // FLOAT_GRAD_HOST_LAUNCH
+
+// <<<grid, block>>> launch under nvcc, host_launch with host compilers
+template <auto Kernel, typename... Args>
+void launch_kernel(dim3 grid, dim3 block, Args&&... args) {
+#ifdef FLOAT_GRAD_HOST_LAUNCH
+    host_launch<Kernel>(grid, block, std::forward<Args>(args)...);
+#else
+    Kernel<<<grid, block>>>(std::forward<Args>(args)...);
+#endif
+}
+
+#endif // HOST_LAUNCH_H
@@ -0,0 +1,240 @@
+#ifndef JVP_DISPATCH_H
+#define JVP_DISPATCH_H
+
+#include <torch/extension.h>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "float_grad.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Dispatch of the extension launchers on which inputs carry a tangent.
+/// JVP tensors hold the primal followed by K tangents in a trailing
+/// dimension of size 1 + K; for K = 1 that is the memory layout of
+/// FloatGrad<float> when contiguous. Kernels read them through strided
+/// FloatGradTensor views, so transposed or sliced tensors need no copy. An
+/// input without that dimension, or whose tangents are all zero, is passive:
+/// the kernel is instantiated with plain float for it, which skips its
+/// product-rule terms, and reads only its primal. With K > 1 the kernels
+/// are instantiated for FloatGrad<float, N> lanes (dispatch_tangents), so
+/// one launch computes the primal once and K directional derivatives. The
+/// *_planar launchers take primals and tangents as separate tensors
+/// instead, as forward-mode AD holds them, with a missing tangent marking a
+/// passive input.
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct JvpTag {
+    using type = T;
+};
+
+// Strided view of a float32 tensor with Rank primal dimensions, optionally
+// followed by a dimension of size 1 + K holding the primal and K tangents.
+// The view has N tangent lanes, tangents [first_tangent, first_tangent + N)
+// of that dimension, which must then have unit stride if N > 1.
+// Transposed and sliced tensors are viewed in place. Without the trailing
+// dimension the view has no tangent plane.
+template <typename FloatType, int Rank, int N = 1>
+FloatGradTensor<FloatType, Rank, N> jvp_tensor(const torch::Tensor& t, int64_t first_tangent = 0) {
+    TORCH_CHECK(t.dtype() == torch::kFloat32, "JVP tensors must be float32");
+    TORCH_CHECK(t.dim() == Rank || (t.dim() == Rank + 1 && t.size(-1) >= 2),
+                "JVP tensors must have ", Rank, " dimensions or ", Rank + 1,
+                " with a last dimension of size 1 + K, the primal and K tangents");
+    int64_t shape[Rank], strides[Rank];
+    for (int d = 0; d < Rank; ++d) {
+        shape[d] = t.size(d);
+        strides[d] = t.stride(d);
+    }
+    FloatType* data = t.data_ptr<float>();
+    FloatType* grad = nullptr;
+    if (t.dim() > Rank) {
+        TORCH_CHECK(first_tangent + N < t.size(-1), "JVP tensor has fewer than ", first_tangent + N, " tangents");
+        TORCH_CHECK(N == 1 || t.stride(-1) == 1, "Tangent lanes of JVP tensors must have unit stride");
+        grad = data + (1 + first_tangent) * t.stride(-1);
+    }
+    return FloatGradTensor<FloatType, Rank, N>(data, grad, shape, strides, strides);
+}
+
+// Tangents per element of a JVP tensor with Rank primal dimensions: K for a
+// last dimension of size 1 + K, none without it
+template <int Rank>
+int64_t jvp_tangents(const torch::Tensor& t) {
+    return t.dim() == Rank + 1 ? t.size(-1) - 1 : 0;
+}
+
+// Tangent count of a launcher's result. Inputs with tangents must agree on
+// K; inputs without fit any K.
+template <int Rank>
+int64_t jvp_tangents(const torch::Tensor& a, const torch::Tensor& b) {
+    const int64_t ka = jvp_tangents<Rank>(a);
+    const int64_t kb = jvp_tangents<Rank>(b);
+    TORCH_CHECK(ka == 0 || kb == 0 || ka == kb, "JVP inputs must have the same number of tangents");
+    return std::max(ka, kb);
+}
+
+// t with unit stride along its tangent dimension, as views with more than
+// one tangent lane need. Only tensors without it are copied.
+template <int Rank>
+torch::Tensor jvp_unit_lanes(const torch::Tensor& t) {
+    return jvp_tangents<Rank>(t) > 1 && t.stride(-1) != 1 ? t.contiguous() : t;
+}
+
+// Strided view of a primal tensor with Rank dimensions and, if given, a
+// tangent tensor of the same shape, the planar layout in which forward-mode
+// AD holds duals. Both may have any strides.
+template <typename FloatType, int Rank>
+FloatGradTensor<FloatType, Rank> jvp_tensor(const torch::Tensor& primal,
+                                            const c10::optional<torch::Tensor>& tangent) {
+    TORCH_CHECK(primal.dtype() == torch::kFloat32, "JVP tensors must be float32");
+    TORCH_CHECK(primal.dim() == Rank, "JVP primals must have ", Rank, " dimensions");
+    int64_t shape[Rank], data_strides[Rank], grad_strides[Rank];
+    for (int d = 0; d < Rank; ++d) {
+        shape[d] = primal.size(d);
+        data_strides[d] = primal.stride(d);
+        grad_strides[d] = primal.stride(d);
+    }
+    FloatType* grad = nullptr;
+    if (tangent.has_value()) {
+        TORCH_CHECK(tangent->dtype() == torch::kFloat32, "JVP tangents must be float32");
+        TORCH_CHECK(tangent->sizes() == primal.sizes(), "JVP tangents must have the shape of their primals");
+        TORCH_CHECK(tangent->device() == primal.device(), "JVP tangents must be on the device of their primals");
+        for (int d = 0; d < Rank; ++d) {
+            grad_strides[d] = tangent->stride(d);
+        }
+        grad = tangent->data_ptr<float>();
+    }
+    return FloatGradTensor<FloatType, Rank>(primal.data_ptr<float>(), grad, shape, data_strides, grad_strides);
+}
+
+template <int Rank, int N = 1>
+struct JvpInput {
+    FloatGradTensor<const float, Rank, N> view;
+    bool active;
+};
+
+// Classifies an input with Rank primal dimensions. With
+// `check_zero_tangents`, an input whose K tangents are all zero is passive.
+// The scan is one reduction over the tangents and can be skipped by callers
+// who know their tangents are nonzero. The view holds the first tangent;
+// jvp_lanes views others.
+template <int Rank>
+JvpInput<Rank> jvp_input(const torch::Tensor& t, bool check_zero_tangents = true) {
+    const FloatGradTensor<const float, Rank> view = jvp_tensor<const float, Rank>(t);
+    const int64_t tangents = jvp_tangents<Rank>(t);
+    const bool active = view.has_grad()
+                        && (!check_zero_tangents || t.narrow(-1, 1, tangents).any().item<bool>());
+    return {view, active};
+}
+
+// Tangents [first_tangent, first_tangent + N) of an input classified by
+// jvp_input, as N lanes
+template <int N, int Rank>
+JvpInput<Rank, N> jvp_lanes(const torch::Tensor& t, const JvpInput<Rank>& input, int64_t first_tangent) {
+    return {jvp_tensor<const float, Rank, N>(t, first_tangent), input.active};
+}
+
+// Tangent of a planar input reshaped as its primal is, if it has one
+inline c10::optional<torch::Tensor> jvp_reshape(const c10::optional<torch::Tensor>& tangent,
+                                                torch::IntArrayRef sizes) {
+    if (!tangent.has_value()) {
+        return c10::nullopt;
+    }
+    return tangent->reshape(sizes);
+}
+
+// Classifies a planar input: active if it has a tangent. Forward-mode AD
+// passes None for inputs without one, so there is no zero scan.
+template <int Rank>
+JvpInput<Rank> jvp_input(const torch::Tensor& primal, const c10::optional<torch::Tensor>& tangent) {
+    return {jvp_tensor<const float, Rank>(primal, tangent), tangent.has_value()};
+}
+
+// Calls f(JvpTag<T>{}...) with T = FloatGrad<float, N> for active inputs
+// of N lanes and float for passive ones
+template <typename Function>
+void dispatch_jvp(Function&& f) {
+    f();
+}
+
+template <typename Function, int Rank, int N, typename... Inputs>
+void dispatch_jvp(Function&& f, const JvpInput<Rank, N>& input, const Inputs&... inputs) {
+    if (input.active) {
+        dispatch_jvp([&](auto... tags) { f(JvpTag<FloatGrad<float, N>>{}, tags...); }, inputs...);
+    } else {
+        dispatch_jvp([&](auto... tags) { f(JvpTag<float>{}, tags...); }, inputs...);
+    }
+}
+
+// Calls f(std::integral_constant<int, N>{}, first_tangent) for kernels
+// compiled for N tangent lanes. K of 1, 2, 4, 8 or 16 runs once with
+// N = K; other K run over chunks of those widths that cover the K
+// tangents, each of which recomputes the primal. K of 0 runs as 1.
+template <typename Function>
+void dispatch_tangents(int64_t K, Function&& f) {
+    int64_t first = 0;
+    do {
+        const int64_t left = K - first;
+        if (left >= 16) {
+            f(std::integral_constant<int, 16>{}, first);
+            first += 16;
+        } else if (left >= 8) {
+            f(std::integral_constant<int, 8>{}, first);
+            first += 8;
+        } else if (left >= 4) {
+            f(std::integral_constant<int, 4>{}, first);
+            first += 4;
+        } else if (left >= 2) {
+            f(std::integral_constant<int, 2>{}, first);
+            first += 2;
+        } else {
+            f(std::integral_constant<int, 1>{}, first);
+            first += 1;
+        }
+    } while (first < K);
+}
+
+// Output of a JVP launcher. An active result gets the primal and K
+// tangents per element. A passive result only gets a tangent, zero-filled,
+// if the caller asked for one, and the kernel then writes the primals of
+// its view. The view holds the first tangent; jvp_tensor views others.
+template <int Rank>
+struct JvpOutput {
+    torch::Tensor tensor;
+    FloatGradTensor<float, Rank> view;
+};
+
+template <int Rank>
+JvpOutput<Rank> jvp_output(std::vector<int64_t> sizes, const torch::TensorOptions& options,
+                           bool active, bool need_tangent, int64_t tangents = 1) {
+    torch::Tensor t;
+    if (active) {
+        sizes.push_back(1 + std::max<int64_t>(tangents, 1));
+        t = torch::empty(sizes, options);
+    } else if (need_tangent) {
+        sizes.push_back(1 + std::max<int64_t>(tangents, 1));
+        t = torch::zeros(sizes, options);
+    } else {
+        t = torch::empty(sizes, options);
+    }
+    return {t, jvp_tensor<float, Rank>(t)};
+}
+
+// Output of a planar launcher: the caller's primal tensor, written in
+// place, and a new tangent tensor of its shape if any input is active
+template <int Rank>
+struct JvpPlanes {
+    torch::Tensor tangent;
+    FloatGradTensor<float, Rank> view;
+};
+
+template <int Rank>
+JvpPlanes<Rank> jvp_planes(const torch::Tensor& primal, bool active) {
+    if (!active) {
+        return {torch::Tensor(), jvp_tensor<float, Rank>(primal, c10::nullopt)};
+    }
+    torch::Tensor tangent = torch::empty_like(primal);
+    return {tangent, jvp_tensor<float, Rank>(primal, tangent)};
+}
+
+#endif // JVP_DISPATCH_H
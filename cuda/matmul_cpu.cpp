@@ -0,0 +1,185 @@
+#include <torch/extension.h>
+#include <float_grad.h>
+
+#include "float_grad_bmm.h"
+#include "float_grad_gemm.h"
+#include "jvp_dispatch.h"
+
+// C = A B on the blocked dual GEMM, with large products split by rows of C
+// over torch's intra-op threads. Every range of rows packs all of B, so
+// ranges get at least gemm_parallel_min_work multiply-adds. With accumulate
+// the products are added to C.
+static void gemm_jvp_cpu(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                         const FloatGradTensor<const float, 2>& B, bool accumulate = false) {
+    const int64_t row_work = std::max<int64_t>(1, C.size(1) * A.size(1));
+    const int64_t grain = std::max<int64_t>(1, float_grad_detail::gemm_parallel_min_work / row_work);
+    at::parallel_for(0, C.size(0), grain, [&](int64_t begin, int64_t end) {
+        gemm_jvp(C.narrow(0, begin, end - begin), A.narrow(0, begin, end - begin), B, accumulate);
+    });
+}
+
+// CPU counterpart of matmul_cuda
+torch::Tensor matmul_cpu(torch::Tensor A, torch::Tensor B) {
+    TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
+    TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+    TORCH_CHECK(A.dim() == 2 && B.dim() == 2, "A and B must be matrices");
+
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
+    TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
+
+    auto C = torch::empty({M, N}, A.options());
+
+    gemm_jvp_cpu(jvp_tensor<float, 2>(C), jvp_tensor<const float, 2>(A), jvp_tensor<const float, 2>(B));
+
+    return C;
+}
+
+// CPU counterpart of matmul_cuda_jvp. A and B are [M, K] and [K, N]
+// matrices, optionally with a last dimension of size 1 + T, the primal and
+// T tangents, with any strides. All of it runs on the blocked GEMM: the
+// primal and the first tangent in one dual product, then every further
+// tangent as dA_t B + A dB_t into its lane of the result, so the primal is
+// computed once. Passive inputs skip their product-rule terms; if neither
+// input is active the result is [M, N] unless need_tangent asks for zero
+// tangents.
+torch::Tensor matmul_cpu_jvp(torch::Tensor A, torch::Tensor B,
+                             bool need_tangent, bool check_zero_tangents) {
+    TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
+    TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+
+    const int64_t tangents = jvp_tangents<2>(A, B);
+    const JvpInput<2> a = jvp_input<2>(A, check_zero_tangents);
+    const JvpInput<2> b = jvp_input<2>(B, check_zero_tangents);
+
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
+    TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
+
+    const bool active = a.active || b.active;
+    JvpOutput<2> c = jvp_output<2>({M, N}, A.options(), active, need_tangent, tangents);
+
+    gemm_jvp_cpu(c.view,
+                 a.active ? a.view : a.view.primals(),
+                 b.active ? b.view : b.view.primals());
+    if (active) {
+        for (int64_t t = 1; t < tangents; ++t) {
+            const FloatGradTensor<float, 2> dc = jvp_tensor<float, 2>(c.tensor.select(-1, 1 + t));
+            if (a.active) {
+                gemm_jvp_cpu(dc, jvp_tensor<const float, 2>(A.select(-1, 1 + t)), b.view.primals());
+            }
+            if (b.active) {
+                gemm_jvp_cpu(dc, a.view.primals(), jvp_tensor<const float, 2>(B.select(-1, 1 + t)),
+                             a.active);
+            }
+        }
+    }
+
+    return c.tensor;
+}
+
+// CPU counterpart of matmul_cuda_jvp_planar: writes A B into C and returns
+// dC, or an undefined tensor if neither dA nor dB is given
+torch::Tensor matmul_cpu_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                    torch::Tensor B, c10::optional<torch::Tensor> dB) {
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+    TORCH_CHECK(C.device().is_cpu(), "C must be a CPU tensor");
+
+    const JvpInput<2> a = jvp_input<2>(A, dA);
+    const JvpInput<2> b = jvp_input<2>(B, dB);
+
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
+    TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
+    TORCH_CHECK(C.dim() == 2 && C.size(0) == M && C.size(1) == N, "C must be an [M, N] matrix");
+
+    JvpPlanes<2> c = jvp_planes<2>(C, a.active || b.active);
+
+    gemm_jvp_cpu(c.view, a.view, b.view);
+
+    return c.tangent;
+}
+
+// [batch, rows, cols] planes of a JVP tensor, or only its primals if it is
+// passive, in the blocked [(2,) blocks, rows, cols, lanes] layout of
+// bmm_jvp, with the batch zero-padded to whole blocks
+static torch::Tensor bmm_blocks(const torch::Tensor& t, bool active) {
+    torch::Tensor x = t.dim() == 4 && !active ? t.select(-1, 0) : t;
+    const int64_t batch = x.size(0);
+    const int64_t blocks = (batch + bmm_block_lanes - 1) / bmm_block_lanes;
+    if (blocks * bmm_block_lanes != batch) {
+        std::vector<int64_t> pad = x.sizes().vec();
+        pad[0] = blocks * bmm_block_lanes - batch;
+        x = torch::cat({x, torch::zeros(pad, x.options())});
+    }
+    if (x.dim() == 4) {
+        return x.reshape({blocks, bmm_block_lanes, x.size(1), x.size(2), 2})
+            .permute({4, 0, 2, 3, 1}).contiguous();
+    }
+    return x.reshape({blocks, bmm_block_lanes, x.size(1), x.size(2)}).permute({0, 2, 3, 1}).contiguous();
+}
+
+template <typename FloatType>
+static FloatGradTensor<FloatType, 4> bmm_blocks_view(const torch::Tensor& blocks) {
+    const int64_t d = blocks.dim() - 4;
+    FloatType* data = blocks.data_ptr<float>();
+    return FloatGradTensor<FloatType, 4>(data, d == 1 ? data + blocks.stride(0) : nullptr,
+                                         {blocks.size(d), blocks.size(d + 1), blocks.size(d + 2),
+                                          blocks.size(d + 3)});
+}
+
+// Batched products of small matrices, C[b] = A[b] B[b] for [batch, M, K] A
+// and [batch, K, N] B, optionally with a last (primal, tangent) dimension of
+// size 2. Inputs are copied to the blocked layout of bmm_jvp, so that SIMD
+// lanes run over the batch, and blocks are split over torch's intra-op
+// threads. Options are those of matmul_cpu_jvp.
+torch::Tensor bmm_jvp(torch::Tensor A, torch::Tensor B,
+                      bool need_tangent, bool check_zero_tangents) {
+    TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
+    TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
+    TORCH_CHECK(A.device().is_cpu(), "A must be a CPU tensor");
+    TORCH_CHECK(B.device().is_cpu(), "B must be a CPU tensor");
+
+    TORCH_CHECK(jvp_tangents<3>(A) <= 1 && jvp_tangents<3>(B) <= 1,
+                "bmm_jvp takes at most one tangent per element");
+
+    const JvpInput<3> a = jvp_input<3>(A, check_zero_tangents);
+    const JvpInput<3> b = jvp_input<3>(B, check_zero_tangents);
+
+    int64_t batch = A.size(0);
+    int64_t M = A.size(1);
+    int64_t K = A.size(2);
+    int64_t N = B.size(2);
+    TORCH_CHECK(B.size(0) == batch, "A and B batch sizes mismatch");
+    TORCH_CHECK(B.size(1) == K, "A and B dimensions mismatch");
+
+    const bool active = a.active || b.active;
+    const torch::Tensor a_blocks = bmm_blocks(A, a.active);
+    const torch::Tensor b_blocks = bmm_blocks(B, b.active);
+    const int64_t blocks = a_blocks.size(-4);
+    const torch::Tensor c_blocks = active || need_tangent
+                                       ? torch::empty({2, blocks, M, N, bmm_block_lanes}, A.options())
+                                       : torch::empty({blocks, M, N, bmm_block_lanes}, A.options());
+    const FloatGradTensor<const float, 4> a_view = bmm_blocks_view<const float>(a_blocks);
+    const FloatGradTensor<const float, 4> b_view = bmm_blocks_view<const float>(b_blocks);
+    const FloatGradTensor<float, 4> c_view = bmm_blocks_view<float>(c_blocks);
+
+    at::parallel_for(0, blocks, 256, [&](int64_t begin, int64_t end) {
+        bmm_jvp(c_view.narrow(0, begin, end - begin), a_view.narrow(0, begin, end - begin),
+                b_view.narrow(0, begin, end - begin));
+    });
+
+    const int64_t padded = blocks * bmm_block_lanes;
+    if (c_blocks.dim() == 5) {
+        return c_blocks.permute({1, 4, 2, 3, 0}).reshape({padded, M, N, 2}).narrow(0, 0, batch);
+    }
+    return c_blocks.permute({0, 3, 1, 2}).reshape({padded, M, N}).narrow(0, 0, batch);
+}
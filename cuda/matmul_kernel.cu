@@ -3,30 +3,9 @@
 #include <tuple>
 #include <float_grad.h>
 
-// CUDA kernel
-template <typename FloatContainer=float*>
-__global__ void matmul_kernel(
-        const FloatContainer A
-        const FloatContainer B,
-        const float* B, 
-        float* C, 
-        int M, int N, int K) {
-
-    const FloatType* A_ptr = reinterpret_cast<const FloatType*>(A);
-    const FloatType* B_ptr = reinterpret_cast<const FloatType*>(B);
-    FloatType* C_ptr = reinterpret_cast<FloatType*>(C);
-    
-    int row = blockIdx.y * blockDim.y + threadIdx.y;
-    int col = blockIdx.x * blockDim.x + threadIdx.x;
-
-    if (row < M && col < N) {
-        FloatType sum(0.0f);
-        for (int k = 0; k < K; ++k) {
-            sum += A_ptr[row * K + k] * B_ptr[k * N + col];
-        }
-        C_ptr[row * N + col] = sum;
-    }
-}
+#include "jvp_dispatch.h"
+#include "matmul_kernel.h"
+#include "host_launch.h"
 
 // Launcher function (visible to PyTorch)
 torch::Tensor matmul_cuda(torch::Tensor A, torch::Tensor B) {
@@ -34,54 +13,107 @@ torch::Tensor matmul_cuda(torch::Tensor A, torch::Tensor B) {
     TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
     TORCH_CHECK(A.device().is_cuda(), "A must be a CUDA tensor");
     TORCH_CHECK(B.device().is_cuda(), "B must be a CUDA tensor");
+    TORCH_CHECK(A.dim() == 2 && B.dim() == 2, "A and B must be matrices");
 
-    int M = A.size(0);
-    int K = A.size(1);
-    int N = B.size(1);
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
     TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
 
-    auto C = torch::zeros({M, N}, A.options());
+    auto C = torch::empty({M, N}, A.options());
 
     dim3 blockDim(16, 16);
     dim3 gridDim((N + 15) / 16, (M + 15) / 16);
 
-    matmul_kernel<<<gridDim, blockDim>>>(
-        A.data_ptr<float>(),
-        B.data_ptr<float>(),
-        C.data_ptr<float>(),
-        M, N, K
+    launch_kernel<matmul_kernel<float, float, float>>(
+        gridDim, blockDim,
+        jvp_tensor<const float, 2>(A),
+        jvp_tensor<const float, 2>(B),
+        jvp_tensor<float, 2>(C)
     );
 
     return C;
 }
 
-torch::Tensor matmul_cuda_jvp(torch::Tensor A, torch::Tensor B) {
+// C = A B with the kernel operand types of the active inputs, for N
+// tangent lanes
+template <int N>
+static void matmul_cuda_launch(const JvpInput<2, N>& a, const JvpInput<2, N>& b,
+                               const FloatGradTensor<float, 2, N>& c) {
+    dim3 blockDim(16, 16);
+    dim3 gridDim((c.size(1) + 15) / 16, (c.size(0) + 15) / 16);
+
+    dispatch_jvp([&](auto a_tag, auto b_tag) {
+        using TA = typename decltype(a_tag)::type;
+        using TB = typename decltype(b_tag)::type;
+        using TC = std::conditional_t<is_float_grad<TA>::value || is_float_grad<TB>::value,
+                                      FloatGrad<float, N>, float>;
+        launch_kernel<matmul_kernel<TA, TB, TC, N>>(gridDim, blockDim, a.view, b.view, c);
+    }, a, b);
+}
+
+// A and B are either plain [M, K] and [K, N] matrices or carry a last
+// dimension of size 1 + T, the primal and T tangents, with any strides.
+// Inputs without tangents, or with all-zero tangents when
+// check_zero_tangents is set, run with plain float operands. The result is
+// [M, N, 1 + T], computing the primal once for T of 1, 2, 4, 8 or 16. If
+// neither input is active it is [M, N] unless need_tangent asks for zero
+// tangents.
+torch::Tensor matmul_cuda_jvp(torch::Tensor A, torch::Tensor B,
+                              bool need_tangent, bool check_zero_tangents) {
     TORCH_CHECK(A.dtype() == torch::kFloat32, "A must be float32");
     TORCH_CHECK(B.dtype() == torch::kFloat32, "B must be float32");
     TORCH_CHECK(A.device().is_cuda(), "A must be a CUDA tensor");
     TORCH_CHECK(B.device().is_cuda(), "B must be a CUDA tensor");
-    
-    // Check A has 3 dimensions and the last dimension is 2
-    // Check B has 3 dimensions and the last dimension is 2
-    TORCH_CHECK(A.dim() == 3 && A.size(2) == 2, "A must be a 3D tensor with last dimension 2");
-    TORCH_CHECK(B.dim() == 3 && B.size(2) == 2, "B must be a 3D tensor with last dimension 2");
-
-    int M = A.size(0);
-    int K = A.size(1);
-    int N = B.size(1);
+
+    const int64_t tangents = jvp_tangents<2>(A, B);
+    A = jvp_unit_lanes<2>(A);
+    B = jvp_unit_lanes<2>(B);
+    const JvpInput<2> a = jvp_input<2>(A, check_zero_tangents);
+    const JvpInput<2> b = jvp_input<2>(B, check_zero_tangents);
+
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
     TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
 
-    auto C = torch::zeros({M, N, 2}, A.options());
+    const bool active = a.active || b.active;
+    JvpOutput<2> c = jvp_output<2>({M, N}, A.options(), active, need_tangent, tangents);
 
-    dim3 blockDim(16, 16);
-    dim3 gridDim((N + 15) / 16, (M + 15) / 16);
+    if (M > 0 && N > 0) {
+        dispatch_tangents(active ? tangents : 0, [&](auto lanes, int64_t first) {
+            constexpr int L = decltype(lanes)::value;
+            matmul_cuda_launch(jvp_lanes<L>(A, a, first), jvp_lanes<L>(B, b, first),
+                               jvp_tensor<float, 2, L>(c.tensor, first));
+        });
+    }
 
-    matmul_kernel<FloatGrad><<<gridDim, blockDim>>>(
-        A.data_ptr<float>(),
-        B.data_ptr<float>(),
-        C.data_ptr<float>(),
-        M, N, K
-    );
+    return c.tensor;
+}
 
-    return C;
+// Planar form for forward-mode AD: A, B and their optional tangents dA and
+// dB are separate tensors, and one kernel writes A B into the [M, N]
+// matrix C and returns dC, which is undefined if neither tangent is given
+torch::Tensor matmul_cuda_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                     torch::Tensor B, c10::optional<torch::Tensor> dB) {
+    TORCH_CHECK(A.device().is_cuda(), "A must be a CUDA tensor");
+    TORCH_CHECK(B.device().is_cuda(), "B must be a CUDA tensor");
+    TORCH_CHECK(C.device().is_cuda(), "C must be a CUDA tensor");
+
+    const JvpInput<2> a = jvp_input<2>(A, dA);
+    const JvpInput<2> b = jvp_input<2>(B, dB);
+
+    int64_t M = A.size(0);
+    int64_t K = A.size(1);
+    int64_t N = B.size(1);
+    TORCH_CHECK(B.size(0) == K, "A and B dimensions mismatch");
+    TORCH_CHECK(C.dim() == 2 && C.size(0) == M && C.size(1) == N, "C must be an [M, N] matrix");
+
+    JvpPlanes<2> c = jvp_planes<2>(C, a.active || b.active);
+
+    if (M > 0 && N > 0) {
+        matmul_cuda_launch(a, b, c.view);
+    }
+
+    return c.tangent;
 }
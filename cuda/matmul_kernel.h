@@ -0,0 +1,65 @@
+#ifndef MATMUL_KERNEL_H
+#define MATMUL_KERNEL_H
+
+#include <cstdint>
+
+#include "float_grad.h"
+
+//////////////////////////////////////////////////////////////////////////////
+/// Kernels of the matmul launchers, without torch so that tests and host
+/// builds can run them through launch_kernel (host_launch.h).
+//////////////////////////////////////////////////////////////////////////////
+
+// Element of an input as the kernel operand type: the FloatGrad of an
+// active input, the primal of a passive one
+template <typename T, int Rank, int N, typename... Index>
+__host__ __device__
+T jvp_operand(const FloatGradTensor<const float, Rank, N>& t, Index... index) {
+    if constexpr (is_float_grad<T>::value) {
+        return T(t(index...));
+    } else {
+        return t.data(index...);
+    }
+}
+
+FLOAT_GRAD_KERNELS_BEGIN
+
+// C = A B, one thread per element of C. TA and TB are float or
+// FloatGrad<float, Tangents>: a float operand only has its primals read. C
+// has no tangent lanes unless TC is FloatGrad<float, Tangents>. The views
+// may have any strides.
+template <typename TA, typename TB, typename TC, int Tangents = 1>
+__global__ void matmul_kernel(
+        FloatGradTensor<const float, 2, Tangents> A,
+        FloatGradTensor<const float, 2, Tangents> B,
+        FloatGradTensor<float, 2, Tangents> C) {
+
+    const int64_t M = C.size(0);
+    const int64_t N = C.size(1);
+    const int64_t K = A.size(1);
+
+    int64_t row = static_cast<int64_t>(blockIdx.y) * blockDim.y + threadIdx.y;
+    int64_t col = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+
+    if (row < M && col < N) {
+        TC sum(0.0f);
+        for (int64_t k = 0; k < K; ++k) {
+            const TA a = jvp_operand<TA>(A, row, k);
+            const TB b = jvp_operand<TB>(B, k, col);
+            if constexpr (is_float_grad<TC>::value) {
+                fma_assign(sum, a, b);
+            } else {
+                sum = fmaf(a, b, sum);
+            }
+        }
+        if constexpr (is_float_grad<TC>::value) {
+            C(row, col) = sum;
+        } else {
+            C.data(row, col) = sum;
+        }
+    }
+}
+
+FLOAT_GRAD_KERNELS_END
+
+#endif // MATMUL_KERNEL_H
@@ -11,11 +11,11 @@ int test_floatgrad() {
 
     std::cout << "x_grad[2]: " << x[2] << " " << a[2] << std::endl;
 
-    x_grad[2] = x_grad[2] + FloatGrad<float>(2);
+    x_grad[2] = x_grad[2] + FloatGrad<float>(2.0f);
 
     std::cout << "x_grad[2]: " << x[2] << " " << a[2] << std::endl;
 
-    x_grad[2] = FloatGrad<float>(3) + x_grad[2];
+    x_grad[2] = FloatGrad<float>(3.0f) + x_grad[2];
 
     std::cout << "x_grad[2]: " << x[2] << " " << a[2] << std::endl;
 
@@ -0,0 +1,110 @@
+#include <torch/extension.h>
+
+int test_floatgrad();
+
+// Host launchers, built with or without the CUDA toolkit
+torch::Tensor matmul_cpu(torch::Tensor A, torch::Tensor B);
+torch::Tensor matmul_cpu_jvp(torch::Tensor A, torch::Tensor B,
+                             bool need_tangent, bool check_zero_tangents);
+torch::Tensor bmm_jvp(torch::Tensor A, torch::Tensor B,
+                      bool need_tangent, bool check_zero_tangents);
+torch::Tensor float2_dot_cpu(torch::Tensor A, torch::Tensor B);
+torch::Tensor float2_dot_cpu_jvp(torch::Tensor A, torch::Tensor B,
+                                 bool need_tangent, bool check_zero_tangents);
+torch::Tensor matmul_cpu_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                    torch::Tensor B, c10::optional<torch::Tensor> dB);
+torch::Tensor float2_dot_cpu_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                        torch::Tensor B, c10::optional<torch::Tensor> dB);
+
+#ifdef WITH_CUDA
+torch::Tensor matmul_cuda(torch::Tensor A, torch::Tensor B);
+torch::Tensor matmul_cuda_jvp(torch::Tensor A, torch::Tensor B,
+                              bool need_tangent, bool check_zero_tangents);
+torch::Tensor float2_dot_cuda(torch::Tensor A, torch::Tensor B);
+torch::Tensor float2_dot_cuda_jvp(torch::Tensor A, torch::Tensor B,
+                                  bool need_tangent, bool check_zero_tangents);
+torch::Tensor matmul_cuda_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                     torch::Tensor B, c10::optional<torch::Tensor> dB);
+torch::Tensor float2_dot_cuda_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                         torch::Tensor B, c10::optional<torch::Tensor> dB);
+#endif
+
+// Device dispatch: CUDA tensors run the CUDA kernels, everything else the
+// host ones, which reject non-CPU tensors
+torch::Tensor matmul(torch::Tensor A, torch::Tensor B) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return matmul_cuda(A, B);
+#endif
+    return matmul_cpu(A, B);
+}
+
+torch::Tensor matmul_jvp(torch::Tensor A, torch::Tensor B,
+                         bool need_tangent, bool check_zero_tangents) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return matmul_cuda_jvp(A, B, need_tangent, check_zero_tangents);
+#endif
+    return matmul_cpu_jvp(A, B, need_tangent, check_zero_tangents);
+}
+
+torch::Tensor float2_dot(torch::Tensor A, torch::Tensor B) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return float2_dot_cuda(A, B);
+#endif
+    return float2_dot_cpu(A, B);
+}
+
+torch::Tensor float2_dot_jvp(torch::Tensor A, torch::Tensor B,
+                             bool need_tangent, bool check_zero_tangents) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return float2_dot_cuda_jvp(A, B, need_tangent, check_zero_tangents);
+#endif
+    return float2_dot_cpu_jvp(A, B, need_tangent, check_zero_tangents);
+}
+
+torch::Tensor matmul_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                torch::Tensor B, c10::optional<torch::Tensor> dB) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return matmul_cuda_jvp_planar(C, A, dA, B, dB);
+#endif
+    return matmul_cpu_jvp_planar(C, A, dA, B, dB);
+}
+
+torch::Tensor float2_dot_jvp_planar(torch::Tensor C, torch::Tensor A, c10::optional<torch::Tensor> dA,
+                                    torch::Tensor B, c10::optional<torch::Tensor> dB) {
+#ifdef WITH_CUDA
+    if (A.is_cuda()) return float2_dot_cuda_jvp_planar(C, A, dA, B, dB);
+#endif
+    return float2_dot_cpu_jvp_planar(C, A, dA, B, dB);
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
+    m.def("test_floatgrad", &test_floatgrad, "Test FloatGrad functionality");
+    m.def("matmul", &matmul, "Matrix multiplication (CPU or CUDA)");
+    m.def("matmul_jvp", &matmul_jvp, "Matrix multiplication (CPU or CUDA) with gradient propagation",
+          py::arg("A"), py::arg("B"), py::arg("need_tangent") = true,
+          py::arg("check_zero_tangents") = true);
+    m.def("bmm_jvp", &bmm_jvp, "Batched small-matrix multiplication (CPU) with gradient propagation",
+          py::arg("A"), py::arg("B"), py::arg("need_tangent") = true,
+          py::arg("check_zero_tangents") = true);
+    m.def("float2_dot", &float2_dot, "Float2 dot product (CPU or CUDA)");
+    m.def("float2_dot_jvp", &float2_dot_jvp, "Float2 dot product (CPU or CUDA) with gradient propagation",
+          py::arg("A"), py::arg("B"), py::arg("need_tangent") = true,
+          py::arg("check_zero_tangents") = true);
+    m.def("matmul_jvp_planar", &matmul_jvp_planar,
+          "Matrix multiplication (CPU or CUDA) into C from separate primals and optional tangents, "
+          "returning the tangent of C",
+          py::arg("C"), py::arg("A"), py::arg("dA"), py::arg("B"), py::arg("dB"));
+    m.def("float2_dot_jvp_planar", &float2_dot_jvp_planar,
+          "Float2 dot product (CPU or CUDA) into C from separate primals and optional tangents, "
+          "returning the tangent of C",
+          py::arg("C"), py::arg("A"), py::arg("dA"), py::arg("B"), py::arg("dB"));
+#ifdef WITH_CUDA
+    m.def("matmul_cuda", &matmul_cuda, "Matrix multiplication (CUDA)");
+    m.def("matmul_cuda_jvp", &matmul_cuda_jvp, "Matrix multiplication (CUDA) with gradient propagation",
+          py::arg("A"), py::arg("B"), py::arg("need_tangent") = true,
+          py::arg("check_zero_tangents") = true);
+    m.attr("with_cuda") = true;
+#else
+    m.attr("with_cuda") = false;
+#endif
+}
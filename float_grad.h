@@ -4,4 +4,6 @@
 #include "cuda/float_grad_float3.h"
 #include "cuda/float_grad_float4.h"
 #include "cuda/float_grad_array.h"
+#include "cuda/float_grad_tensor.h"
+#include "cuda/float_grad_taylor.h"
 
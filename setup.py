@@ -1,26 +1,64 @@
 from setuptools import setup
-from torch.utils.cpp_extension import CUDAExtension, BuildExtension
+from torch.utils.cpp_extension import CppExtension, CUDAExtension, BuildExtension, CUDA_HOME
 import os
+import sys
+
+root = os.path.dirname(os.path.abspath(__file__))
+
+# The host kernels always build; the CUDA ones need the toolkit and can be
+# left out with FLOAT_GRAD_CPU_ONLY=1
+with_cuda = CUDA_HOME is not None and os.environ.get("FLOAT_GRAD_CPU_ONLY", "0") != "1"
+
+sources = [
+    "cuda/test_floatgrad.cpp",
+    "cuda/matmul_cpu.cpp",
+    "cuda/dot_cpu.cpp",
+    "ext.cpp"
+]
+
+# Host sources run kernels on the emulated grid of host_launch.h. With the
+# CUDA kernels they use the vector types of cuda_runtime.h, as the .cu
+# sources do, so that inline FloatGrad functions have one definition;
+# CPU-only builds use the portable ones. at::parallel_for needs OpenMP to
+# run in parallel. FLOAT_GRAD_NATIVE=1 tunes for the build machine, for
+# local builds that are not distributed.
+cxx_args = ["-O3", "--std=c++20", "-I" + root]
+if not with_cuda:
+    cxx_args.append("-DFLOAT_GRAD_HOST_ONLY")
+if os.environ.get("FLOAT_GRAD_NATIVE", "0") == "1":
+    cxx_args.append("-march=native")
+link_args = []
+if sys.platform != "darwin":
+    cxx_args.append("-fopenmp")
+    link_args.append("-fopenmp")
+
+if with_cuda:
+    extension = CUDAExtension(
+        name="auto_jvp_example._C",
+        sources=sources + [
+            "cuda/matmul_kernel.cu",
+            "cuda/dot_kernel.cu"
+        ],
+        define_macros=[("WITH_CUDA", None)],
+        extra_compile_args={
+            "nvcc": ["-O3", "--std=c++20", "-I" + root],
+            "cxx": cxx_args
+        },
+        extra_link_args=link_args
+    )
+else:
+    extension = CppExtension(
+        name="auto_jvp_example._C",
+        sources=sources,
+        extra_compile_args={"cxx": cxx_args},
+        extra_link_args=link_args
+    )
 
 setup(
     name="auto_jvp_example",
     packages=["auto_jvp_example"],
-    ext_modules=[
-        CUDAExtension(
-            name="auto_jvp_example._C",
-            sources=[
-                "cuda/test_floatgrad.cu",
-                # "matmul_kernel.cu",
-                "ext.cu"
-            ],
-            extra_compile_args={
-                "nvcc": ["-O3", "--std=c++20", "-I" + os.path.join(os.path.dirname(os.path.abspath(__file__)))],
-                "cxx": ["-O3", "--std=c++20"]
-            }
-        )
-    ],
+    ext_modules=[extension],
     cmdclass={
         "build_ext": BuildExtension
     }
 )
-
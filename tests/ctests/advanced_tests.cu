@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "float_grad.h"
+#include "float_grad_matrix.h"
 #include "test_utils.h"
 #include "helper_math.h"
 
@@ -10,15 +11,9 @@ void print_type() {
     static_assert(always_false<T>::value, "This is a placeholder to ensure the function is not optimized out.");
 }
 
-FloatGrad<float4> transformPoint4x4(const FloatGradRef<const float3>& p, const FloatGradArray<const float> matrix)
+FloatGrad<float4> transformPoint4x4(const FloatGradRef<const float3>& p, const FloatGradRef<const float4x4>& matrix)
 {
-    FloatGrad<float4> transformed = make_float4(
-        matrix[0] * p.x + matrix[4] * p.y + matrix[8] * p.z + matrix[12],
-        matrix[1] * p.x + matrix[5] * p.y + matrix[9] * p.z + matrix[13], 
-        matrix[2] * p.x + matrix[6] * p.y + matrix[10] * p.z + matrix[14],
-        matrix[3] * p.x + matrix[7] * p.y + matrix[11] * p.z + matrix[15]
-    );
-    return transformed;
+    return transform_point(matrix, p);
 }
 
 
@@ -27,20 +22,25 @@ TEST(AdvancedTest, TransformPoint4x4) {
     float3 p_grad = make_float3(0.1f, 0.2f, 0.3f);
     FloatGradRef<const float3> p(&p_data, &p_grad);
 
-    float matrix_data[16];
-    float matrix_grad[16];
+    // Column-major, element i of the matrix is i + 1
+    float4x4 matrix_data;
+    float4x4 matrix_grad;
 
-    for (int i = 0; i < 16; ++i) {
-        matrix_data[i] = static_cast<float>(i + 1);
-        matrix_grad[i] = static_cast<float>((i + 1) * 0.2);
+    for (int j = 0; j < 4; ++j) {
+        float4 col = make_float4(4 * j + 1.0f, 4 * j + 2.0f, 4 * j + 3.0f, 4 * j + 4.0f);
+        matrix_data.col[j] = col;
+        matrix_grad.col[j] = col * 0.2f;
     }
-    FloatGradArray<const float> matrix(matrix_data, matrix_grad);
+    FloatGradRef<const float4x4> matrix(&matrix_data, &matrix_grad);
 
     float4 transformed_data = make_float4(0.0f, 0.0f, 0.0f, 0.0f);
     float4 transformed_grad = make_float4(0.0f, 0.0f, 0.0f, 0.0f);
     FloatGradRef<float4> transformed(&transformed_data, &transformed_grad);
-    FloatGrad<float4> test(transformed_data, transformed_grad);
 
     transformed = transformPoint4x4(p, matrix);
 
+    // dM (p, 1) + M (dp, 0)
+    EXPECT_TRUE(float_eq(transformed, FloatGrad<float4>(make_float4(51.0f, 58.0f, 65.0f, 72.0f),
+                                                        make_float4(14.0f, 16.0f, 18.0f, 20.0f)),
+                         1e-4f));
 }
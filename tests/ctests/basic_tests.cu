@@ -15,8 +15,8 @@ TEST(BasicTests, ScalarConstructor) {
     FloatGrad<float> b1(b_data[1], b_grad[1]);
     FloatGrad<float2> b = make_float2(b0, b1);
 
-    EXPECT_TRUE(float_eq(b.x, FloatGrad<float>(4.0f, 2.0f)));
-    EXPECT_TRUE(float_eq(b.y, FloatGrad<float>(5.0f, 3.0f)));
+    EXPECT_TRUE(float_eq(b.x(), FloatGrad<float>(4.0f, 2.0f)));
+    EXPECT_TRUE(float_eq(b.y(), FloatGrad<float>(5.0f, 3.0f)));
 
 }
 
@@ -55,8 +55,8 @@ TEST(BasicTests, VectorConstructor) {
     FloatGrad<float> b1(b_data[1], b_grad[1]);
     FloatGrad<float2> b = make_float2(b0, b1);
 
-    EXPECT_TRUE(float_eq(b.x, FloatGrad<float>(4.0f, 2.0f)));
-    EXPECT_TRUE(float_eq(b.y, FloatGrad<float>(5.0f, 3.0f)));
+    EXPECT_TRUE(float_eq(b.x(), FloatGrad<float>(4.0f, 2.0f)));
+    EXPECT_TRUE(float_eq(b.y(), FloatGrad<float>(5.0f, 3.0f)));
 
     float4 c_data = make_float4(6.0f, 7.0f, 8.0f, 9.0f);
     float4 c_grad = make_float4(4.0f, 5.0f, 6.0f, 7.0f);
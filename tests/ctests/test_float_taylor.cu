@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "test_utils.h"
+
+// Taylor coefficients are f^(k) / k! along the seeded direction
+
+TEST(FloatTaylorTest, Arithmetic) {
+    using T4 = FloatTaylor<float, 4>;
+    T4 t = T4::variable(0.0f, 1.0f);
+
+    // 1 / (1 - t) = 1 + t + t^2 + ...
+    T4 geom = 1.0f / (1.0f - t);
+    for (int k = 0; k <= 4; ++k) {
+        EXPECT_TRUE(float_eq(geom[k], 1.0f));
+    }
+
+    // (1 + t)^3 = 1 + 3t + 3t^2 + t^3
+    T4 cube = (1.0f + t) * (t + 1.0f) * (1.0f + t);
+    const float binom[5] = {1.0f, 3.0f, 3.0f, 1.0f, 0.0f};
+    for (int k = 0; k <= 4; ++k) {
+        EXPECT_TRUE(float_eq(cube[k], binom[k]));
+    }
+
+    // Quotient of two polynomials recovers the factor
+    T4 q = cube / (1.0f + t);
+    const float square[5] = {1.0f, 2.0f, 1.0f, 0.0f, 0.0f};
+    for (int k = 0; k <= 4; ++k) {
+        EXPECT_TRUE(float_eq(q[k], square[k], 1e-5f));
+    }
+
+    T4 d = -(2.0f * t - t / 2.0f);
+    EXPECT_TRUE(float_eq(d[1], -1.5f));
+    EXPECT_TRUE(float_eq(cube.derivative(3), 6.0f));
+}
+
+TEST(FloatTaylorTest, ElementaryFunctions) {
+    using T5 = FloatTaylor<float, 5>;
+    const float x0 = 0.3f;
+    T5 x = T5::variable(x0, 1.0f);
+
+    // exp(2x) around x0
+    T5 e = expf(2.0f * x);
+    float fact = 1.0f;
+    for (int k = 0; k <= 5; ++k) {
+        fact *= k > 0 ? static_cast<float>(k) : 1.0f;
+        EXPECT_NEAR(e[k], expf(2.0f * x0) * powf(2.0f, k) / fact, 1e-5f);
+        EXPECT_NEAR(e.derivative(k), expf(2.0f * x0) * powf(2.0f, k), 1e-4f);
+    }
+
+    // sqrt(1 + t) = 1 + t/2 - t^2/8 + t^3/16 - 5 t^4/128
+    T5 s = sqrtf(1.0f + T5::variable(0.0f, 1.0f));
+    const float coeffs[5] = {1.0f, 0.5f, -0.125f, 0.0625f, -5.0f / 128.0f};
+    for (int k = 0; k < 5; ++k) {
+        EXPECT_NEAR(s[k], coeffs[k], 1e-6f);
+    }
+
+    T5 r = rsqrtf(x) * sqrtf(x);
+    EXPECT_NEAR(r[0], 1.0f, 1e-6f);
+    for (int k = 1; k <= 5; ++k) {
+        EXPECT_NEAR(r[k], 0.0f, 1e-4f);
+    }
+}
+
+TEST(FloatTaylorTest, MatchesNestedDuals) {
+    // Second-order coefficient of |p + t v| equals v^T H v / 2 from a
+    // forward-over-forward pass
+    const float p[3] = {1.0f, 2.0f, -2.0f};
+    const float v[3] = {0.5f, -1.0f, 2.0f};
+
+    using T3 = FloatTaylor<float, 3>;
+    auto q = make_float3(T3::variable(p[0], v[0]), T3::variable(p[1], v[1]),
+                         T3::variable(p[2], v[2]));
+    T3 len = length(q);
+
+    using HyperDual = FloatGrad<FloatGrad<float>>;
+    auto seed = [](float x, float d) {
+        return HyperDual(FloatGrad<float>(x, d), FloatGrad<float>(d, 0.0f));
+    };
+    HyperDual ref = length(make_float3(seed(p[0], v[0]), seed(p[1], v[1]), seed(p[2], v[2])));
+
+    EXPECT_NEAR(len[0], ref.data().data(), 1e-5f);
+    EXPECT_NEAR(len[1], ref.data().grad(), 1e-5f);
+    EXPECT_NEAR(len.derivative(2), ref.grad().grad(), 1e-5f);
+}
+
+TEST(FloatTaylorTest, VectorOperations) {
+    using T2 = FloatTaylor<float, 2>;
+    T2 t = T2::variable(0.0f, 1.0f);
+
+    // a(t) = (1, t, t^2), b(t) = (t, 1, 0)
+    auto a = make_float3(T2::constant(1.0f), t, t * t);
+    auto b = make_float3(t, T2::constant(1.0f), T2::constant(0.0f));
+
+    // a . b = 2t
+    T2 ab = dot(a, b);
+    EXPECT_TRUE(float_eq(ab[0], 0.0f));
+    EXPECT_TRUE(float_eq(ab[1], 2.0f));
+    EXPECT_TRUE(float_eq(ab[2], 0.0f));
+
+    // a x b = (-t^2, t^3, 1 - t^2), truncated at order 2
+    FloatTaylor<float3, 2> c = cross(a, b);
+    EXPECT_TRUE(float_eq(c[0], make_float3(0.0f, 0.0f, 1.0f)));
+    EXPECT_TRUE(float_eq(c[1], make_float3(0.0f, 0.0f, 0.0f)));
+    EXPECT_TRUE(float_eq(c[2], make_float3(-1.0f, 0.0f, -1.0f)));
+
+    // Components and sums
+    auto s = a + b * 2.0f;
+    EXPECT_TRUE(float_eq(get_x(s)[1], 2.0f));
+    EXPECT_TRUE(float_eq(get_y(s)[0], 2.0f));
+
+    // normalize keeps unit length to every order
+    T2 n = length(normalize(a + make_float3(0.5f, 0.0f, 0.0f)));
+    EXPECT_NEAR(n[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(n[1], 0.0f, 1e-5f);
+    EXPECT_NEAR(n[2], 0.0f, 1e-5f);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <cstring>
+#include <cmath>
 
 #include "float_grad.h"
 #include "test_utils.h"
@@ -140,3 +142,112 @@ TEST(FloatGradTest, ScalarCompoundOperators) {
     EXPECT_TRUE(float_eq(a, FloatGrad<float>(6.0f, 3.0f))); // (24 * 4 - 24 * 2) / (4 * 4)
 }
 
+TEST(FloatGradTest, RefCompoundOperators) {
+    float a_data = 3.0f, a_grad = 1.0f;
+    FloatGradRef<float> a(&a_data, &a_grad);
+    const FloatGrad<float> b(4.0f, 2.0f);
+
+    a += b;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(7.0f, 3.0f)));
+
+    // Passive operands only touch the primal and scale the tangent
+    a -= 1.0f;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(6.0f, 3.0f)));
+    a *= 2.0f;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(12.0f, 6.0f)));
+    a /= 4.0f;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(3.0f, 1.5f)));
+
+    // Self-aliasing reads the operand before writing
+    a *= a;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(9.0f, 9.0f)));
+    a /= a;
+    EXPECT_TRUE(float_eq(a, FloatGrad<float>(1.0f, 0.0f)));
+}
+
+TEST(FloatGradTest, FmaAssign) {
+    const float a_data[3] = {1.0f, 2.0f, 3.0f};
+    const float a_grad[3] = {0.5f, -1.0f, 2.0f};
+    const float b_data[3] = {4.0f, -5.0f, 6.0f};
+    const float b_grad[3] = {1.0f, 0.0f, -0.5f};
+
+    FloatGrad<float> sum(0.0f, 0.0f);
+    FloatGrad<float> reference(0.0f, 0.0f);
+    for (int i = 0; i < 3; i++) {
+        FloatGradRef<const float> a(&a_data[i], &a_grad[i]);
+        FloatGradRef<const float> b(&b_data[i], &b_grad[i]);
+        fma_assign(sum, a, b);
+        reference = reference + a * b;
+    }
+    EXPECT_TRUE(float_eq(sum, reference));
+
+    // Accumulate through a reference, with a passive factor
+    float c_data = 1.0f, c_grad = 0.0f;
+    fma_assign(FloatGradRef<float>(&c_data, &c_grad), 2.0f, sum);
+    EXPECT_FLOAT_EQ(c_data, 1.0f + 2.0f * sum.data());
+    EXPECT_FLOAT_EQ(c_grad, 2.0f * sum.grad());
+}
+
+TEST(FloatGradTest, TriviallyCopyable) {
+    FloatGrad<float> a[2] = {FloatGrad<float>(1.0f, 0.1f), FloatGrad<float>(2.0f, 0.2f)};
+
+    // Arrays of duals are interleaved data/grad buffers
+    float interleaved[4];
+    std::memcpy(interleaved, a, sizeof(a));
+    EXPECT_FLOAT_EQ(interleaved[0], 1.0f);
+    EXPECT_FLOAT_EQ(interleaved[1], 0.1f);
+    EXPECT_FLOAT_EQ(interleaved[2], 2.0f);
+    EXPECT_FLOAT_EQ(interleaved[3], 0.2f);
+
+    // Copying a ref copies the pointers, assigning writes through them
+    float b_data = 3.0f, b_grad = 0.3f;
+    FloatGradRef<float> b(&b_data, &b_grad);
+    FloatGradRef<float> c(b);
+    c = a[1];
+    EXPECT_TRUE(float_eq(b, FloatGrad<float>(2.0f, 0.2f)));
+}
+
+// Tangents against central differences of the double-precision functions
+TEST(FloatGradTest, TranscendentalFunctions) {
+    auto check = [](auto f, auto ref, float x0) {
+        const FloatGrad<float> y = f(FloatGrad<float>(x0, 1.0f));
+        const double h = 1e-4;
+        const double slope = (ref(x0 + h) - ref(x0 - h)) / (2.0 * h);
+        EXPECT_NEAR(y.data(), ref(x0), 1e-6 * std::fabs(ref(x0)) + 1e-7) << x0;
+        EXPECT_NEAR(y.grad(), slope, 1e-5 * std::fabs(slope) + 1e-6) << x0;
+    };
+    for (float x0 : {-0.9f, -0.3f, 0.2f, 0.7f}) {
+        check([](auto x) { return sinf(x); }, [](double x) { return std::sin(x); }, x0);
+        check([](auto x) { return cosf(x); }, [](double x) { return std::cos(x); }, x0);
+        check([](auto x) { return tanf(x); }, [](double x) { return std::tan(x); }, x0);
+        check([](auto x) { return tanhf(x); }, [](double x) { return std::tanh(x); }, x0);
+        check([](auto x) { return sigmoid(x); }, [](double x) { return 1.0 / (1.0 + std::exp(-x)); }, x0);
+        check([](auto x) { return erff(x); }, [](double x) { return std::erf(x); }, x0);
+        check([](auto x) { return acosf(x); }, [](double x) { return std::acos(x); }, x0);
+        check([](auto x) { return log1pf(x); }, [](double x) { return std::log1p(x); }, x0);
+        check([](auto x) { return logf(x + 1.0f); }, [](double x) { return std::log(x + 1.0); }, x0);
+        check([](auto x) { return powf(x + 1.0f, 2.5f); }, [](double x) { return std::pow(x + 1.0, 2.5); }, x0);
+        check([](auto x) { return powf(1.5f, x); }, [](double x) { return std::pow(1.5, x); }, x0);
+        check([](auto x) { return atan2f(x, -0.4f); }, [](double x) { return std::atan2(x, -0.4); }, x0);
+        check([](auto x) { return atan2f(0.6f, x); }, [](double x) { return std::atan2(0.6, x); }, x0);
+    }
+
+    FloatGrad<float> s, c;
+    sincosf(FloatGrad<float>(0.5f, 2.0f), &s, &c);
+    EXPECT_TRUE(float_eq(s, FloatGrad<float>(sinf(0.5f), 2.0f * cosf(0.5f))));
+    EXPECT_TRUE(float_eq(c, FloatGrad<float>(cosf(0.5f), -2.0f * sinf(0.5f))));
+
+    // Both operands active, and the x = 0 branch of powf
+    const FloatGrad<float> x(0.8f, 1.0f), y(1.7f, 0.5f);
+    const FloatGrad<float> p = powf(x, y);
+    EXPECT_NEAR(p.grad(), 1.7f * powf(0.8f, 0.7f) + 0.5f * powf(0.8f, 1.7f) * logf(0.8f), 1e-5f);
+    EXPECT_TRUE(float_eq(powf(FloatGrad<float>(0.0f, 1.0f), 1.0f), FloatGrad<float>(0.0f, 1.0f)));
+    // An active exponent at x = 0 contributes 0 for y >= 0, not NaN
+    EXPECT_TRUE(float_eq(powf(FloatGrad<float>(0.0f, 0.0f), FloatGrad<float>(2.0f, 0.0f)),
+                         FloatGrad<float>(0.0f, 0.0f)));
+    EXPECT_TRUE(float_eq(powf(FloatGrad<float>(0.0f, 1.0f), FloatGrad<float>(2.0f, 1.0f)),
+                         FloatGrad<float>(0.0f, 0.0f)));
+    EXPECT_TRUE(float_eq(powf(0.0f, FloatGrad<float>(0.0f, 1.0f)), FloatGrad<float>(1.0f, 0.0f)));
+    const FloatGrad<float> a = atan2f(x, y);
+    EXPECT_NEAR(a.grad(), (1.7f * 1.0f - 0.8f * 0.5f) / (0.8f * 0.8f + 1.7f * 1.7f), 1e-6f);
+}
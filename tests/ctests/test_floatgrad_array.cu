@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "float_grad.h"
+#include "helper_math.h"
 #include "test_utils.h"
 
 TEST(FloatGradTest, ScalarArrayOperators) {
@@ -259,6 +260,10 @@ TEST(FloatGradTest, ArrayOffset) {
 
     EXPECT_TRUE(float_eq(b[0], a[5]));
 
+    // 64-bit offsets, as parallel_for passes, from either side
+    const int64_t begin = 3;
+    EXPECT_TRUE((a + begin) == FloatGradArray<float>(a_data + 3, a_grad + 3));
+    EXPECT_TRUE((begin + a) == (a + begin));
 }
 
 
@@ -298,3 +303,92 @@ TEST(FloatGradTest, VanillaFloatGradArray) {
                   << a_arr[i].grad() << std::endl;
     }
 }
+
+TEST(FloatGradTest, InterleavedArray) {
+    // (primal, tangent) pairs, as in a torch JVP tensor of shape [5, 2]
+    float pairs[10] = {1.0f, 0.1f, 2.0f, 0.2f, 3.0f,
+                       0.3f, 4.0f, 0.4f, 5.0f, 0.5f};
+
+    FloatGradInterleavedArray<float> a(pairs);
+
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(a[i].data(), pairs[2 * i]);
+        EXPECT_FLOAT_EQ(a[i].grad(), pairs[2 * i + 1]);
+    }
+
+    a[1] = a[2] * a[3];
+    EXPECT_FLOAT_EQ(pairs[2], 12.0f);
+    EXPECT_FLOAT_EQ(pairs[3], 0.3f * 4.0f + 3.0f * 0.4f);
+
+    FloatGradInterleavedArray<float> b = a + 3;
+    EXPECT_TRUE(float_eq(b[0], a[3]));
+    EXPECT_TRUE(float_eq(*b, a[3]));
+    EXPECT_TRUE(b != a);
+    EXPECT_TRUE(b == cast<float>(a + 3));
+    EXPECT_EQ(b.grad_ptr(), pairs + 7);
+}
+
+TEST(FloatGradTest, InterleavedArrayOfFloatGrad) {
+    FloatGrad<float> duals[4];
+    for (int i = 0; i < 4; i++) {
+        duals[i] = FloatGrad<float>(1.0f + i, 0.5f * i);
+    }
+
+    const FloatGradInterleavedArray<const float> a(duals);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(float_eq(a[i], duals[i]));
+    }
+
+    // Pairs of float2 are the FloatGrad<float2> layout
+    FloatGrad<float2> vec_duals[2] = {
+        FloatGrad<float2>(make_float2(1.0f, 2.0f), make_float2(0.1f, 0.2f)),
+        FloatGrad<float2>(make_float2(3.0f, 4.0f), make_float2(0.3f, 0.4f)),
+    };
+    FloatGradInterleavedArray<float2> v =
+        FloatGradInterleavedArray<float>(reinterpret_cast<float*>(vec_duals)).cast<float2>();
+    EXPECT_FLOAT_EQ(v[1].x().data(), 3.0f);
+    EXPECT_FLOAT_EQ(v[1].y().grad(), 0.4f);
+}
+
+TEST(FloatGradTest, ArrayVectorLoadStore) {
+    alignas(16) float a_data[8] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    alignas(16) float a_grad[8] = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f};
+    alignas(16) float b_data[8] = {};
+    alignas(16) float b_grad[8] = {};
+
+    const FloatGradArray<const float> a(a_data, a_grad);
+    FloatGradArray<float> b(b_data, b_grad);
+
+    FloatGrad<float4> v = a.load<4>(4);
+    EXPECT_TRUE(float_eq(v.data(), make_float4(5.0f, 6.0f, 7.0f, 8.0f)));
+    EXPECT_TRUE(float_eq(v.grad(), make_float4(0.5f, 0.6f, 0.7f, 0.8f)));
+
+    FloatGrad<float2> u = a.load<2>(2);
+    EXPECT_TRUE(float_eq(u.data(), make_float2(3.0f, 4.0f)));
+    EXPECT_TRUE(float_eq(u.grad(), make_float2(0.3f, 0.4f)));
+
+    b.store<4>(0, v * 2.0f);
+    b.store<2>(4, u);
+    b.store_stream<2>(6, u);
+    b.store_stream<1>(7, a.load<1>(0));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(float_eq(b[i], a[i + 4] * 2.0f));
+    }
+    EXPECT_TRUE(float_eq(b[5], a[3]));
+    EXPECT_TRUE(float_eq(b[6], a[2]));
+    EXPECT_TRUE(float_eq(b[7], a[0]));
+
+    b.store_stream<4>(4, v);
+    for (int i = 4; i < 8; i++) {
+        EXPECT_TRUE(float_eq(b[i], a[i]));
+    }
+}
+
+#ifndef NDEBUG
+TEST(FloatGradDeathTest, ArrayVectorLoadMisaligned) {
+    alignas(16) float data[8] = {};
+    alignas(16) float grad[8] = {};
+    const FloatGradArray<const float> a(data, grad);
+    EXPECT_DEATH(a.load<4>(1), "misaligned");
+}
+#endif
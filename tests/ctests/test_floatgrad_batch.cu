@@ -0,0 +1,337 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "float_grad.h"
+#include "float_grad_batch.h"
+#include "test_utils.h"
+#include "helper_math.h"
+
+namespace {
+
+// Planes of n duals with varied, positive primals
+struct DualPlanes {
+    std::vector<float> data;
+    std::vector<float> grad;
+
+    DualPlanes(int n, float offset) : data(n), grad(n) {
+        for (int i = 0; i < n; ++i) {
+            data[i] = offset + 0.37f * ((i * 7) % 23);
+            grad[i] = 0.1f * ((i * 5) % 11) - 0.5f;
+        }
+    }
+
+    FloatGradArray<float> array() { return FloatGradArray<float>(data.data(), grad.data()); }
+};
+
+// Sizes around the SIMD widths, to cover both the blocks and the tails
+const int kSizes[] = {0, 1, 7, 8, 15, 16, 17, 33, 100};
+
+} // namespace
+
+TEST(FloatGradBatchTest, Arithmetic) {
+    for (int n : kSizes) {
+        DualPlanes a(n, 0.5f), b(n, 1.25f), c(n, -2.0f), out(n, 0.0f);
+        auto av = a.array(), bv = b.array(), cv = c.array(), ov = out.array();
+
+        batch_add(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i] + bv[i]));
+        batch_sub(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i] - bv[i]));
+        batch_mul(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i] * bv[i], 1e-5f));
+        batch_div(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i] / bv[i], 1e-5f));
+        batch_fma(ov, av, bv, cv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i] * bv[i] + cv[i], 1e-5f));
+    }
+}
+
+TEST(FloatGradBatchTest, Functions) {
+    for (int n : kSizes) {
+        DualPlanes a(n, 0.5f), out(n, 0.0f);
+        auto av = a.array(), ov = out.array();
+
+        batch_sqrt(ov, av, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], sqrtf(av[i]), 1e-5f));
+        batch_rsqrt(ov, av, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], rsqrtf(av[i]), 1e-5f));
+        batch_exp(ov, av, n);
+        for (int i = 0; i < n; ++i) {
+            const FloatGrad<float> e = expf(av[i]);
+            EXPECT_NEAR(ov[i].data(), e.data(), 2e-6f * e.data());
+            EXPECT_NEAR(ov[i].grad(), e.grad(), 2e-6f * std::fabs(e.grad()) + 1e-7f);
+        }
+    }
+}
+
+TEST(FloatGradBatchTest, ExpRange) {
+    const int n = 40;
+    std::vector<float> data(n), grad(n, 1.0f), out_data(n), out_grad(n);
+    for (int i = 0; i < n; ++i) {
+        data[i] = -110.0f + 5.0f * i;
+    }
+    data[3] = 88.7f;
+    data[4] = -87.3f;
+    data[5] = 0.0f;
+    data[6] = NAN;
+    data[7] = INFINITY;
+    data[8] = -INFINITY;
+    FloatGradArray<float> a(data.data(), grad.data());
+    FloatGradArray<float> out(out_data.data(), out_grad.data());
+
+    batch_exp(out, a, n);
+    for (int i = 0; i < n; ++i) {
+        const float expected = expf(data[i]);
+        if (std::isnan(expected)) {
+            EXPECT_TRUE(std::isnan(out_data[i])) << data[i];
+        } else if (std::isinf(expected)) {
+            EXPECT_EQ(out_data[i], expected) << data[i];
+        } else {
+            EXPECT_NEAR(out_data[i], expected, 4e-7f * expected + 1e-38f) << data[i];
+        }
+    }
+}
+
+TEST(FloatGradBatchTest, Selections) {
+    for (int n : kSizes) {
+        DualPlanes a(n, 0.5f), b(n, 3.0f), out(n, 0.0f);
+        // Equal primals take the tangent of the second operand, as fminf and fmaxf do
+        for (int i = 0; i < n; i += 3) {
+            b.data[i] = a.data[i];
+        }
+        auto av = a.array(), bv = b.array(), ov = out.array();
+
+        batch_min(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], fminf(av[i], bv[i])));
+        batch_max(ov, av, bv, n);
+        for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], fmaxf(av[i], bv[i])));
+        batch_clamp(ov, av, 2.0f, 5.0f, n);
+        for (int i = 0; i < n; ++i) {
+            const FloatGrad<float> v = av[i];
+            EXPECT_TRUE(float_eq(ov[i], fmaxf(2.0f, fminf(v, 5.0f))));
+        }
+    }
+}
+
+TEST(FloatGradBatchTest, InPlace) {
+    const int n = 37;
+    DualPlanes a(n, 0.5f), b(n, 1.25f), expected(n, 0.0f);
+    auto av = a.array(), bv = b.array(), ev = expected.array();
+    for (int i = 0; i < n; ++i) {
+        ev[i] = av[i] * bv[i] + av[i];
+    }
+
+    batch_fma(av, av, bv, av, n);
+    for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(av[i], ev[i], 1e-5f));
+}
+
+namespace {
+
+// Within tol of expected, or equal to it, which also covers infinities and
+// NaN
+void expect_close(float actual, float expected, float tol, float input) {
+    if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(actual)) << input;
+    } else if (actual != expected) {
+        EXPECT_NEAR(actual, expected, tol) << input;
+    }
+}
+
+// Runs a unary batch kernel on xs with unit-ish tangents and compares it to
+// the scalar FloatGrad overload, within `ulps` float ulps, or within
+// grad_abs for tangents that cancel
+template <typename Batch, typename Scalar>
+void expect_unary_matches(Batch batch, Scalar scalar, const std::vector<float>& xs,
+                          float ulps = 4.0f, float grad_abs = 1e-30f) {
+    const int n = static_cast<int>(xs.size());
+    std::vector<float> data(xs), grad(n), out_data(n), out_grad(n);
+    for (int i = 0; i < n; ++i) {
+        grad[i] = 1.0f - 0.01f * (i % 7);
+    }
+    FloatGradArray<float> a(data.data(), grad.data());
+    FloatGradArray<float> out(out_data.data(), out_grad.data());
+    batch(out, a, n);
+    const float eps = ulps * std::numeric_limits<float>::epsilon();
+    for (int i = 0; i < n; ++i) {
+        const FloatGrad<float> expected = scalar(a[i]);
+        expect_close(out_data[i], expected.data(), eps * std::fabs(expected.data()) + 1e-30f, xs[i]);
+        if (!std::isnan(expected.data())) {
+            expect_close(out_grad[i], expected.grad(), eps * std::fabs(expected.grad()) + grad_abs, xs[i]);
+        }
+    }
+}
+
+std::vector<float> linspace(float lo, float hi, int n) {
+    std::vector<float> xs(n);
+    for (int i = 0; i < n; ++i) {
+        xs[i] = lo + (hi - lo) * i / (n - 1);
+    }
+    return xs;
+}
+
+} // namespace
+
+TEST(FloatGradBatchTest, LogFunctions) {
+    std::vector<float> xs = linspace(1e-3f, 50.0f, 301);
+    xs.insert(xs.end(), {1.0f, 1e-40f, 3e38f, 0.0f, -1.0f, INFINITY, NAN});
+    expect_unary_matches([](auto out, auto a, int n) { batch_log(out, a, n); },
+                         [](auto x) { return logf(x); }, xs);
+
+    std::vector<float> ys = linspace(-0.99f, 20.0f, 301);
+    ys.insert(ys.end(), {0.0f, 1e-8f, -1e-8f, 1e-30f, 3e38f, -1.0f, -2.0f, INFINITY});
+    expect_unary_matches([](auto out, auto a, int n) { batch_log1p(out, a, n); },
+                         [](auto x) { return log1pf(x); }, ys);
+}
+
+TEST(FloatGradBatchTest, TrigFunctions) {
+    std::vector<float> xs = linspace(-20.0f, 20.0f, 401);
+    // Past the vector range reduction, handled by the scalar overloads
+    xs.insert(xs.end(), {0.0f, -0.0f, 1e-20f, 8000.0f, -8191.0f, 1e5f, -3e7f, INFINITY, NAN});
+    // Absolute error near the zeros, relative to the magnitude of the inputs
+    auto check = [&](auto batch, auto scalar) {
+        const int n = static_cast<int>(xs.size());
+        std::vector<float> data(xs), grad(n, 1.0f), out_data(n), out_grad(n);
+        FloatGradArray<float> a(data.data(), grad.data());
+        FloatGradArray<float> out(out_data.data(), out_grad.data());
+        batch(out, a, n);
+        for (int i = 0; i < n; ++i) {
+            const FloatGrad<float> expected = scalar(a[i]);
+            expect_close(out_data[i], expected.data(), 2e-7f, xs[i]);
+            expect_close(out_grad[i], expected.grad(), 2e-7f, xs[i]);
+        }
+    };
+    check([](auto out, auto a, int n) { batch_sin(out, a, n); }, [](auto x) { return sinf(x); });
+    check([](auto out, auto a, int n) { batch_cos(out, a, n); }, [](auto x) { return cosf(x); });
+
+    const int n = static_cast<int>(xs.size());
+    std::vector<float> data(xs), grad(n, 0.5f), sd(n), sg(n), cd(n), cg(n);
+    FloatGradArray<float> a(data.data(), grad.data());
+    batch_sincos(FloatGradArray<float>(sd.data(), sg.data()), FloatGradArray<float>(cd.data(), cg.data()),
+                 a, n);
+    for (int i = 0; i < n; ++i) {
+        if (std::isnan(sinf(xs[i]))) {
+            continue;
+        }
+        EXPECT_NEAR(sd[i], sinf(xs[i]), 2e-7f) << xs[i];
+        EXPECT_NEAR(cg[i], -0.5f * sinf(xs[i]), 2e-7f) << xs[i];
+    }
+
+    std::vector<float> ts = linspace(-1.5f, 1.5f, 201);
+    expect_unary_matches([](auto out, auto a, int n) { batch_tan(out, a, n); },
+                         [](auto x) { return tanf(x); }, ts, 8.0f);
+}
+
+TEST(FloatGradBatchTest, SigmoidLikeFunctions) {
+    std::vector<float> xs = linspace(-12.0f, 12.0f, 401);
+    xs.insert(xs.end(), {0.0f, 1e-6f, -1e-6f, 0.6249f, 0.6251f, 50.0f, -50.0f, INFINITY, -INFINITY, NAN});
+    // 1 - y^2 and y - y^2 cancel where y saturates
+    expect_unary_matches([](auto out, auto a, int n) { batch_tanh(out, a, n); },
+                         [](auto x) { return tanhf(x); }, xs, 4.0f, 2e-7f);
+    expect_unary_matches([](auto out, auto a, int n) { batch_sigmoid(out, a, n); },
+                         [](auto x) { return sigmoid(x); }, xs, 4.0f, 2e-7f);
+
+    std::vector<float> es = linspace(-4.5f, 4.5f, 401);
+    es.insert(es.end(), {0.0f, 1e-20f, 0.9999f, 1.0001f, 10.0f, -INFINITY, NAN});
+    expect_unary_matches([](auto out, auto a, int n) { batch_erf(out, a, n); },
+                         [](auto x) { return erff(x); }, es);
+}
+
+TEST(FloatGradBatchTest, Acos) {
+    std::vector<float> xs = linspace(-0.999f, 0.999f, 401);
+    xs.insert(xs.end(), {0.0f, 0.5f, -0.5f, 0.5001f, 1.0f, -1.0f, 1.5f, NAN});
+    expect_unary_matches([](auto out, auto a, int n) { batch_acos(out, a, n); },
+                         [](auto x) { return acosf(x); }, xs);
+}
+
+TEST(FloatGradBatchTest, BinaryFunctions) {
+    std::vector<float> xs, ys;
+    for (float x : {1e-30f, 0.01f, 0.5f, 1.0f, 1.7f, 10.0f, 1e4f}) {
+        for (float y : {-30.0f, -2.5f, -1.0f, 0.0f, 0.5f, 1.0f, 3.0f, 17.0f}) {
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+    }
+    // Handed to the scalar overloads: zero, negative, infinite and NaN bases
+    // or exponents
+    for (auto [x, y] : {std::pair{0.0f, 2.0f}, {0.0f, -1.0f}, {-2.0f, 3.0f}, {-2.0f, 0.5f},
+                        {INFINITY, 2.0f}, {2.0f, INFINITY}, {NAN, 1.0f}}) {
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+    const int n = static_cast<int>(xs.size());
+    std::vector<float> xd(xs), xg(n, 0.25f), yd(ys), yg(n, -0.5f), od(n), og(n);
+    FloatGradArray<float> a(xd.data(), xg.data()), b(yd.data(), yg.data()), out(od.data(), og.data());
+
+    batch_pow(out, a, b, n);
+    for (int i = 0; i < n; ++i) {
+        const FloatGrad<float> e = powf(a[i], b[i]);
+        SCOPED_TRACE(ys[i]);
+        expect_close(od[i], e.data(), 4e-7f * std::fabs(e.data()), xs[i]);
+        expect_close(og[i], e.grad(), 4e-6f * std::fabs(e.grad()) + 1e-30f, xs[i]);
+    }
+
+    // atan2 over all quadrants, plus the signed zeros and infinities
+    std::vector<float> vs, us;
+    for (float v : {-3.0f, -1.0f, -0.2f, -0.0f, 0.0f, 0.3f, 1.0f, 5.0f, 1e30f, INFINITY}) {
+        for (float u : {-4.0f, -1.0f, -0.1f, -0.0f, 0.0f, 0.2f, 1.0f, 2.5f, 1e-30f, -INFINITY}) {
+            vs.push_back(v);
+            us.push_back(u);
+        }
+    }
+    const int m = static_cast<int>(vs.size());
+    std::vector<float> vd(vs), vg(m, 1.0f), ud(us), ug(m, 0.5f), rd(m), rg(m);
+    FloatGradArray<float> v(vd.data(), vg.data()), u(ud.data(), ug.data()), r(rd.data(), rg.data());
+    batch_atan2(r, v, u, m);
+    for (int i = 0; i < m; ++i) {
+        const FloatGrad<float> e = atan2f(v[i], u[i]);
+        SCOPED_TRACE(us[i]);
+        expect_close(rd[i], e.data(), 4e-7f * std::fabs(e.data()), vs[i]);
+        expect_close(rg[i], e.grad(), 4e-7f * std::fabs(e.grad()) + 1e-30f, vs[i]);
+    }
+}
+
+TEST(FloatGradBatchTest, Reductions) {
+    for (int n : kSizes) {
+        DualPlanes a(n, 0.5f), b(n, -1.25f);
+        auto av = a.array(), bv = b.array();
+
+        double sum_d = 0.0, sum_g = 0.0, dot_d = 0.0, dot_g = 0.0;
+        for (int i = 0; i < n; ++i) {
+            sum_d += a.data[i];
+            sum_g += a.grad[i];
+            dot_d += double(a.data[i]) * b.data[i];
+            dot_g += double(a.grad[i]) * b.data[i] + double(a.data[i]) * b.grad[i];
+        }
+        const FloatGrad<float> sum = batch_sum(av, n);
+        EXPECT_NEAR(sum.data(), sum_d, 1e-5f * (n + 1));
+        EXPECT_NEAR(sum.grad(), sum_g, 1e-5f * (n + 1));
+        const FloatGrad<float> dot = batch_dot(av, bv, n);
+        EXPECT_NEAR(dot.data(), dot_d, 1e-4f * (n + 1));
+        EXPECT_NEAR(dot.grad(), dot_g, 1e-4f * (n + 1));
+    }
+}
+
+TEST(FloatGradBatchTest, Interleave) {
+    for (int n : kSizes) {
+        DualPlanes a(n, 0.5f), out(n, 0.0f);
+        auto av = a.array(), ov = out.array();
+        // One extra pair so that the view can start off a vector boundary
+        std::vector<float> pairs(2 * n + 2, 0.0f);
+
+        for (int start : {0, 1}) {
+            FloatGradInterleavedArray<float> iv = FloatGradInterleavedArray<float>(pairs.data()) + start;
+            batch_interleave(iv, av, n);
+            for (int i = 0; i < n; ++i) {
+                EXPECT_EQ(pairs[2 * (start + i)], a.data[i]);
+                EXPECT_EQ(pairs[2 * (start + i) + 1], a.grad[i]);
+            }
+
+            const FloatGradInterleavedArray<const float> civ(pairs.data() + 2 * start);
+            batch_deinterleave(ov, civ, n);
+            for (int i = 0; i < n; ++i) EXPECT_TRUE(float_eq(ov[i], av[i]));
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "float_grad.h"
+#include "float_grad_bmm.h"
+#include "test_utils.h"
+
+namespace {
+
+// Planes of a batch of rows x cols dual matrices, batch innermost
+struct DualBatch {
+    int64_t rows, cols, batch;
+    std::vector<float> data;
+    std::vector<float> grad;
+
+    DualBatch(int64_t m, int64_t n, int64_t b, int seed)
+        : rows(m), cols(n), batch(b), data(m * n * b), grad(m * n * b) {
+        for (int64_t i = 0; i < m * n * b; ++i) {
+            data[i] = ((i * 37 + seed * 11) % 29) / 14.0f - 1.0f;
+            grad[i] = ((i * 53 + seed * 7) % 31) / 15.0f - 1.0f;
+        }
+    }
+
+    FloatGradTensor<float, 3> view() {
+        return FloatGradTensor<float, 3>(data.data(), grad.data(), {rows, cols, batch});
+    }
+};
+
+// Expects C[b] = A[b] B[b] and dC[b] = dA[b] B[b] + A[b] dB[b], where A and
+// B are passive without a tangent plane
+void expect_product(const FloatGradTensor<float, 3>& C, const FloatGradTensor<const float, 3>& A,
+                    const FloatGradTensor<const float, 3>& B) {
+    for (int64_t l = 0; l < C.size(2); ++l) {
+        for (int64_t i = 0; i < C.size(0); ++i) {
+            for (int64_t j = 0; j < C.size(1); ++j) {
+                double d = 0.0, g = 0.0;
+                for (int64_t k = 0; k < A.size(1); ++k) {
+                    d += double(A.data(i, k, l)) * B.data(k, j, l);
+                    if (A.has_grad()) g += double(A.grad(i, k, l)) * B.data(k, j, l);
+                    if (B.has_grad()) g += double(A.data(i, k, l)) * B.grad(k, j, l);
+                }
+                EXPECT_NEAR(C.data(i, j, l), d, 1e-5) << "at (" << i << ", " << j << ", " << l << ")";
+                if (C.has_grad()) {
+                    EXPECT_NEAR(C.grad(i, j, l), g, 2e-5) << "at (" << i << ", " << j << ", " << l << ")";
+                }
+            }
+        }
+    }
+}
+
+// Planes of blocks of lanes matrices in the blocked layout
+struct DualBlocks {
+    int64_t blocks, rows, cols, lanes;
+    std::vector<float> data;
+    std::vector<float> grad;
+
+    DualBlocks(int64_t o, int64_t m, int64_t n, int64_t l, int seed)
+        : blocks(o), rows(m), cols(n), lanes(l), data(o * m * n * l), grad(o * m * n * l) {
+        for (int64_t i = 0; i < o * m * n * l; ++i) {
+            data[i] = ((i * 37 + seed * 11) % 29) / 14.0f - 1.0f;
+            grad[i] = ((i * 53 + seed * 7) % 31) / 15.0f - 1.0f;
+        }
+    }
+
+    FloatGradTensor<float, 4> view() {
+        return FloatGradTensor<float, 4>(data.data(), grad.data(), {blocks, rows, cols, lanes});
+    }
+};
+
+void expect_blocked_product(const FloatGradTensor<float, 4>& C, const FloatGradTensor<const float, 4>& A,
+                            const FloatGradTensor<const float, 4>& B) {
+    for (int64_t o = 0; o < C.size(0); ++o) {
+        expect_product(C.select(0, o), A.select(0, o), B.select(0, o));
+    }
+}
+
+// Batch sizes around the SIMD widths
+const int64_t kBatches[] = {0, 1, 15, 17, 40};
+
+} // namespace
+
+TEST(FloatGradBmm, SmallShapes) {
+    for (int64_t m = 1; m <= 4; ++m) {
+        for (int64_t k = 1; k <= 4; ++k) {
+            for (int64_t n = 1; n <= 4; ++n) {
+                for (int64_t batch : kBatches) {
+                    DualBatch a(m, k, batch, 1), b(k, n, batch, 2), c(m, n, batch, 3);
+                    bmm_jvp(c.view(), a.view(), b.view());
+                    expect_product(c.view(), a.view(), b.view());
+                }
+            }
+        }
+    }
+}
+
+TEST(FloatGradBmm, FixedShape) {
+    DualBatch a(3, 3, 37, 1), b(3, 3, 37, 2), c(3, 3, 37, 3);
+    bmm_jvp<3, 3, 3>(c.view(), a.view(), b.view());
+    expect_product(c.view(), a.view(), b.view());
+}
+
+TEST(FloatGradBmm, PassiveOperands) {
+    DualBatch a(4, 4, 33, 1), b(4, 1, 33, 2), c(4, 1, 33, 3);
+
+    bmm_jvp(c.view(), a.view().primals(), b.view());
+    expect_product(c.view(), a.view().primals(), b.view());
+
+    bmm_jvp(c.view(), a.view(), b.view().primals());
+    expect_product(c.view(), a.view(), b.view().primals());
+
+    bmm_jvp(c.view(), a.view().primals(), b.view().primals());
+    expect_product(c.view(), a.view().primals(), b.view().primals());
+    for (float g : c.grad) EXPECT_EQ(g, 0.0f);
+
+    // Without a tangent plane in C only the primal is computed
+    const std::vector<float> grad = c.grad;
+    bmm_jvp(c.view().primals(), a.view(), b.view());
+    expect_product(c.view().primals(), a.view(), b.view());
+    EXPECT_EQ(c.grad, grad);
+}
+
+TEST(FloatGradBmm, GenericFallback) {
+    // Sizes past 4
+    DualBatch a(5, 2, 19, 1), b(2, 6, 19, 2), c(5, 6, 19, 3);
+    bmm_jvp(c.view(), a.view(), b.view());
+    expect_product(c.view(), a.view(), b.view());
+
+    // Batch-major [batch, M, K] storage viewed as [M, K, batch]
+    DualBatch at(19, 3, 3, 4), bt(19, 3, 3, 5);
+    FloatGradTensor<float, 3> av = at.view().transpose(0, 2).transpose(0, 1);
+    FloatGradTensor<float, 3> bv = bt.view().transpose(0, 2).transpose(0, 1);
+    DualBatch ct(3, 3, 19, 6);
+    bmm_jvp(ct.view(), av, bv);
+    expect_product(ct.view(), av, bv);
+}
+
+TEST(FloatGradBmm, BlockedLayout) {
+    for (int64_t lanes : {bmm_block_lanes, int64_t(5)}) {
+        DualBlocks a(3, 4, 4, lanes, 1), b(3, 4, 4, lanes, 2), c(3, 4, 4, lanes, 3);
+        bmm_jvp(c.view(), a.view(), b.view());
+        expect_blocked_product(c.view(), a.view(), b.view());
+
+        DualBlocks p(3, 3, 2, lanes, 4), q(3, 2, 1, lanes, 5), r(3, 3, 1, lanes, 6);
+        bmm_jvp<3, 2, 1>(r.view(), p.view(), q.view().primals());
+        expect_blocked_product(r.view(), p.view(), q.view().primals());
+    }
+
+    // Blocks of a larger batch, as the threads of a pool take them
+    DualBlocks a(4, 2, 2, bmm_block_lanes, 1), b(4, 2, 2, bmm_block_lanes, 2), c(4, 2, 2, bmm_block_lanes, 3);
+    bmm_jvp(c.view().narrow(0, 1, 2), a.view().narrow(0, 1, 2), b.view().narrow(0, 1, 2));
+    expect_blocked_product(c.view().narrow(0, 1, 2), a.view().narrow(0, 1, 2), b.view().narrow(0, 1, 2));
+
+    // Lanes that are not unit-stride take the generic loop
+    FloatGradTensor<float, 4> at = a.view().transpose(1, 3);
+    FloatGradTensor<float, 4> bt = b.view().transpose(1, 3).narrow(2, 0, 2).narrow(1, 0, 2);
+    DualBlocks ct(4, bmm_block_lanes, 2, 2, 4);
+    bmm_jvp(ct.view(), at, bt);
+    expect_blocked_product(ct.view(), at, bt);
+}
@@ -34,15 +34,15 @@ TEST(FloatGradFloat2, VectorElementAccess) {
     FloatGrad<float2> a(a_data, a_grad);
     FloatGrad<float2> b(b_data, b_grad);
 
-    EXPECT_TRUE(float_eq(a.x, FloatGrad<float>(1.0f, 0.1f)));
-    EXPECT_TRUE(float_eq(a.y, FloatGrad<float>(2.0f, 0.2f)));
+    EXPECT_TRUE(float_eq(a.x(), FloatGrad<float>(1.0f, 0.1f)));
+    EXPECT_TRUE(float_eq(a.y(), FloatGrad<float>(2.0f, 0.2f)));
 
-    a.x += b.x;
+    a.x() += b.x();
 
     EXPECT_TRUE(float_eq(a, FloatGrad<float2>(float2{4.0f, 2.0f}, float2{0.4f, 0.2f})));
     EXPECT_TRUE(float_eq(b, FloatGrad<float2>(float2{3.0f, 4.0f}, float2{0.3f, 0.4f})));
 
-    a.y *= b.y;
+    a.y() *= b.y();
 
     EXPECT_TRUE(float_eq(a, FloatGrad<float2>(float2{4.0f, 8.0f}, float2{0.4f, 1.6f})));
     EXPECT_TRUE(float_eq(b, FloatGrad<float2>(float2{3.0f, 4.0f}, float2{0.3f, 0.4f})));
@@ -50,10 +50,10 @@ TEST(FloatGradFloat2, VectorElementAccess) {
     FloatGrad<const float2> c(a_data, a_grad);
     FloatGradRef<const float2> d(&b_data, &b_grad);
 
-    EXPECT_TRUE(float_eq(c.x, FloatGrad<float>(1.0f, 0.1f)));
-    EXPECT_TRUE(float_eq(c.y, FloatGrad<float>(2.0f, 0.2f)));
-    EXPECT_TRUE(float_eq(d.x, FloatGrad<float>(3.0f, 0.3f)));
-    EXPECT_TRUE(float_eq(d.y, FloatGrad<float>(4.0f, 0.4f)));
+    EXPECT_TRUE(float_eq(c.x(), FloatGrad<float>(1.0f, 0.1f)));
+    EXPECT_TRUE(float_eq(c.y(), FloatGrad<float>(2.0f, 0.2f)));
+    EXPECT_TRUE(float_eq(d.x(), FloatGrad<float>(3.0f, 0.3f)));
+    EXPECT_TRUE(float_eq(d.y(), FloatGrad<float>(4.0f, 0.4f)));
 }
 
 TEST(FloatGradFloat2, VectorOperators) {
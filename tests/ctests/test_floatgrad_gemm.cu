@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "float_grad.h"
+#include "float_grad_gemm.h"
+#include "test_utils.h"
+
+namespace {
+
+// Row-major planes of an m x n dual matrix with values in [-1, 1]
+struct DualMatrix {
+    int64_t rows, cols;
+    std::vector<float> data;
+    std::vector<float> grad;
+
+    DualMatrix(int64_t m, int64_t n, int seed) : rows(m), cols(n), data(m * n), grad(m * n) {
+        for (int64_t i = 0; i < m * n; ++i) {
+            data[i] = ((i * 37 + seed * 11) % 29) / 14.0f - 1.0f;
+            grad[i] = ((i * 53 + seed * 7) % 31) / 15.0f - 1.0f;
+        }
+    }
+
+    FloatGradTensor<float, 2> view() { return FloatGradTensor<float, 2>(data.data(), grad.data(), {rows, cols}); }
+};
+
+// Expects C = A B and dC = dA B + A dB, from double-precision sums, where
+// A and B are passive without a tangent plane
+void expect_product(const FloatGradTensor<float, 2>& C, const FloatGradTensor<const float, 2>& A,
+                    const FloatGradTensor<const float, 2>& B) {
+    for (int64_t i = 0; i < C.size(0); ++i) {
+        for (int64_t j = 0; j < C.size(1); ++j) {
+            double d = 0.0, g = 0.0, scale = 1.0;
+            for (int64_t k = 0; k < A.size(1); ++k) {
+                d += double(A.data(i, k)) * B.data(k, j);
+                if (A.has_grad()) g += double(A.grad(i, k)) * B.data(k, j);
+                if (B.has_grad()) g += double(A.data(i, k)) * B.grad(k, j);
+                scale += 1.0;
+            }
+            const float tol = 1e-6f * scale;
+            EXPECT_NEAR(C.data(i, j), d, tol) << "at (" << i << ", " << j << ")";
+            if (C.has_grad()) {
+                EXPECT_NEAR(C.grad(i, j), g, 2 * tol) << "at (" << i << ", " << j << ")";
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(FloatGradGemm, Shapes) {
+    // Edges of the register tiles and of the cache blocks
+    const int64_t shapes[][3] = {{1, 1, 1}, {7, 5, 3}, {6, 32, 128}, {13, 33, 129},
+                                 {200, 70, 260}, {37, 3100, 9}};
+    for (const auto& s : shapes) {
+        DualMatrix a(s[0], s[2], 1), b(s[2], s[1], 2), c(s[0], s[1], 3);
+        gemm_jvp(c.view(), a.view(), b.view());
+        expect_product(c.view(), a.view(), b.view());
+    }
+}
+
+TEST(FloatGradGemm, PassiveOperands) {
+    DualMatrix a(20, 30, 1), b(30, 40, 2), c(20, 40, 3);
+
+    gemm_jvp(c.view(), a.view().primals(), b.view());
+    expect_product(c.view(), a.view().primals(), b.view());
+
+    gemm_jvp(c.view(), a.view(), b.view().primals());
+    expect_product(c.view(), a.view(), b.view().primals());
+
+    gemm_jvp(c.view(), a.view().primals(), b.view().primals());
+    expect_product(c.view(), a.view().primals(), b.view().primals());
+    for (float g : c.grad) EXPECT_EQ(g, 0.0f);
+
+    // Without a tangent plane in C only the primal is computed
+    DualMatrix p(20, 40, 4);
+    const std::vector<float> grad = p.grad;
+    gemm_jvp(p.view().primals(), a.view(), b.view());
+    expect_product(p.view().primals(), a.view(), b.view());
+    EXPECT_EQ(p.grad, grad);
+}
+
+TEST(FloatGradGemm, StridedViews) {
+    // Transposed inputs, as from torch .t(), and interleaved pairs for C
+    DualMatrix at(70, 50, 1), bt(90, 70, 2);
+    std::vector<float> pairs(2 * 50 * 90, -1.0f);
+    FloatGradTensor<float, 2> c(FloatGradInterleavedArray<float>(pairs.data()), {50, 90});
+
+    gemm_jvp(c, at.view().transpose(0, 1), bt.view().transpose(0, 1));
+    expect_product(c, at.view().transpose(0, 1), bt.view().transpose(0, 1));
+
+    gemm_jvp(c, at.view().transpose(0, 1).primals(), bt.view().transpose(0, 1).primals());
+    for (int64_t i = 0; i < 50 * 90; ++i) EXPECT_EQ(pairs[2 * i + 1], 0.0f);
+
+    // Column-major output and a sliced input
+    DualMatrix a(40, 200, 3), b(100, 60, 4), ct(60, 40, 5);
+    gemm_jvp(ct.view().transpose(0, 1), a.view().narrow(1, 100, 100), b.view());
+    expect_product(ct.view().transpose(0, 1), a.view().narrow(1, 100, 100), b.view());
+}
+
+TEST(FloatGradGemm, EmptyDepth) {
+    DualMatrix a(4, 0, 1), b(0, 5, 2), c(4, 5, 3);
+    gemm_jvp(c.view(), a.view(), b.view());
+    for (float x : c.data) EXPECT_EQ(x, 0.0f);
+    for (float x : c.grad) EXPECT_EQ(x, 0.0f);
+}
+
+TEST(FloatGradGemm, Accumulate) {
+    // Over two depth blocks, and over an empty depth that adds nothing
+    for (int64_t depth : {300, 0}) {
+        DualMatrix a(13, depth, 1), b(depth, 33, 2), c(13, 33, 3);
+        const DualMatrix c0 = c;
+        gemm_jvp(c.view(), a.view(), b.view(), true);
+        for (size_t i = 0; i < c.data.size(); ++i) {
+            c.data[i] -= c0.data[i];
+            c.grad[i] -= c0.grad[i];
+        }
+        expect_product(c.view(), a.view(), b.view());
+    }
+
+    // Passive operands leave the tangent of C as it is
+    DualMatrix a(13, 30, 1), b(30, 33, 2), c(13, 33, 3);
+    const std::vector<float> grad = c.grad;
+    gemm_jvp(c.view(), a.view().primals(), b.view().primals(), true);
+    EXPECT_EQ(c.grad, grad);
+}
+
+TEST(FloatGradGemm, ThreadPool) {
+    // Above the size run on one thread, with blocks that split the register
+    // tiles unevenly between threads
+    const int64_t shapes[][3] = {{150, 130, 200}, {7, 2000, 300}, {1000, 9, 300}};
+    for (int threads : {2, 3, 4}) {
+        ThreadPool pool(threads);
+        for (const auto& s : shapes) {
+            DualMatrix a(s[0], s[2], 1), b(s[2], s[1], 2), c(s[0], s[1], 3);
+            gemm_jvp(c.view(), a.view(), b.view(), pool);
+            expect_product(c.view(), a.view(), b.view());
+        }
+        DualMatrix a(150, 200, 1), b(200, 130, 2), c(150, 130, 3);
+        gemm_jvp(c.view(), a.view().primals(), b.view(), pool);
+        expect_product(c.view(), a.view().primals(), b.view());
+    }
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "float_grad.h"
+#include "cuda/float_grad_jacobian.h"
+#include "test_utils.h"
+
+// y[i] = x[i-1] * x[i] + sqrtf(x[i+1]) on a tridiagonal stencil
+static void stencil(FloatGradArray<const float> x, FloatGradArray<float> y, int n) {
+    for (int i = 0; i < n; i++) {
+        FloatGrad<float> yi = x[i] * x[i];
+        if (i > 0) {
+            yi = yi + x[i - 1] * x[i];
+        }
+        if (i + 1 < n) {
+            yi = yi + sqrtf(x[i + 1]);
+        }
+        y[i] = yi;
+    }
+}
+
+// Reference Jacobian with one forward pass per column
+static std::vector<float> dense_reference(const std::vector<float>& x) {
+    const int n = static_cast<int>(x.size());
+    std::vector<float> jac(n * n);
+    std::vector<float> x_grad(n), y_data(n), y_grad(n);
+    for (int j = 0; j < n; j++) {
+        std::fill(x_grad.begin(), x_grad.end(), 0.0f);
+        x_grad[j] = 1.0f;
+        stencil(FloatGradArray<const float>(x.data(), x_grad.data()),
+                FloatGradArray<float>(y_data.data(), y_grad.data()), n);
+        for (int i = 0; i < n; i++) {
+            jac[i * n + j] = y_grad[i];
+        }
+    }
+    return jac;
+}
+
+TEST(FloatGradJacobianTest, BandedColoring) {
+    JacobianSparsity pattern = JacobianSparsity::banded(64, 64, 1, 1);
+    JacobianColoring coloring = color_jacobian_columns(pattern);
+
+    EXPECT_EQ(pattern.nnz(), 64 * 3 - 2);
+    EXPECT_EQ(coloring.num_colors, 3);
+
+    // No two columns of the same color share a row
+    for (int i = 0; i < pattern.rows; i++) {
+        for (int k = pattern.row_ptr[i]; k < pattern.row_ptr[i + 1]; k++) {
+            for (int l = k + 1; l < pattern.row_ptr[i + 1]; l++) {
+                EXPECT_NE(coloring.color[pattern.col_idx[k]],
+                          coloring.color[pattern.col_idx[l]]);
+            }
+        }
+    }
+}
+
+TEST(FloatGradJacobianTest, BlockDiagonalColoring) {
+    // Four dense 3x3 blocks need only three colors
+    std::vector<int> row_ptr(1, 0), col_idx;
+    for (int i = 0; i < 12; i++) {
+        for (int j = (i / 3) * 3; j < (i / 3) * 3 + 3; j++) {
+            col_idx.push_back(j);
+        }
+        row_ptr.push_back(static_cast<int>(col_idx.size()));
+    }
+    JacobianSparsity pattern(12, 12, row_ptr, col_idx);
+    EXPECT_EQ(color_jacobian_columns(pattern).num_colors, 3);
+}
+
+TEST(FloatGradJacobianTest, CompressedMatchesDense) {
+    const int n = 32;
+    std::vector<float> x(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = 1.0f + 0.25f * i;
+    }
+    auto f = [n](FloatGradArray<const float> x, FloatGradArray<float> y) {
+        stencil(x, y, n);
+    };
+
+    JacobianSparsity pattern = JacobianSparsity::banded(n, n, 1, 1);
+    int passes = 0;
+    auto counted = [&](FloatGradArray<const float> x, FloatGradArray<float> y) {
+        passes++;
+        f(x, y);
+    };
+
+    std::vector<float> jac = jacobian_dense(counted, x, pattern);
+    std::vector<float> ref = dense_reference(x);
+    EXPECT_EQ(passes, 3);
+    for (int k = 0; k < n * n; k++) {
+        EXPECT_TRUE(float_eq(jac[k], ref[k])) << "entry " << k;
+    }
+
+    std::vector<float> values = jacobian_csr(f, x, pattern);
+    ASSERT_EQ(static_cast<int>(values.size()), pattern.nnz());
+    for (int i = 0; i < n; i++) {
+        for (int k = pattern.row_ptr[i]; k < pattern.row_ptr[i + 1]; k++) {
+            EXPECT_TRUE(float_eq(values[k], ref[i * n + pattern.col_idx[k]]));
+        }
+    }
+}
+
+TEST(FloatGradJacobianTest, InvalidPattern) {
+    EXPECT_THROW(JacobianSparsity(2, 2, {0, 1}, {0}), std::invalid_argument);
+    EXPECT_THROW(JacobianSparsity(1, 2, {0, 1}, {2}), std::invalid_argument);
+    EXPECT_THROW(JacobianSparsity(-1, 2, {}, {}), std::invalid_argument);
+    EXPECT_THROW(JacobianSparsity(1, -1, {0, 0}, {}), std::invalid_argument);
+    EXPECT_THROW(JacobianSparsity(1, 2, {1, 1}, {0}), std::invalid_argument);
+    EXPECT_THROW(JacobianSparsity(2, 2, {0, 2, 1}, {0}), std::invalid_argument);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "float_grad.h"
+#include "float_grad_matrix.h"
+#include "test_utils.h"
+
+namespace {
+
+bool float_eq(const float3x3& a, const float3x3& b, float eps = 1e-5f) {
+    return ::float_eq(a.col[0], b.col[0], eps) && ::float_eq(a.col[1], b.col[1], eps)
+           && ::float_eq(a.col[2], b.col[2], eps);
+}
+
+bool float_eq(const float4x4& a, const float4x4& b, float eps = 1e-5f) {
+    return ::float_eq(a.col[0], b.col[0], eps) && ::float_eq(a.col[1], b.col[1], eps)
+           && ::float_eq(a.col[2], b.col[2], eps) && ::float_eq(a.col[3], b.col[3], eps);
+}
+
+// Well-conditioned matrices with distinct entries
+float3x3 test_matrix3(float seed) {
+    float3x3 m;
+    for (int j = 0; j < 3; ++j) {
+        m.col[j] = make_float3(std::sin(seed + 3 * j), std::sin(seed + 3 * j + 1),
+                               std::sin(seed + 3 * j + 2));
+        (j == 0 ? m.col[j].x : j == 1 ? m.col[j].y : m.col[j].z) += 2.0f;
+    }
+    return m;
+}
+
+float4x4 test_matrix4(float seed) {
+    float4x4 m;
+    for (int j = 0; j < 4; ++j) {
+        m.col[j] = make_float4(std::sin(seed + 4 * j), std::sin(seed + 4 * j + 1),
+                               std::sin(seed + 4 * j + 2), std::sin(seed + 4 * j + 3));
+    }
+    m.col[0].x += 2.0f;
+    m.col[1].y += 2.0f;
+    m.col[2].z += 2.0f;
+    m.col[3].w += 2.0f;
+    return m;
+}
+
+const float3x3 identity3 = make_float3x3(make_float3(1.0f, 0.0f, 0.0f), make_float3(0.0f, 1.0f, 0.0f),
+                                         make_float3(0.0f, 0.0f, 1.0f));
+const float4x4 identity4 = make_float4x4(make_float4(1.0f, 0.0f, 0.0f, 0.0f), make_float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                         make_float4(0.0f, 0.0f, 1.0f, 0.0f), make_float4(0.0f, 0.0f, 0.0f, 1.0f));
+
+} // namespace
+
+TEST(FloatGradMatrix, PlainProducts) {
+    // Column-major: col[j] holds column j
+    const float3x3 a = make_float3x3(make_float3(1.0f, 4.0f, 7.0f), make_float3(2.0f, 5.0f, 8.0f),
+                                     make_float3(3.0f, 6.0f, 10.0f));
+    EXPECT_TRUE(::float_eq(a * make_float3(1.0f, 1.0f, 1.0f), make_float3(6.0f, 15.0f, 25.0f)));
+    EXPECT_TRUE(float_eq(a * identity3, a));
+    EXPECT_TRUE(float_eq(transpose(transpose(a)), a));
+    EXPECT_TRUE(::float_eq(transpose(a).col[0], make_float3(1.0f, 2.0f, 3.0f)));
+    EXPECT_TRUE(::float_eq(determinant(a), -3.0f, 1e-5f));
+    EXPECT_TRUE(float_eq(a * inverse(a), identity3));
+
+    const float3x3 b = test_matrix3(0.5f);
+    const float3 v = make_float3(0.3f, -0.7f, 1.1f);
+    EXPECT_TRUE(::float_eq((a * b) * v, a * (b * v), 1e-4f));
+    EXPECT_TRUE(float_eq(transpose(a * b), transpose(b) * transpose(a), 1e-4f));
+    EXPECT_TRUE(::float_eq(determinant(a * b), determinant(a) * determinant(b), 1e-4f));
+
+    const float4x4 m = test_matrix4(0.2f);
+    const float4x4 n = test_matrix4(1.3f);
+    EXPECT_TRUE(float_eq(m * inverse(m), identity4));
+    EXPECT_TRUE(float_eq(inverse(m) * m, identity4));
+    EXPECT_TRUE(::float_eq(determinant(m * n), determinant(m) * determinant(n), 1e-3f));
+    EXPECT_TRUE(::float_eq(determinant(transpose(m)), determinant(m), 1e-5f));
+    EXPECT_TRUE(::float_eq(transform_point(m, v), m * make_float4(v, 1.0f)));
+}
+
+TEST(FloatGradMatrix, QuaternionRotation) {
+    // 90 degrees about z maps x to y
+    const float h = std::sqrt(0.5f);
+    const float3x3 r = quat_to_rotation(make_float4(0.0f, 0.0f, h, h));
+    EXPECT_TRUE(::float_eq(r * make_float3(1.0f, 0.0f, 0.0f), make_float3(0.0f, 1.0f, 0.0f)));
+    EXPECT_TRUE(::float_eq(r * make_float3(0.0f, 1.0f, 0.0f), make_float3(-1.0f, 0.0f, 0.0f)));
+
+    // Any non-zero quaternion gives a rotation, the one of q / |q|
+    const float4 q = make_float4(0.3f, -1.2f, 0.5f, 2.0f);
+    const float3x3 s = quat_to_rotation(q);
+    EXPECT_TRUE(float_eq(transpose(s) * s, identity3));
+    EXPECT_TRUE(::float_eq(determinant(s), 1.0f, 1e-5f));
+    EXPECT_TRUE(float_eq(quat_to_rotation(q * 3.0f), s));
+}
+
+TEST(FloatGradMatrix, DualProducts) {
+    const float4x4 a = test_matrix4(0.1f), da = test_matrix4(2.1f);
+    const float4x4 b = test_matrix4(0.7f), db = test_matrix4(1.9f);
+    const float4 v = make_float4(0.5f, -1.0f, 2.0f, 1.0f), dv = make_float4(0.1f, 0.2f, -0.3f, 0.0f);
+    FloatGrad<float4x4> A(a, da);
+    FloatGrad<float4x4> B(b, db);
+    FloatGrad<float4> V(v, dv);
+
+    FloatGrad<float4x4> C = A * B;
+    EXPECT_TRUE(float_eq(C.data(), a * b, 1e-4f));
+    EXPECT_TRUE(float_eq(C.grad(), da * b + a * db, 1e-4f));
+
+    FloatGrad<float4> y = A * V;
+    EXPECT_TRUE(::float_eq(y.data(), a * v, 1e-5f));
+    EXPECT_TRUE(::float_eq(y.grad(), da * v + a * dv, 1e-5f));
+
+    // Passive operands drop their tangent terms
+    FloatGrad<float4> z = a * V;
+    EXPECT_TRUE(::float_eq(z.grad(), a * dv, 1e-5f));
+    FloatGrad<float4x4> S = A * 2.0f + B;
+    EXPECT_TRUE(float_eq(S.grad(), da * 2.0f + db, 1e-5f));
+
+    // Refs into plain storage, columns from dual vectors
+    float4x4 c_data, c_grad;
+    FloatGradRef<float4x4> C_ref(&c_data, &c_grad);
+    C_ref = transpose(A);
+    EXPECT_TRUE(float_eq(c_grad, transpose(da)));
+    EXPECT_TRUE(float_eq(get_col(C_ref, 2), FloatGrad<float4>(transpose(a).col[2], transpose(da).col[2])));
+
+    FloatGrad<float3x3> M = make_float3x3(FloatGrad<float3>(make_float3(1.0f, 2.0f, 3.0f),
+                                                            make_float3(0.1f, 0.2f, 0.3f)),
+                                          make_float3(4.0f, 5.0f, 6.0f),
+                                          FloatGrad<float3>(make_float3(7.0f, 8.0f, 9.0f),
+                                                            make_float3(0.7f, 0.8f, 0.9f)));
+    EXPECT_TRUE(::float_eq(M.grad().col[1], make_float3(0.0f, 0.0f, 0.0f)));
+    EXPECT_TRUE(::float_eq(M.data().col[2], make_float3(7.0f, 8.0f, 9.0f)));
+}
+
+TEST(FloatGradMatrix, DeterminantAndInverseJVP) {
+    const float3x3 a = test_matrix3(0.4f), da = test_matrix3(1.7f);
+    FloatGrad<float3x3> A(a, da);
+    FloatGrad<float> det = determinant(A);
+    FloatGrad<float3x3> inv = inverse(A);
+
+    // Central differences along da
+    const float h = 1e-2f;
+    const float fd_det = (determinant(a + da * h) - determinant(a - da * h)) / (2.0f * h);
+    EXPECT_NEAR(det.data(), determinant(a), 1e-6f);
+    EXPECT_NEAR(det.grad(), fd_det, 1e-3f);
+    EXPECT_TRUE(float_eq(inv.grad(), -inverse(a) * da * inverse(a), 1e-4f));
+
+    const float4x4 m = test_matrix4(0.9f), dm = test_matrix4(2.5f);
+    FloatGrad<float4x4> M(m, dm);
+    const float fd_det4 = (determinant(m + dm * h) - determinant(m - dm * h)) / (2.0f * h);
+    EXPECT_NEAR(determinant(M).grad(), fd_det4, 1e-2f * std::fabs(fd_det4));
+    const float4x4 fd_inv = (inverse(m + dm * h) - inverse(m - dm * h)) / (2.0f * h);
+    EXPECT_TRUE(float_eq(inverse(M).grad(), fd_inv, 1e-2f));
+}
+
+TEST(FloatGradMatrix, QuaternionRotationJVP) {
+    const float4 q = make_float4(0.3f, -1.2f, 0.5f, 2.0f);
+    const float4 dq = make_float4(0.4f, 0.1f, -0.6f, 0.2f);
+    FloatGrad<float3x3> R = quat_to_rotation(FloatGrad<float4>(q, dq));
+
+    const float h = 1e-2f;
+    const float3x3 fd = (quat_to_rotation(q + dq * h) - quat_to_rotation(q - dq * h)) / (2.0f * h);
+    EXPECT_TRUE(float_eq(R.data(), quat_to_rotation(q)));
+    EXPECT_TRUE(float_eq(R.grad(), fd, 1e-3f));
+    // R stays orthogonal, so R^T dR is antisymmetric
+    const float3x3 w = transpose(R.data()) * R.grad();
+    EXPECT_TRUE(float_eq(w, -transpose(w), 1e-5f));
+}
+
+TEST(FloatGradMatrix, TangentLanes) {
+    const float3x3 a = test_matrix3(0.3f);
+    FloatTangents<float3x3, 2> da{{test_matrix3(1.1f), test_matrix3(2.2f)}};
+    FloatGrad<float3x3, 2> A(a, da);
+    FloatGrad<float3, 2> v(make_float3(1.0f, -2.0f, 0.5f),
+                           FloatTangents<float3, 2>{{make_float3(0.1f, 0.0f, 0.0f),
+                                                     make_float3(0.0f, 0.2f, 0.0f)}});
+
+    FloatGrad<float3, 2> y = A * v;
+    FloatGrad<float3x3, 2> inv = inverse(A);
+    FloatGrad<float, 2> det = determinant(A);
+    for (int i = 0; i < 2; ++i) {
+        FloatGrad<float3x3> lane(a, da[i]);
+        EXPECT_TRUE(::float_eq(y.grad()[i], da[i] * v.data() + a * v.grad()[i], 1e-5f));
+        EXPECT_TRUE(float_eq(inv.grad()[i], inverse(lane).grad()));
+        EXPECT_NEAR(det.grad()[i], determinant(lane).grad(), 1e-5f);
+    }
+
+    FloatGrad<float4x4, 2> M(test_matrix4(0.6f), FloatTangents<float4x4, 2>{{test_matrix4(1.0f), identity4}});
+    FloatGrad<float4, 2> p = transform_point(M, make_float3(1.0f, 2.0f, 3.0f));
+    EXPECT_TRUE(::float_eq(p.grad()[1], make_float4(1.0f, 2.0f, 3.0f, 1.0f)));
+}
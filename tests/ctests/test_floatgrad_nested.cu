@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "test_utils.h"
+
+// Forward-over-forward duals. Seeding the inner tangent with v and the outer
+// tangent with u gives f(x).grad().grad() == u^T H v.
+
+using Dual = FloatGrad<float>;
+using HyperDual = FloatGrad<FloatGrad<float>>;
+
+HyperDual seed(float x, float v, float u) {
+    return HyperDual(Dual(x, v), Dual(u, 0.0f));
+}
+
+// f(x, y) = x^2 y + exp(x y)
+template <typename T>
+T f(const T& x, const T& y) {
+    return x * x * y + expf(x * y);
+}
+
+TEST(FloatGradNested, Traits) {
+    static_assert(float_grad_depth<float>::value == 0);
+    static_assert(float_grad_depth<Dual>::value == 1);
+    static_assert(float_grad_depth<HyperDual>::value == 2);
+    static_assert(float_grad_depth<FloatGradRef<Dual>>::value == 2);
+    static_assert(std::is_same_v<float_grad_scalar_t<HyperDual>, float>);
+    static_assert(std::is_same_v<float_grad_primal_t<HyperDual>, Dual>);
+    static_assert(is_float_type<HyperDual>::value);
+    static_assert(std::is_same_v<float_grad_result_t<float2, HyperDual, float>,
+                                 FloatGrad<FloatGrad<float2>>>);
+    static_assert(std::is_same_v<float_grad_result_t<float, Dual, HyperDual>, HyperDual>);
+    static_assert(std::is_trivially_copyable_v<HyperDual>);
+    static_assert(sizeof(HyperDual) == 4 * sizeof(float));
+
+    HyperDual x = seed(2.0f, 1.0f, 3.0f);
+    EXPECT_TRUE(float_eq(get_data(get_data(x)), 2.0f));
+    EXPECT_TRUE(float_eq(get_grad(get_data(x)), 1.0f));
+    EXPECT_TRUE(float_eq(get_data(get_grad(x)), 3.0f));
+    EXPECT_TRUE(float_eq(get_grad(get_grad(x)), 0.0f));
+}
+
+TEST(FloatGradNested, HessianVectorProduct) {
+    const float x0 = 0.7f, y0 = -0.4f;
+    const float vx = 1.0f, vy = 0.5f;
+    const float ux = 0.3f, uy = -1.0f;
+
+    HyperDual r = f(seed(x0, vx, ux), seed(y0, vy, uy));
+
+    const float e = expf(x0 * y0);
+    const float fx = 2.0f * x0 * y0 + y0 * e;
+    const float fy = x0 * x0 + x0 * e;
+    const float fxx = 2.0f * y0 + y0 * y0 * e;
+    const float fxy = 2.0f * x0 + e + x0 * y0 * e;
+    const float fyy = x0 * x0 * e;
+
+    EXPECT_NEAR(r.data().data(), f(x0, y0), 1e-5f);
+    EXPECT_NEAR(r.data().grad(), fx * vx + fy * vy, 1e-5f);
+    EXPECT_NEAR(r.grad().data(), fx * ux + fy * uy, 1e-5f);
+    EXPECT_NEAR(r.grad().grad(),
+                ux * (fxx * vx + fxy * vy) + uy * (fxy * vx + fyy * vy), 1e-5f);
+}
+
+TEST(FloatGradNested, PassiveInnerDual) {
+    // A single-level dual is a constant w.r.t. the outer tangent but keeps
+    // contributing its inner tangent
+    HyperDual x = seed(1.5f, 1.0f, 2.0f);
+    Dual c(2.0f, 5.0f);
+
+    HyperDual r = x * c;
+    EXPECT_TRUE(float_eq(r.data(), Dual(3.0f, 2.0f + 1.5f * 5.0f)));
+    EXPECT_TRUE(float_eq(r.data().grad(), 2.0f + 1.5f * 5.0f));
+    EXPECT_TRUE(float_eq(r.grad().data(), 4.0f));
+    EXPECT_TRUE(float_eq(r.grad().grad(), 10.0f));
+
+    r = c - x / c;
+    EXPECT_TRUE(float_eq(r.grad().data(), -1.0f));
+
+    r = c;
+    EXPECT_TRUE(float_eq(r.data().grad(), 5.0f));
+    EXPECT_TRUE(float_eq(r.grad().data(), 0.0f));
+    EXPECT_TRUE(float_eq(r.grad().grad(), 0.0f));
+}
+
+TEST(FloatGradNested, FloatFunctions) {
+    const float x0 = 1.3f;
+    HyperDual x = seed(x0, 1.0f, 1.0f);
+
+    // Second derivatives from the mixed tangent
+    EXPECT_NEAR(sqrtf(x).grad().grad(), -0.25f * powf(x0, -1.5f), 1e-5f);
+    EXPECT_NEAR(expf(x).grad().grad(), expf(x0), 1e-5f);
+    EXPECT_NEAR((1.0f / x).grad().grad(), 2.0f / (x0 * x0 * x0), 1e-5f);
+    EXPECT_NEAR(rsqrtf(x).grad().grad(), 0.75f * powf(x0, -2.5f), 1e-5f);
+    EXPECT_NEAR(logf(x).grad().grad(), -1.0f / (x0 * x0), 1e-5f);
+    EXPECT_NEAR(sinf(x).grad().grad(), -sinf(x0), 1e-5f);
+    EXPECT_NEAR(cosf(x).grad().grad(), -cosf(x0), 1e-5f);
+    const float t = tanhf(x0);
+    EXPECT_NEAR(tanhf(x).grad().grad(), -2.0f * t * (1.0f - t * t), 1e-5f);
+    EXPECT_NEAR(powf(x, 3.0f).grad().grad(), 6.0f * x0, 1e-4f);
+    EXPECT_NEAR(erff(x).grad().grad(), -2.0f * x0 * 1.12837917f * expf(-x0 * x0), 1e-5f);
+    EXPECT_NEAR(fabs(-x).grad().grad(), 0.0f, 1e-6f);
+    EXPECT_NEAR((-x).grad().data(), -1.0f, 1e-6f);
+
+    HyperDual y = seed(0.5f, 0.0f, 0.0f);
+    EXPECT_NEAR(fminf(x, y).data().data(), 0.5f, 1e-6f);
+    EXPECT_NEAR(fmaxf(x * x, y).grad().grad(), 2.0f, 1e-5f);
+    EXPECT_NEAR(lerp(y, x * x, 0.5f).grad().grad(), 1.0f, 1e-5f);
+    EXPECT_NEAR(clamp(x * x, 0.0f, 10.0f).grad().grad(), 2.0f, 1e-5f);
+    EXPECT_NEAR(floorf(x).grad().grad(), 0.0f, 1e-6f);
+}
+
+TEST(FloatGradNested, CompoundAndFmaAssign) {
+    HyperDual x = seed(1.5f, 1.0f, 2.0f);
+    HyperDual y = seed(-0.5f, 0.5f, 1.0f);
+
+    HyperDual acc = x;
+    HyperDual expected = x;
+    acc *= y;
+    expected = expected * y;
+    fma_assign(acc, x, x);
+    expected = expected + x * x;
+    acc /= y;
+    expected = expected / y;
+    acc += Dual(2.0f, 1.0f);
+    expected = expected + Dual(2.0f, 1.0f);
+
+    EXPECT_NEAR(acc.data().data(), expected.data().data(), 1e-5f);
+    EXPECT_NEAR(acc.data().grad(), expected.data().grad(), 1e-5f);
+    EXPECT_NEAR(acc.grad().data(), expected.grad().data(), 1e-5f);
+    EXPECT_NEAR(acc.grad().grad(), expected.grad().grad(), 1e-5f);
+}
+
+TEST(FloatGradNested, VectorLength) {
+    // The Hessian of |p| is (I - p p^T / |p|^2) / |p|
+    const float p[3] = {1.0f, 2.0f, -2.0f};
+    const float v[3] = {0.5f, -1.0f, 2.0f};
+    const float u[3] = {1.0f, 0.0f, 1.0f};
+
+    auto q = make_float3(seed(p[0], v[0], u[0]), seed(p[1], v[1], u[1]),
+                         seed(p[2], v[2], u[2]));
+    static_assert(std::is_same_v<decltype(q), FloatGrad<FloatGrad<float3>>>);
+
+    HyperDual len = length(q);
+
+    const float n = 3.0f;
+    float pv = 0.0f, pu = 0.0f, uv = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        pv += p[i] * v[i];
+        pu += p[i] * u[i];
+        uv += u[i] * v[i];
+    }
+    EXPECT_NEAR(len.data().data(), n, 1e-5f);
+    EXPECT_NEAR(len.data().grad(), pv / n, 1e-5f);
+    EXPECT_NEAR(len.grad().data(), pu / n, 1e-5f);
+    EXPECT_NEAR(len.grad().grad(), (uv - pu * pv / (n * n)) / n, 1e-5f);
+
+    EXPECT_NEAR(get_y(q).data().data(), p[1], 1e-6f);
+    EXPECT_NEAR(get_z(q).grad().data(), u[2], 1e-6f);
+}
+
+TEST(FloatGradNested, MultiLaneHessianVectorProduct) {
+    // Two outer lanes seeded with the unit vectors give the full H v in one pass
+    using HyperDual2 = FloatGrad<FloatGrad<float>, 2>;
+    const float x0 = 0.7f, y0 = -0.4f;
+    const float vx = 1.0f, vy = 0.5f;
+
+    FloatTangents<Dual, 2> ex, ey;
+    ex[0] = Dual(1.0f, 0.0f);
+    ex[1] = Dual(0.0f, 0.0f);
+    ey[0] = Dual(0.0f, 0.0f);
+    ey[1] = Dual(1.0f, 0.0f);
+    HyperDual2 x(Dual(x0, vx), ex);
+    HyperDual2 y(Dual(y0, vy), ey);
+
+    HyperDual2 r = f(x, y);
+
+    const float e = expf(x0 * y0);
+    const float fxx = 2.0f * y0 + y0 * y0 * e;
+    const float fxy = 2.0f * x0 + e + x0 * y0 * e;
+    const float fyy = x0 * x0 * e;
+
+    EXPECT_NEAR(r.grad()[0].grad(), fxx * vx + fxy * vy, 1e-5f);
+    EXPECT_NEAR(r.grad()[1].grad(), fxy * vx + fyy * vy, 1e-5f);
+}
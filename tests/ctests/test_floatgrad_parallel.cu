@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "float_grad.h"
+#include "float_grad_batch.h"
+#include "float_grad_parallel.h"
+#include "test_utils.h"
+
+TEST(FloatGradParallel, RunCallsEveryThread) {
+    for (int threads : {1, 2, 5}) {
+        ThreadPool pool(threads);
+        EXPECT_EQ(pool.size(), threads);
+        for (int rep = 0; rep < 3; ++rep) {
+            std::vector<int> calls(threads, 0);
+            pool.run([&](int tid) { ++calls[tid]; });
+            for (int c : calls) EXPECT_EQ(c, 1);
+        }
+    }
+}
+
+TEST(FloatGradParallel, NestedRunIsSerial) {
+    ThreadPool pool(3);
+    std::atomic<int> calls(0);
+    pool.run([&](int) {
+        pool.run([&](int) { ++calls; });
+    });
+    EXPECT_EQ(calls.load(), 9);
+}
+
+TEST(FloatGradParallel, PinnedPool) {
+    ThreadPool pool(ThreadPool::hardware_threads() + 1, true);
+    std::atomic<int> calls(0);
+    pool.run([&](int) { ++calls; });
+    EXPECT_EQ(calls.load(), pool.size());
+}
+
+TEST(FloatGradParallel, ForCoversRange) {
+    ThreadPool pool(4);
+    for (int64_t n : {0, 1, 15, 16, 17, 1000}) {
+        for (int64_t grain : {1, 16, 64}) {
+            std::vector<int> hits(n, 0);
+            parallel_for(pool, n, grain, [&](int64_t begin, int64_t end) {
+                EXPECT_EQ(begin % grain, 0);
+                for (int64_t i = begin; i < end; ++i) ++hits[i];
+            });
+            for (int h : hits) EXPECT_EQ(h, 1);
+        }
+    }
+}
+
+// The thread that gets leaf 0 holds it until every other leaf has run,
+// which only finishes if the rest of its share is stolen
+TEST(FloatGradParallel, StalledLeafIsStolenFrom) {
+    ThreadPool pool(4);
+    const int64_t n = 4096, grain = 16;
+    std::vector<int> hits(n, 0);
+    std::atomic<int64_t> done(0);
+    bool finished = true;
+    parallel_for(pool, n, grain, [&](int64_t begin, int64_t end) {
+        if (begin == 0) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (done.load() < n - (end - begin)) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    finished = false;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+        for (int64_t i = begin; i < end; ++i) ++hits[i];
+        done += end - begin;
+    });
+    EXPECT_TRUE(finished);
+    for (int h : hits) EXPECT_EQ(h, 1);
+}
+
+TEST(FloatGradParallel, NestedFor) {
+    ThreadPool pool(3);
+    const int64_t n = 300;
+    std::vector<std::atomic<int>> hits(n * n);
+    parallel_for(pool, n, 7, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            parallel_for(pool, n, 5, [&](int64_t b, int64_t e) {
+                for (int64_t j = b; j < e; ++j) ++hits[i * n + j];
+            });
+        }
+    });
+    for (const auto& h : hits) EXPECT_EQ(h.load(), 1);
+}
+
+TEST(FloatGradParallel, ReduceInChunkOrder) {
+    ThreadPool pool(4);
+    const int64_t n = 1001;
+    auto sum = [](int64_t begin, int64_t end) {
+        int64_t s = 0;
+        for (int64_t i = begin; i < end; ++i) s += i;
+        return s;
+    };
+    auto plus = [](int64_t a, int64_t b) { return a + b; };
+    EXPECT_EQ(parallel_reduce(pool, n, 16, int64_t(5), sum, plus), 5 + n * (n - 1) / 2);
+    EXPECT_EQ(parallel_reduce(pool, 0, 16, int64_t(5), sum, plus), 5);
+
+    // Chunks are combined left to right, which a non-commutative combine shows
+    std::vector<int64_t> order = parallel_reduce(
+        pool, 64, 16, std::vector<int64_t>(),
+        [](int64_t begin, int64_t) { return std::vector<int64_t>{begin}; },
+        [](std::vector<int64_t> a, const std::vector<int64_t>& b) {
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        });
+    EXPECT_EQ(order, (std::vector<int64_t>{0, 16, 32, 48}));
+
+    // Float sums come out bit for bit the same whichever thread runs which
+    // leaf, here with leaf times varying between runs
+    std::vector<float> x(10007);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 1.0f / (1.0f + i % 97);
+    auto run = [&](int rep) {
+        return parallel_reduce(
+            pool, static_cast<int64_t>(x.size()), 64, 0.0f,
+            [&](int64_t begin, int64_t end) {
+                if ((begin / 64 + rep) % 5 == 0) std::this_thread::yield();
+                float s = 0.0f;
+                for (int64_t i = begin; i < end; ++i) s += x[i];
+                return s;
+            },
+            [](float a, float b) { return a + b; });
+    };
+    const float first = run(0);
+    for (int rep = 1; rep < 8; ++rep) EXPECT_EQ(run(rep), first);
+}
+
+TEST(FloatGradParallel, BatchKernels) {
+    const int64_t n = 5003;
+    std::vector<float> ad(n), ag(n), bd(n), bg(n), od(n), og(n);
+    for (int64_t i = 0; i < n; ++i) {
+        ad[i] = 0.5f + 0.01f * (i % 37);
+        ag[i] = 0.1f * (i % 7) - 0.3f;
+        bd[i] = 1.5f - 0.02f * (i % 29);
+        bg[i] = 0.05f * (i % 11);
+    }
+    FloatGradArray<float> a(ad.data(), ag.data()), b(bd.data(), bg.data()), out(od.data(), og.data());
+
+    ThreadPool pool(3);
+    parallel_for(pool, n, 64, [&](int64_t begin, int64_t end) {
+        batch_mul(out + begin, a + begin, b + begin, end - begin);
+    });
+    for (int64_t i = 0; i < n; ++i) EXPECT_TRUE(float_eq(out[i], a[i] * b[i], 1e-5f));
+
+    const FloatGrad<float> dot = parallel_reduce(
+        pool, n, 64, FloatGrad<float>(0.0f, 0.0f),
+        [&](int64_t begin, int64_t end) { return batch_dot(a + begin, b + begin, end - begin); },
+        [](const FloatGrad<float>& x, const FloatGrad<float>& y) { return x + y; });
+    const FloatGrad<float> serial = batch_dot(a, b, n);
+    EXPECT_NEAR(dot.data(), serial.data(), 1e-5f * n);
+    EXPECT_NEAR(dot.grad(), serial.grad(), 1e-5f * n);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "test_utils.h"
+
+// FloatGrad<T, 0> values are passive: their tangent is a ZeroTangent, and
+// every term it would contribute is dropped at compile time
+
+using Passive = FloatGrad<float, 0>;
+
+TEST(FloatGradPassive, Types) {
+    static_assert(std::is_same_v<Passive::GradType, ZeroTangent>);
+    static_assert(std::is_same_v<decltype(get_grad(1.0f)), ZeroTangent>);
+    static_assert(std::is_same_v<decltype(get_grad(make_float3(1.0f, 2.0f, 3.0f))), ZeroTangent>);
+
+    Passive c(2.0f);
+    FloatGrad<float> x(3.0f, 1.0f);
+    static_assert(std::is_same_v<decltype(c * c + 1.0f), Passive>);
+    static_assert(std::is_same_v<decltype(sqrtf(c) / c), Passive>);
+    static_assert(std::is_same_v<decltype(c * x), FloatGrad<float>>);
+    static_assert(std::is_same_v<decltype(x / c), FloatGrad<float>>);
+    static_assert(std::is_same_v<decltype(c - FloatGrad<float, 4>()), FloatGrad<float, 4>>);
+    static_assert(std::is_same_v<decltype(make_float3(x, c, c)), FloatGrad<float3>>);
+    static_assert(std::is_same_v<decltype(make_float3(c, c, 1.0f)), FloatGrad<float3, 0>>);
+}
+
+TEST(FloatGradPassive, ScalarOperators) {
+    Passive c(2.0f);
+    FloatGrad<float> x(3.0f, 1.5f);
+
+    EXPECT_TRUE(float_eq(c * x, FloatGrad<float>(6.0f, 3.0f)));
+    EXPECT_TRUE(float_eq(x - c, FloatGrad<float>(1.0f, 1.5f)));
+    EXPECT_TRUE(float_eq(c - x, FloatGrad<float>(-1.0f, -1.5f)));
+    EXPECT_TRUE(float_eq(c / x, FloatGrad<float>(2.0f / 3.0f, -2.0f * 1.5f / 9.0f)));
+    EXPECT_TRUE(float_eq(expf(x * c), FloatGrad<float>(expf(6.0f), 3.0f * expf(6.0f))));
+    EXPECT_FLOAT_EQ(sqrtf(c * c).data(), 2.0f);
+
+    // Storing a passive value in an active dual zeroes its tangent
+    FloatGrad<float> y = c;
+    EXPECT_TRUE(float_eq(y, FloatGrad<float>(2.0f, 0.0f)));
+
+    x += c;
+    x *= c;
+    EXPECT_TRUE(float_eq(x, FloatGrad<float>(10.0f, 3.0f)));
+    fma_assign(x, c, c);
+    EXPECT_TRUE(float_eq(x, FloatGrad<float>(14.0f, 3.0f)));
+    c *= 3.0f;
+    EXPECT_FLOAT_EQ(c.data(), 6.0f);
+}
+
+TEST(FloatGradPassive, ConstantMatrixTimesActivePoint) {
+    // Constant rows of a camera matrix and an active homogeneous point
+    const float m[4][4] = {{1.0f, 0.5f, 0.0f, 2.0f},
+                           {0.0f, 2.0f, -1.0f, 0.5f},
+                           {0.25f, 0.0f, 1.5f, -1.0f},
+                           {0.0f, 0.0f, 0.0f, 1.0f}};
+    FloatGrad<float4> p(make_float4(1.0f, -2.0f, 0.5f, 1.0f),
+                        make_float4(0.1f, 0.2f, -0.3f, 0.0f));
+
+    for (int row = 0; row < 4; row++) {
+        FloatGrad<float4, 0> r(make_float4(m[row][0], m[row][1], m[row][2], m[row][3]));
+        float4 r_plain = make_float4(m[row][0], m[row][1], m[row][2], m[row][3]);
+
+        auto y = dot(r, p);
+        static_assert(std::is_same_v<decltype(y), FloatGrad<float>>);
+        EXPECT_TRUE(float_eq(y, dot(r_plain, p)));
+    }
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "float_grad.h"
+#include "helper_math.h"
+#include "test_utils.h"
+
+// Multi-tangent results must match N separate single-tangent passes
+
+template <int N>
+FloatTangents<float, N> lanes(const float (&v)[N]) {
+    FloatTangents<float, N> t;
+    for (int i = 0; i < N; ++i) {
+        t[i] = v[i];
+    }
+    return t;
+}
+
+TEST(FloatGradTangents, Layout) {
+    static_assert(sizeof(FloatGrad<float, 8>) == 9 * sizeof(float));
+    static_assert(sizeof(FloatGrad<float4, 4>) == 5 * sizeof(float4));
+    static_assert(std::is_trivially_copyable_v<FloatGrad<float, 8>>);
+    static_assert(std::is_trivially_copyable_v<FloatGradRef<float, 8>>);
+    static_assert(std::is_same_v<decltype(FloatGrad<float, 4>() * 2.0f), FloatGrad<float, 4>>);
+}
+
+TEST(FloatGradTangents, ScalarOperators) {
+    const float a_grad[4] = {1.0f, 0.0f, 0.5f, -2.0f};
+    const float b_grad[4] = {0.0f, 1.0f, 0.25f, 3.0f};
+    FloatGrad<float, 4> a(3.0f, lanes(a_grad));
+    FloatGrad<float, 4> b(4.0f, lanes(b_grad));
+
+    auto c = (a * b + a) / (b - 1.0f);
+    auto d = sqrtf(a * a + b * b) + expf(a - b);
+
+    static_assert(std::is_same_v<decltype(c), FloatGrad<float, 4>>);
+
+    for (int i = 0; i < 4; ++i) {
+        FloatGrad<float> ai(3.0f, a_grad[i]);
+        FloatGrad<float> bi(4.0f, b_grad[i]);
+
+        FloatGrad<float> ci = (ai * bi + ai) / (bi - 1.0f);
+        FloatGrad<float> di = sqrtf(ai * ai + bi * bi) + expf(ai - bi);
+
+        EXPECT_FLOAT_EQ(c.data(), ci.data());
+        EXPECT_FLOAT_EQ(c.grad()[i], ci.grad());
+        EXPECT_FLOAT_EQ(d.data(), di.data());
+        EXPECT_FLOAT_EQ(d.grad()[i], di.grad());
+    }
+}
+
+TEST(FloatGradTangents, RefAndCompound) {
+    float a_data = 2.0f;
+    FloatTangents<float, 2> a_grad = {{1.0f, 2.0f}};
+    FloatGradRef<float, 2> a(&a_data, &a_grad);
+
+    FloatGrad<float, 2> b(3.0f, FloatTangents<float, 2>{{0.5f, 0.0f}});
+
+    a *= b;
+    EXPECT_FLOAT_EQ(a_data, 6.0f);
+    EXPECT_TRUE(float_eq(a_grad, FloatTangents<float, 2>{{4.0f, 6.0f}}));
+
+    // Passive values have zero tangents in every lane
+    a = 1.0f;
+    EXPECT_FLOAT_EQ(a_data, 1.0f);
+    EXPECT_TRUE(float_eq(a_grad, FloatTangents<float, 2>{{0.0f, 0.0f}}));
+}
+
+TEST(FloatGradTangents, FmaAssign) {
+    FloatGrad<float, 2> acc(1.0f, FloatTangents<float, 2>{{0.0f, 1.0f}});
+    FloatGrad<float, 2> a(2.0f, FloatTangents<float, 2>{{1.0f, 0.0f}});
+    FloatGrad<float, 2> b(3.0f, FloatTangents<float, 2>{{0.0f, 1.0f}});
+
+    FloatGrad<float, 2> expected = acc + a * b;
+    fma_assign(acc, a, b);
+    EXPECT_TRUE(float_eq(acc, expected));
+
+    acc -= a;
+    acc /= b;
+    expected = (expected - a) / b;
+    EXPECT_NEAR(acc.data(), expected.data(), 1e-6f);
+    EXPECT_NEAR(acc.grad()[0], expected.grad()[0], 1e-6f);
+    EXPECT_NEAR(acc.grad()[1], expected.grad()[1], 1e-6f);
+}
+
+TEST(FloatGradTangents, VectorOperators) {
+    const float x_grad[3] = {1.0f, 0.0f, 0.0f};
+    const float y_grad[3] = {0.0f, 1.0f, 0.0f};
+    const float z_grad[3] = {0.0f, 0.0f, 1.0f};
+    FloatGrad<float, 3> x(1.0f, lanes(x_grad));
+    FloatGrad<float, 3> y(2.0f, lanes(y_grad));
+    FloatGrad<float, 3> z(3.0f, lanes(z_grad));
+
+    FloatGrad<float3, 3> p = make_float3(x, y, z);
+    float3 q = make_float3(0.5f, -1.0f, 2.0f);
+
+    // Jacobian of each function w.r.t. (x, y, z) in one pass
+    auto d = dot(p, q);
+    auto l = length(p);
+    auto c = cross(p, q);
+
+    EXPECT_FLOAT_EQ(d.data(), 4.5f);
+    EXPECT_TRUE(float_eq(d.grad(), lanes<3>({0.5f, -1.0f, 2.0f})));
+
+    float len = sqrtf(14.0f);
+    EXPECT_FLOAT_EQ(l.data(), len);
+    EXPECT_TRUE(float_eq(l.grad(), lanes<3>({1.0f / len, 2.0f / len, 3.0f / len})));
+
+    // d(p x q)/dx = e_x x q
+    EXPECT_TRUE(float_eq(c.data(), cross(make_float3(1.0f, 2.0f, 3.0f), q)));
+    EXPECT_TRUE(float_eq(c.grad()[0], cross(make_float3(1.0f, 0.0f, 0.0f), q)));
+    EXPECT_TRUE(float_eq(c.grad()[1], cross(make_float3(0.0f, 1.0f, 0.0f), q)));
+    EXPECT_TRUE(float_eq(c.grad()[2], cross(make_float3(0.0f, 0.0f, 1.0f), q)));
+
+    EXPECT_TRUE(float_eq(p.y().grad(), lanes(y_grad)));
+    EXPECT_TRUE(float_eq(get_z(p).grad(), lanes(z_grad)));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+
+#include "float_grad.h"
+#include "test_utils.h"
+
+TEST(FloatGradTensor, RowMajorPlanes) {
+    float data[6] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    float grad[6] = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+
+    FloatGradTensor<float, 2> m(data, grad, {2, 3});
+    EXPECT_EQ(m.size(0), 2);
+    EXPECT_EQ(m.size(1), 3);
+    EXPECT_EQ(m.numel(), 6);
+    EXPECT_TRUE(m.is_contiguous());
+
+    EXPECT_FLOAT_EQ(m(1, 2).data(), 6.0f);
+    EXPECT_FLOAT_EQ(m(1, 2).grad(), 0.6f);
+    EXPECT_FLOAT_EQ(m.data(0, 1), 2.0f);
+    EXPECT_FLOAT_EQ(m.grad(1, 0), 0.4f);
+
+    m(0, 0) = m(0, 1) * m(1, 1);
+    EXPECT_FLOAT_EQ(data[0], 10.0f);
+    EXPECT_FLOAT_EQ(grad[0], 0.2f * 5.0f + 2.0f * 0.5f);
+
+    // Same view over a FloatGradArray
+    FloatGradTensor<const float, 2> c(FloatGradTensor<float, 2>(FloatGradArray<float>(data, grad), {3, 2}));
+    EXPECT_TRUE(float_eq(c(2, 1), FloatGradArray<float>(data, grad)[5]));
+}
+
+TEST(FloatGradTensor, TransposeAndSlices) {
+    float data[12], grad[12];
+    for (int i = 0; i < 12; i++) {
+        data[i] = 1.0f * i;
+        grad[i] = -0.5f * i;
+    }
+
+    FloatGradTensor<float, 2> m(data, grad, {3, 4});
+    FloatGradTensor<float, 2> t = m.transpose(0, 1);
+    EXPECT_EQ(t.size(0), 4);
+    EXPECT_EQ(t.size(1), 3);
+    EXPECT_FALSE(t.is_contiguous());
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            EXPECT_TRUE(float_eq(t(j, i), m(i, j)));
+        }
+    }
+
+    FloatGradTensor<float, 1> row = m.select(0, 2);
+    EXPECT_EQ(row.size(0), 4);
+    EXPECT_TRUE(float_eq(row(3), m(2, 3)));
+    FloatGradTensor<float, 1> col = m.select(1, 1);
+    EXPECT_EQ(col.size(0), 3);
+    EXPECT_EQ(col.data_stride(0), 4);
+    EXPECT_TRUE(float_eq(col(2), m(2, 1)));
+
+    FloatGradTensor<float, 2> block = m.narrow(1, 1, 2).narrow(0, 1, 2);
+    EXPECT_EQ(block.numel(), 4);
+    EXPECT_TRUE(float_eq(block(1, 1), m(2, 2)));
+}
+
+TEST(FloatGradTensor, InterleavedAndIndependentStrides) {
+    // (primal, tangent) pairs of a [2, 3] matrix, as in a torch JVP tensor
+    float pairs[12];
+    for (int i = 0; i < 12; i++) {
+        pairs[i] = 0.25f * i;
+    }
+    FloatGradTensor<float, 2> m(FloatGradInterleavedArray<float>(pairs), {2, 3});
+    EXPECT_EQ(m.data_stride(1), 2);
+    EXPECT_EQ(m.data_stride(0), 6);
+    EXPECT_FLOAT_EQ(m(1, 2).data(), pairs[10]);
+    EXPECT_FLOAT_EQ(m(1, 2).grad(), pairs[11]);
+
+    // Row-major primals with a column-major tangent plane
+    float data[6] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    float grad[6] = {0.1f, 0.4f, 0.2f, 0.5f, 0.3f, 0.6f};
+    FloatGradTensor<float, 2> p(data, grad, {2, 3}, {3, 1}, {1, 2});
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_FLOAT_EQ(p(i, j).grad(), 0.1f * p(i, j).data());
+        }
+    }
+
+    // A primal-only view
+    FloatGradTensor<const float, 2> passive(data, nullptr, {3, 2});
+    EXPECT_FALSE(passive.has_grad());
+    EXPECT_FLOAT_EQ(passive.data(2, 0), 5.0f);
+    EXPECT_FALSE(passive.narrow(0, 1, 1).has_grad());
+}
+
+TEST(FloatGradTensor, WideOffsets) {
+    // Offsets past 2^31 are computed in 64 bits; nothing is dereferenced
+    FloatGradTensor<const float, 2> m(nullptr, nullptr, {int64_t(1) << 20, int64_t(1) << 12});
+    EXPECT_EQ(m.numel(), int64_t(1) << 32);
+    EXPECT_EQ(m.data_offset((1 << 20) - 1, 4095), (int64_t(1) << 32) - 1);
+    EXPECT_EQ(m.transpose(0, 1).grad_offset(4095, (1 << 20) - 1), (int64_t(1) << 32) - 1);
+}
+
+TEST(FloatGradTensor, TangentLanes) {
+    // A contiguous [2, 3, 1 + 3] buffer: every primal followed by 3 tangents
+    const int64_t lanes = 3, step = 1 + lanes;
+    float buf[2 * 3 * step];
+    for (int i = 0; i < 2 * 3 * step; i++) {
+        buf[i] = 0.5f * i;
+    }
+    FloatGradTensor<float, 2, 3> m(buf, buf + 1, {2, 3}, {3 * step, step}, {3 * step, step});
+    EXPECT_FLOAT_EQ(m.data(1, 2), buf[5 * step]);
+    for (int k = 0; k < lanes; k++) {
+        EXPECT_FLOAT_EQ(m.grad(1, 2)[k], buf[5 * step + 1 + k]);
+        EXPECT_FLOAT_EQ(m(0, 1).grad()[k], buf[step + 1 + k]);
+    }
+
+    // Writes through a ref update every lane
+    m(0, 0) = m(0, 1) * m(1, 1);
+    for (int k = 0; k < lanes; k++) {
+        const float a = 0.5f * step, b = 0.5f * 4 * step;
+        const float da = 0.5f * (step + 1 + k), db = 0.5f * (4 * step + 1 + k);
+        EXPECT_FLOAT_EQ(buf[1 + k], da * b + a * db);
+    }
+    EXPECT_FLOAT_EQ(buf[0], 0.5f * step * 0.5f * 4 * step);
+
+    // Transposes, slices and read-only views keep the lanes
+    FloatGradTensor<const float, 1, 3> col = FloatGradTensor<const float, 2, 3>(m).transpose(0, 1).select(0, 2);
+    EXPECT_EQ(col.size(0), 2);
+    EXPECT_FLOAT_EQ(col.grad(1)[2], buf[5 * step + 3]);
+}
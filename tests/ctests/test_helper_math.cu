@@ -66,7 +66,7 @@ TEST(FloatGradHelperMathTest, MakeFloat2) {
 
     FloatGrad<float3> a(a_data, a_grad);
 
-    FloatGrad<float2> b = make_float2(a.z);
+    FloatGrad<float2> b = make_float2(a.z());
 
     EXPECT_TRUE(float_eq(b, FloatGrad<float2>(make_float2(3.0f, 3.0f), 
                                               make_float2(0.3f, 0.3f))));
@@ -126,7 +126,7 @@ TEST(FloatGradHelperMathTest, ArithmeticOperators) {
                                               make_float4(0.1f, 0.2f, 0.3f, 0.4f))));
 
     FloatGrad<float3> d = make_float3(c);
-    FloatGrad<float3> e = make_float3(a.w);
+    FloatGrad<float3> e = make_float3(a.w());
 
     d += e;
 
@@ -198,7 +198,7 @@ TEST(FloatGradHelperMathTest, LerpFunctions) {
     FloatGrad<float4> a(a_data, a_grad);
     FloatGrad<float4> b(b_data, b_grad);
 
-    EXPECT_TRUE(float_eq(lerp(a.x, 3.0f, 0.5f), 
+    EXPECT_TRUE(float_eq(lerp(a.x(), 3.0f, 0.5f), 
                          FloatGrad<float>(2.0f, 0.05f)));
 
     FloatGrad<float> t(0.1f, 1.0f);
@@ -335,9 +335,9 @@ TEST(FloatGradHelperMathTest, ReflectAutodiff) {
     float3 c_data_ref = reflect(a_data, b_data);
     FloatGrad<float3> c = reflect(a, b);
 
-    EXPECT_FLOAT_EQ(c_data_ref.x, c.x.data());
-    EXPECT_FLOAT_EQ(c_data_ref.y, c.y.data());
-    EXPECT_FLOAT_EQ(c_data_ref.z, c.z.data());
+    EXPECT_FLOAT_EQ(c_data_ref.x, c.x().data());
+    EXPECT_FLOAT_EQ(c_data_ref.y, c.y().data());
+    EXPECT_FLOAT_EQ(c_data_ref.z, c.z().data());
 
     float* x_ptr[6] = {&a_data.x, &a_data.y, &a_data.z, 
                        &b_data.x, &b_data.y, &b_data.z};
@@ -377,9 +377,9 @@ TEST(FloatGradHelperMathTest, CrossAutodiff) {
     float3 c_data_ref = cross(a_data, b_data);
     FloatGrad<float3> c = cross(a, b);
 
-    EXPECT_FLOAT_EQ(c_data_ref.x, c.x.data());
-    EXPECT_FLOAT_EQ(c_data_ref.y, c.y.data());
-    EXPECT_FLOAT_EQ(c_data_ref.z, c.z.data());
+    EXPECT_FLOAT_EQ(c_data_ref.x, c.x().data());
+    EXPECT_FLOAT_EQ(c_data_ref.y, c.y().data());
+    EXPECT_FLOAT_EQ(c_data_ref.z, c.z().data());
 
     float* x_ptr[6] = {&a_data.x, &a_data.y, &a_data.z, 
                        &b_data.x, &b_data.y, &b_data.z};
@@ -422,9 +422,9 @@ TEST(FloatGradHelperMathTest, SmoothStepAutodiff) {
     float3 c_data_ref = smoothstep(a_data, b_data, d_data);
     FloatGrad<float3> c = smoothstep(a, b, d);
 
-    EXPECT_FLOAT_EQ(c_data_ref.x, c.x.data());
-    EXPECT_FLOAT_EQ(c_data_ref.y, c.y.data());
-    EXPECT_FLOAT_EQ(c_data_ref.z, c.z.data());
+    EXPECT_FLOAT_EQ(c_data_ref.x, c.x().data());
+    EXPECT_FLOAT_EQ(c_data_ref.y, c.y().data());
+    EXPECT_FLOAT_EQ(c_data_ref.z, c.z().data());
 
     float* x_ptr[9] = {&a_data.x, &a_data.y, &a_data.z, 
                        &b_data.x, &b_data.y, &b_data.z,
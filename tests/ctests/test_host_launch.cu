@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "float_grad.h"
+#include "dot_kernel.h"
+#include "host_launch.h"
+#include "matmul_kernel.h"
+#include "test_utils.h"
+
+namespace {
+
+// Records the global linear index of every thread, and how often it ran
+__global__ void index_kernel(int* hits, unsigned int* ids, int nx, int ny) {
+    const unsigned int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int y = blockIdx.y * blockDim.y + threadIdx.y;
+    const unsigned int z = blockIdx.z * blockDim.z + threadIdx.z;
+    const unsigned int i = (z * ny + y) * nx + x;
+    hits[i] += 1;
+    ids[i] = (gridDim.x * blockDim.x) * 1000 + x;
+}
+
+// out = a * x + y with a bounds check, as launched with a rounded-up grid
+__global__ void axpy_kernel(int n, FloatGrad<float> a, FloatGradArray<const float> x,
+                            FloatGradArray<const float> y, FloatGradArray<float> out) {
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= n) return;
+    out[i] = a * x[i] + y[i];
+}
+
+} // namespace
+
+TEST(HostLaunch, EveryThreadOnce) {
+    const int nx = 8 * 3, ny = 4 * 2, nz = 2 * 2;
+    std::vector<int> hits(nx * ny * nz, 0);
+    std::vector<unsigned int> ids(nx * ny * nz, 0);
+    ThreadPool pool(3);
+    host_launch<index_kernel>(pool, dim3(3, 2, 2), dim3(8, 4, 2), hits.data(), ids.data(), nx, ny);
+    for (int i = 0; i < nx * ny * nz; ++i) {
+        EXPECT_EQ(hits[i], 1) << i;
+        EXPECT_EQ(ids[i], 24000u + i % nx) << i;
+    }
+
+    // Empty grids run nothing
+    host_launch<index_kernel>(pool, dim3(0, 1, 1), dim3(8, 4, 2), hits.data(), ids.data(), nx, ny);
+    EXPECT_EQ(hits[0], 1);
+}
+
+TEST(HostLaunch, ElementwiseKernel) {
+    const int n = 1000;
+    std::vector<float> x(n), dx(n), y(n), dy(n), out(n), dout(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = 0.01f * i;
+        dx[i] = 1.0f;
+        y[i] = -0.5f * i;
+        dy[i] = 0.25f;
+    }
+    const FloatGrad<float> a(2.0f, 0.5f);
+    launch_kernel<axpy_kernel>(dim3((n + 255) / 256), dim3(256), n, a,
+                               FloatGradArray<const float>(x.data(), dx.data()),
+                               FloatGradArray<const float>(y.data(), dy.data()),
+                               FloatGradArray<float>(out.data(), dout.data()));
+    for (int i = 0; i < n; ++i) {
+        EXPECT_FLOAT_EQ(out[i], 2.0f * x[i] + y[i]);
+        EXPECT_FLOAT_EQ(dout[i], 0.5f * x[i] + 2.0f * dx[i] + dy[i]);
+    }
+}
+
+// The matmul launchers' kernel, unchanged, on a grid that does not divide
+// the matrix
+TEST(HostLaunch, MatmulKernel) {
+    const int64_t M = 37, K = 19, N = 45;
+    std::vector<float> a(M * K), da(M * K), b(K * N), db(K * N), c(M * N), dc(M * N);
+    for (int64_t i = 0; i < M * K; ++i) {
+        a[i] = ((i * 7) % 13) / 6.0f - 1.0f;
+        da[i] = ((i * 5) % 11) / 5.0f - 1.0f;
+    }
+    for (int64_t i = 0; i < K * N; ++i) {
+        b[i] = ((i * 3) % 17) / 8.0f - 1.0f;
+        db[i] = ((i * 11) % 7) / 3.0f - 1.0f;
+    }
+    FloatGradTensor<const float, 2> A(a.data(), da.data(), {M, K});
+    FloatGradTensor<const float, 2> B(b.data(), db.data(), {K, N});
+    FloatGradTensor<float, 2> C(c.data(), dc.data(), {M, N});
+
+    const dim3 block(16, 16);
+    const dim3 grid((N + 15) / 16, (M + 15) / 16);
+    ThreadPool pool(4);
+    host_launch<matmul_kernel<FloatGrad<float>, FloatGrad<float>, FloatGrad<float>>>(pool, grid, block, A, B, C);
+    for (int64_t i = 0; i < M; ++i) {
+        for (int64_t j = 0; j < N; ++j) {
+            float d = 0.0f, g = 0.0f;
+            for (int64_t k = 0; k < K; ++k) {
+                d += a[i * K + k] * b[k * N + j];
+                g += da[i * K + k] * b[k * N + j] + a[i * K + k] * db[k * N + j];
+            }
+            EXPECT_NEAR(c[i * N + j], d, 1e-4f);
+            EXPECT_NEAR(dc[i * N + j], g, 1e-4f);
+        }
+    }
+
+    // Passive B, primal-only C
+    host_launch<matmul_kernel<float, float, float>>(pool, grid, block, A, B, C.primals());
+    EXPECT_NEAR(c[0], [&] {
+        float d = 0.0f;
+        for (int64_t k = 0; k < K; ++k) {
+            d += a[k] * b[k * N];
+        }
+        return d;
+    }(), 1e-4f);
+}
+
+// matmul_kernel with 4 tangent lanes per element, viewing [rows, cols, 1 + 4]
+// buffers as the extension does, against one single-tangent product per lane
+TEST(HostLaunch, MatmulKernelTangentLanes) {
+    constexpr int L = 4;
+    const int64_t M = 13, K = 7, N = 21, step = 1 + L;
+    std::vector<float> a(M * K * step), b(K * N * step), c(M * N * step);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = ((i * 7) % 13) / 6.0f - 1.0f;
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = ((i * 3) % 17) / 8.0f - 1.0f;
+    }
+    FloatGradTensor<const float, 2, L> A(a.data(), a.data() + 1, {M, K}, {K * step, step}, {K * step, step});
+    FloatGradTensor<const float, 2, L> B(b.data(), b.data() + 1, {K, N}, {N * step, step}, {N * step, step});
+    FloatGradTensor<float, 2, L> C(c.data(), c.data() + 1, {M, N}, {N * step, step}, {N * step, step});
+
+    const dim3 block(16, 16);
+    const dim3 grid((N + 15) / 16, (M + 15) / 16);
+    using Dual = FloatGrad<float, L>;
+    launch_kernel<matmul_kernel<Dual, float, Dual, L>>(grid, block, A, B, C);
+    for (int64_t i = 0; i < M; ++i) {
+        for (int64_t j = 0; j < N; ++j) {
+            const float* out = &c[(i * N + j) * step];
+            float d = 0.0f;
+            for (int64_t k = 0; k < K; ++k) {
+                d += a[(i * K + k) * step] * b[(k * N + j) * step];
+            }
+            EXPECT_NEAR(out[0], d, 1e-4f);
+            for (int l = 0; l < L; ++l) {
+                float g = 0.0f;
+                for (int64_t k = 0; k < K; ++k) {
+                    g += a[(i * K + k) * step + 1 + l] * b[(k * N + j) * step];
+                }
+                EXPECT_NEAR(out[1 + l], g, 1e-4f) << l;
+            }
+        }
+    }
+}
+
+// float2_dot_kernel with one active and one passive input, as the dot
+// launchers dispatch it
+TEST(HostLaunch, Float2DotKernel) {
+    const int64_t n = 300;
+    std::vector<float> a(n * 2), da(n * 2), b(n * 2), c(n), dc(n);
+    for (int64_t i = 0; i < n * 2; ++i) {
+        a[i] = ((i * 7) % 13) / 6.0f - 1.0f;
+        da[i] = ((i * 5) % 11) / 5.0f - 1.0f;
+        b[i] = ((i * 3) % 17) / 8.0f - 1.0f;
+    }
+    FloatGradTensor<const float, 2> A(a.data(), da.data(), {n, 2});
+    FloatGradTensor<const float, 2> B(b.data(), nullptr, {n, 2});
+    FloatGradTensor<float, 1> C(c.data(), dc.data(), {n});
+
+    launch_kernel<float2_dot_kernel<FloatGrad<float>, float, FloatGrad<float>>>(
+        dim3((n + 255) / 256), dim3(256), A, B, C);
+    for (int64_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(c[i], a[2 * i] * b[2 * i] + a[2 * i + 1] * b[2 * i + 1], 1e-5f);
+        EXPECT_NEAR(dc[i], da[2 * i] * b[2 * i] + da[2 * i + 1] * b[2 * i + 1], 1e-5f);
+    }
+}
@@ -21,6 +21,17 @@ inline bool float_eq(float4 a, float4 b, float eps = 1e-6f) {
            float_eq(a.z, b.z, eps) && float_eq(a.w, b.w, eps);
 }
 
+template <typename T, int N>
+__host__ __device__
+inline bool float_eq(const FloatTangents<T, N>& a, const FloatTangents<T, N>& b, float eps = 1e-6f) {
+    for (int i = 0; i < N; ++i) {
+        if (!float_eq(a[i], b[i], eps)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename T1, typename T2,
           typename = std::enable_if_t<is_float_grad<T1>::value
                                       && is_float_grad<T2>::value>>
@@ -1,14 +1,16 @@
 import torch
 import torch.autograd.forward_ad as fwAD
-from auto_jvp_example import float2_dot_jvp
+from auto_jvp_example import float2_dot_jvp, with_cuda
+
+device = 'cuda' if with_cuda and torch.cuda.is_available() else 'cpu'
 
 def float2_dot_fn(a, b):
     return torch.sum(a * b, dim=1)
 
-A = torch.randn(100, 2, device='cuda', dtype=torch.float32)
-A_tangent = torch.randn(100, 2, device='cuda', dtype=torch.float32)
-B = torch.randn(100, 2, device='cuda', dtype=torch.float32)
-B_tangent = torch.randn(100, 2, device='cuda', dtype=torch.float32)
+A = torch.randn(100, 2, device=device, dtype=torch.float32)
+A_tangent = torch.randn(100, 2, device=device, dtype=torch.float32)
+B = torch.randn(100, 2, device=device, dtype=torch.float32)
+B_tangent = torch.randn(100, 2, device=device, dtype=torch.float32)
 
 with fwAD.dual_level():
     A_dual = fwAD.make_dual(A, A_tangent)
@@ -25,8 +27,8 @@ C_tangent_ref = torch.sum(A_tangent * B, dim=1) + torch.sum(A * B_tangent, dim=1
 print(f"data error = {(C - C_ref).abs().max().item()}")
 print(f"tangent error = {(C_tangent - C_tangent_ref).abs().max().item()}")
 
-A_jvp = torch.empty(100, 2, 2, device='cuda', dtype=torch.float32)
-B_jvp = torch.empty(100, 2, 2, device='cuda', dtype=torch.float32)
+A_jvp = torch.empty(100, 2, 2, device=device, dtype=torch.float32)
+B_jvp = torch.empty(100, 2, 2, device=device, dtype=torch.float32)
 A_jvp[:, :, 0] = A
 B_jvp[:, :, 0] = B
 A_jvp[:, :, 1] = A_tangent
@@ -0,0 +1,51 @@
+import torch
+import torch.autograd.forward_ad as fwAD
+from auto_jvp_example import forward_ad, with_cuda
+
+device = 'cuda' if with_cuda and torch.cuda.is_available() else 'cpu'
+
+A = torch.randn(64, 48, device=device, dtype=torch.float32)
+A_tangent = torch.randn(64, 48, device=device, dtype=torch.float32)
+B = torch.randn(48, 32, device=device, dtype=torch.float32)
+B_tangent = torch.randn(48, 32, device=device, dtype=torch.float32)
+
+with fwAD.dual_level():
+    A_dual = fwAD.make_dual(A, A_tangent)
+    B_dual = fwAD.make_dual(B, B_tangent)
+
+    C_dual = forward_ad.matmul(A_dual, B_dual)
+    C, C_tangent = fwAD.unpack_dual(C_dual)
+
+    # Only B carries a tangent
+    C_mixed, C_mixed_tangent = fwAD.unpack_dual(forward_ad.matmul(A, B_dual))
+
+    # A transposed view is read in place
+    At_dual = fwAD.make_dual(A.t().contiguous().t(), A_tangent)
+    C_strided, C_strided_tangent = fwAD.unpack_dual(forward_ad.matmul(At_dual, B_dual))
+
+print(f"matmul data error = {(C - A @ B).abs().max().item()}")
+print(f"matmul tangent error = {(C_tangent - (A_tangent @ B + A @ B_tangent)).abs().max().item()}")
+print(f"matmul mixed data error = {(C_mixed - A @ B).abs().max().item()}")
+print(f"matmul mixed tangent error = {(C_mixed_tangent - A @ B_tangent).abs().max().item()}")
+print(f"matmul strided tangent error = {(C_strided_tangent - C_tangent).abs().max().item()}")
+
+# Outside a dual level the plain kernel runs
+print(f"matmul plain error = {(forward_ad.matmul(A, B) - A @ B).abs().max().item()}")
+
+X = torch.randn(10, 100, 2, device=device, dtype=torch.float32)
+X_tangent = torch.randn(10, 100, 2, device=device, dtype=torch.float32)
+Y = torch.randn(10, 100, 2, device=device, dtype=torch.float32)
+Y_tangent = torch.randn(10, 100, 2, device=device, dtype=torch.float32)
+
+with fwAD.dual_level():
+    Z_dual = forward_ad.float2_dot(fwAD.make_dual(X, X_tangent), fwAD.make_dual(Y, Y_tangent))
+    Z, Z_tangent = fwAD.unpack_dual(Z_dual)
+
+    # Only X carries a tangent
+    Z_mixed, Z_mixed_tangent = fwAD.unpack_dual(forward_ad.float2_dot(fwAD.make_dual(X, X_tangent), Y))
+
+print(f"float2_dot data error = {(Z - (X * Y).sum(-1)).abs().max().item()}")
+print(f"float2_dot tangent error = "
+      f"{(Z_tangent - (X_tangent * Y + X * Y_tangent).sum(-1)).abs().max().item()}")
+print(f"float2_dot mixed data error = {(Z_mixed - (X * Y).sum(-1)).abs().max().item()}")
+print(f"float2_dot mixed tangent error = {(Z_mixed_tangent - (X_tangent * Y).sum(-1)).abs().max().item()}")
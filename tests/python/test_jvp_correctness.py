@@ -1,14 +1,16 @@
 import torch
 import torch.autograd.forward_ad as fwAD
-from auto_jvp_example import matmul_cuda_floatgrad
+from auto_jvp_example import matmul_jvp, with_cuda
+
+device = 'cuda' if with_cuda and torch.cuda.is_available() else 'cpu'
 
 def matmul_fn(a, b):
     return a @ b
 
-A = torch.randn(4, 5, device='cuda', dtype=torch.float32)
-A_tangent = torch.randn(4, 5, device='cuda', dtype=torch.float32)
-B = torch.randn(5, 3, device='cuda', dtype=torch.float32)
-B_tangent = torch.randn(5, 3, device='cuda', dtype=torch.float32)
+A = torch.randn(4, 5, device=device, dtype=torch.float32)
+A_tangent = torch.randn(4, 5, device=device, dtype=torch.float32)
+B = torch.randn(5, 3, device=device, dtype=torch.float32)
+B_tangent = torch.randn(5, 3, device=device, dtype=torch.float32)
 
 with fwAD.dual_level():
     A_dual = fwAD.make_dual(A, A_tangent)
@@ -25,14 +27,25 @@ C_tangent_ref = A @ B_tangent + A_tangent @ B
 print(f"data error = {(C - A @ B).abs().max().item()}")
 print(f"tangent error = {(C_tangent - C_tangent_ref).abs().max().item()}")
 
-A_floatgrad = torch.empty(4, 5, 2, device='cuda', dtype=torch.float32)
-B_floatgrad = torch.empty(5, 3, 2, device='cuda', dtype=torch.float32)
+A_floatgrad = torch.empty(4, 5, 2, device=device, dtype=torch.float32)
+B_floatgrad = torch.empty(5, 3, 2, device=device, dtype=torch.float32)
 A_floatgrad[:, :, 0] = A
 B_floatgrad[:, :, 0] = B
 A_floatgrad[:, :, 1] = A_tangent
 B_floatgrad[:, :, 1] = B_tangent
 
-C_floatgrad = matmul_cuda_floatgrad(A_floatgrad, B_floatgrad)
+C_floatgrad = matmul_jvp(A_floatgrad, B_floatgrad)
 
 print(f"Auto JVP data error = {(C_floatgrad[:, :, 0] - C).abs().max().item()}")
 print(f"Auto JVP tangent error = {(C_floatgrad[:, :, 1] - C_tangent).abs().max().item()}")
+
+# K tangents in one call, including a K without its own kernel
+for K in (4, 5):
+    A_tangents = torch.randn(4, 5, K, device=device, dtype=torch.float32)
+    B_tangents = torch.randn(5, 3, K, device=device, dtype=torch.float32)
+    C_multi = matmul_jvp(torch.cat([A.unsqueeze(-1), A_tangents], -1),
+                         torch.cat([B.unsqueeze(-1), B_tangents], -1))
+    C_tangents_ref = torch.stack([A @ B_tangents[..., k] + A_tangents[..., k] @ B for k in range(K)], -1)
+
+    print(f"Auto JVP K={K} data error = {(C_multi[:, :, 0] - C).abs().max().item()}")
+    print(f"Auto JVP K={K} tangent error = {(C_multi[:, :, 1:] - C_tangents_ref).abs().max().item()}")
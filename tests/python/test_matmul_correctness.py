@@ -1,26 +1,41 @@
 import torch
-from auto_jvp_example import matmul_cuda, matmul_cuda_jvp
+from auto_jvp_example import matmul, matmul_jvp, with_cuda
 
-A = torch.randn(4, 5, device='cuda', dtype=torch.float32)
-B = torch.randn(5, 3, device='cuda', dtype=torch.float32)
+device = 'cuda' if with_cuda and torch.cuda.is_available() else 'cpu'
 
-C = matmul_cuda(A, B)
-print("CUDA matmul:\n", C)
+A = torch.randn(4, 5, device=device, dtype=torch.float32)
+B = torch.randn(5, 3, device=device, dtype=torch.float32)
+
+C = matmul(A, B)
+print("matmul:\n", C)
 
 # Compare with PyTorch
 C_ref = A @ B
 print("PyTorch matmul:\n", C_ref)
 print("Max error:", (C - C_ref).abs().max().item())
 
-A_jvp = torch.empty(4, 5, 2, device='cuda', dtype=torch.float32)
-B_jvp = torch.empty(5, 3, 2, device='cuda', dtype=torch.float32)
+A_jvp = torch.empty(4, 5, 2, device=device, dtype=torch.float32)
+B_jvp = torch.empty(5, 3, 2, device=device, dtype=torch.float32)
 
 A_jvp[:, :, 0] = A
 B_jvp[:, :, 0] = B
 A_jvp[:, :, 1] = 0
 B_jvp[:, :, 1] = 0
 
-C_jvp = matmul_cuda_jvp(A_jvp, B_jvp)
+C_jvp = matmul_jvp(A_jvp, B_jvp)
 
-print("CUDA matmul with jvp:\n", C_jvp)
+print("matmul with jvp:\n", C_jvp)
 print("Max error with jvp:", (C_jvp[:, :, 0] - C_ref).abs().max().item())
+print("Max tangent with zero input tangents:", C_jvp[:, :, 1].abs().max().item())
+
+# Zero tangents take the primal-only path, without a tangent plane on request
+C_primal = matmul_jvp(A_jvp, B_jvp, need_tangent=False)
+print("Primal-only shape:", tuple(C_primal.shape))
+print("Max error primal-only:", (C_primal - C_ref).abs().max().item())
+
+# One active input: only its product-rule term is computed
+B_tangent = torch.randn(5, 3, device=device, dtype=torch.float32)
+B_jvp[:, :, 1] = B_tangent
+C_mixed = matmul_jvp(A, B_jvp)
+print("Max error mixed data:", (C_mixed[:, :, 0] - C_ref).abs().max().item())
+print("Max error mixed tangent:", (C_mixed[:, :, 1] - A @ B_tangent).abs().max().item())